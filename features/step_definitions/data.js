@@ -33,6 +33,11 @@ module.exports = function () {
         callback();
     });
 
+    this.Given(/^the datastore extra arguments "(.*?)"$/, (args, callback) => {
+        this.datastoreArgs = this.expandOptions(args);
+        callback();
+    });
+
     this.Given(/^a grid size of ([0-9.]+) meters$/, (meters, callback) => {
         this.setGridSize(meters);
         callback();
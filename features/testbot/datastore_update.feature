@@ -0,0 +1,39 @@
+@routing @datastore @traffic @mld @testbot
+Feature: Updating blocks of the loaded dataset with osrm-datastore
+
+    Background:
+        Given the profile "testbot"
+        And the extract extra arguments "--generate-edge-lookup"
+        And data is loaded with datastore
+
+    Scenario: Updated cell weights are used by MLD queries
+        Given the node map
+            """
+            a b
+            c  d
+            """
+
+        And the ways
+            | nodes |
+            | ab    |
+            | bd    |
+            | ac    |
+            | cd    |
+
+        And the speed file
+            """
+            1,2,1
+            2,1,1
+            """
+
+        When I route I should get
+            | from | to | route    |
+            | a    | d  | ab,bd,bd |
+
+        When I run "osrm-customize --segment-speed-file {speeds_file} {processed_file}"
+        Then it should exit successfully
+
+        Given the datastore extra arguments "--update-blocks=MLD_CELL_WEIGHTS"
+        When I route I should get
+            | from | to | route    |
+            | a    | d  | ac,cd,cd |
@@ -0,0 +1,38 @@
+@nearest @speed @traffic
+Feature: Traffic - closed segments
+
+    Background:
+        Given the node map
+            """
+            a x b
+
+            c y d
+            """
+        And the ways
+            | nodes |
+            | axb   |
+            | cyd   |
+        And the profile "testbot"
+        And the extract extra arguments "--generate-edge-lookup"
+
+    Scenario: Open segments are snapped to
+        When I request nearest I should get
+            | in | out |
+            | x  | x   |
+            | y  | y   |
+
+    Scenario: Closed segments are not snapped to
+        Given the contract extra arguments "--segment-speed-file {speeds_file}"
+        And the customize extra arguments "--segment-speed-file {speeds_file}"
+        And the speed file
+        """
+        1,2,0
+        2,1,0
+        2,3,0
+        3,2,0
+        """
+
+        When I request nearest I should get
+            | in | out |
+            | x  | y   |
+            | y  | y   |
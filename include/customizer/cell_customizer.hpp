@@ -4,10 +4,19 @@
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
 #include "util/binary_heap.hpp"
+#include "util/relax_kernels.hpp"
 
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_do.h>
+#include <tbb/parallel_for.h>
 
+#include <atomic>
+#include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 namespace osrm
 {
@@ -33,61 +42,150 @@ class CellCustomizer
     void Customize(
         const GraphT &graph, Heap &heap, partition::CellStorage &cells, LevelID level, CellID id)
     {
-        auto cell = cells.GetCell(level, id);
-        auto destinations = cell.GetDestinationNodes();
+        for (auto source : cells.GetCell(level, id).GetSourceNodes())
+        {
+            Customize(graph, heap, cells, level, id, source);
+        }
+    }
 
-        // for each source do forward search
-        for (auto source : cell.GetSourceNodes())
+    // Customizes all cells of all levels.
+    //
+    // Cells are not processed level by level with a barrier in between: a cell is scheduled
+    // as soon as its last child cell is finished. The parent is fed to the worker that
+    // finished that child, so it reads the child weights from the same cache and memory node
+    // they were just written to. Cells with many sources (the few huge cells of the top
+    // levels) are additionally split into parallel per-source searches.
+    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+    {
+        Heap heap_exemplar(graph.GetNumberOfNodes());
+        HeapPtr heaps(heap_exemplar);
+
+        struct CellTask
         {
-            std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
-            heap.Clear();
-            heap.Insert(source, 0, {false});
+            LevelID level;
+            CellID id;
+        };
+        using Feeder = tbb::parallel_do_feeder<CellTask>;
 
-            // explore search space
-            while (!heap.Empty() && !destinations_set.empty())
-            {
-                const NodeID node = heap.DeleteMin();
-                const EdgeWeight weight = heap.GetKey(node);
+        const LevelID number_of_levels = partition.GetNumberOfLevels();
 
-                if (level == 1)
-                    RelaxNode<true>(graph, cells, heap, level, node, weight);
-                else
-                    RelaxNode<false>(graph, cells, heap, level, node, weight);
+        // parent_cell[level][id] is the cell containing (level, id) on level + 1 and
+        // pending_children[level][id] the number of its children that are not customized yet
+        std::vector<std::vector<CellID>> parent_cell(number_of_levels);
+        std::vector<std::vector<std::atomic<std::uint32_t>>> pending_children(number_of_levels);
 
-                destinations_set.erase(node);
-            }
+        std::vector<CellTask> ready_cells;
+        ready_cells.reserve(number_of_levels > 1 ? partition.GetNumberOfCells(1) : 0);
+        for (LevelID level = 1; level < number_of_levels; ++level)
+        {
+            const auto number_of_cells = partition.GetNumberOfCells(level);
+            parent_cell[level].resize(number_of_cells, INVALID_CELL_ID);
+            pending_children[level] = std::vector<std::atomic<std::uint32_t>>(number_of_cells);
 
-            // fill a map of destination nodes to placeholder pointers
-            auto destination_iter = destinations.begin();
-            for (auto &weight : cell.GetOutWeight(source))
+            for (CellID id = 0; id < number_of_cells; ++id)
             {
-                BOOST_ASSERT(destination_iter != destinations.end());
-                const auto destination = *destination_iter++;
-                weight =
-                    heap.WasInserted(destination) ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
+                std::uint32_t number_of_children = 0;
+                if (level > 1)
+                {
+                    const auto begin = partition.BeginChildren(level, id);
+                    const auto end = partition.EndChildren(level, id);
+                    for (auto child = begin; child < end; ++child)
+                    {
+                        parent_cell[level - 1][child] = id;
+                    }
+                    number_of_children = end - begin;
+                }
+
+                pending_children[level][id] = number_of_children;
+                if (number_of_children == 0)
+                    ready_cells.push_back({level, id});
             }
         }
+
+        tbb::parallel_do(
+            ready_cells.begin(), ready_cells.end(), [&](const CellTask &task, Feeder &feeder) {
+                CustomizeCell(graph, heaps, cells, task.level, task.id);
+
+                const LevelID parent_level = task.level + 1;
+                if (parent_level < number_of_levels)
+                {
+                    const auto parent = parent_cell[task.level][task.id];
+                    BOOST_ASSERT(parent != INVALID_CELL_ID);
+                    if (--pending_children[parent_level][parent] == 0)
+                        feeder.add({parent_level, parent});
+                }
+            });
     }
 
-    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+  private:
+    // Cells with at least this many sources run their searches in parallel
+    static constexpr std::size_t PARALLEL_SOURCES_THRESHOLD = 128;
+
+    template <typename GraphT>
+    void CustomizeCell(const GraphT &graph,
+                       HeapPtr &heaps,
+                       partition::CellStorage &cells,
+                       LevelID level,
+                       CellID id)
     {
-        Heap heap_exemplar(graph.GetNumberOfNodes());
-        HeapPtr heaps(heap_exemplar);
+        const auto sources = cells.GetCell(level, id).GetSourceNodes();
+        if (sources.size() < PARALLEL_SOURCES_THRESHOLD)
+        {
+            Customize(graph, heaps.local(), cells, level, id);
+            return;
+        }
+
+        // Every source writes its own row of the weight matrix. The heap is only taken inside
+        // the loop body: while waiting for this loop the thread may run other cells.
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, sources.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              auto &heap = heaps.local();
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  Customize(graph, heap, cells, level, id, sources[index]);
+                              }
+                          });
+    }
+
+    template <typename GraphT>
+    void Customize(const GraphT &graph,
+                   Heap &heap,
+                   partition::CellStorage &cells,
+                   LevelID level,
+                   CellID id,
+                   NodeID source)
+    {
+        auto cell = cells.GetCell(level, id);
+        auto destinations = cell.GetDestinationNodes();
+
+        std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
+        heap.Clear();
+        heap.Insert(source, 0, {false});
+
+        // explore search space
+        while (!heap.Empty() && !destinations_set.empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight weight = heap.GetKey(node);
+
+            if (level == 1)
+                RelaxNode<true>(graph, cells, heap, level, node, weight);
+            else
+                RelaxNode<false>(graph, cells, heap, level, node, weight);
+
+            destinations_set.erase(node);
+        }
 
-        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        // fill a map of destination nodes to placeholder pointers
+        auto destination_iter = destinations.begin();
+        for (auto &weight : cell.GetOutWeight(source))
         {
-            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
-                              [&](const tbb::blocked_range<std::size_t> &range) {
-                                  auto &heap = heaps.local();
-                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
-                                  {
-                                      Customize(graph, heap, cells, level, id);
-                                  }
-                              });
+            BOOST_ASSERT(destination_iter != destinations.end());
+            const auto destination = *destination_iter++;
+            weight = heap.WasInserted(destination) ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
         }
     }
 
-  private:
     template <bool first_level, typename GraphT>
     void RelaxNode(const GraphT &graph,
                    const partition::CellStorage &cells,
@@ -112,13 +210,14 @@ class CellCustomizer
                 // Relax sub-cell nodes
                 auto subcell_id = partition.GetCell(level - 1, node);
                 auto subcell = cells.GetCell(level - 1, subcell_id);
-                auto subcell_destination = subcell.GetDestinationNodes().begin();
-                for (auto subcell_weight : subcell.GetOutWeight(node))
-                {
-                    if (subcell_weight != INVALID_EDGE_WEIGHT)
-                    {
-                        const NodeID to = *subcell_destination;
-                        const EdgeWeight to_weight = subcell_weight + weight;
+                auto subcell_destinations = subcell.GetDestinationNodes();
+                util::simd::relaxWeights(
+                    subcell.GetOutWeight(node),
+                    1,
+                    weight,
+                    [&](const auto index, const auto to_weight) {
+                        BOOST_ASSERT(index < subcell_destinations.size());
+                        const NodeID to = subcell_destinations[index];
                         if (!heap.WasInserted(to))
                         {
                             heap.Insert(to, to_weight, {true});
@@ -128,10 +227,7 @@ class CellCustomizer
                             heap.DecreaseKey(to, to_weight);
                             heap.GetData(to).from_clique = true;
                         }
-                    }
-
-                    ++subcell_destination;
-                }
+                    });
             }
         }
 
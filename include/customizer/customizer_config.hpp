@@ -15,7 +15,7 @@ namespace customizer
 
 struct CustomizationConfig
 {
-    CustomizationConfig() : requested_num_threads(0) {}
+    CustomizationConfig() : requested_num_threads(0), write_overlay_graph(false) {}
 
     void UseDefaults()
     {
@@ -36,6 +36,7 @@ struct CustomizationConfig
         mld_partition_path = basepath + ".osrm.partition";
         mld_storage_path = basepath + ".osrm.cells";
         mld_graph_path = basepath + ".osrm.mldgr";
+        mld_overlay_path = basepath + ".osrm.overlay";
 
         updater_config.osrm_input_path = basepath + ".osrm";
         updater_config.UseDefaultOutputNames();
@@ -47,8 +48,11 @@ struct CustomizationConfig
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path mld_overlay_path;
 
     unsigned requested_num_threads;
+    // write the query optimized overlay graph (.osrm.overlay)
+    bool write_overlay_graph;
 
     updater::UpdaterConfig updater_config;
 };
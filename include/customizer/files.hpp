@@ -0,0 +1,46 @@
+#ifndef OSRM_CUSTOMIZER_FILES_HPP
+#define OSRM_CUSTOMIZER_FILES_HPP
+
+#include "customizer/overlay_graph.hpp"
+#include "customizer/serialization.hpp"
+
+#include "storage/container.hpp"
+
+namespace osrm
+{
+namespace customizer
+{
+namespace files
+{
+
+// reads .osrm.overlay file
+template <typename OverlayGraphT>
+inline void readOverlayGraph(const boost::filesystem::path &path, OverlayGraphT &graph)
+{
+    static_assert(std::is_same<OverlayGraphView, OverlayGraphT>::value ||
+                      std::is_same<OverlayGraph, OverlayGraphT>::value,
+                  "");
+
+    storage::container::FileReader reader{path};
+
+    serialization::read(reader, "/mld/overlaygraph", graph);
+}
+
+// writes .osrm.overlay file
+template <typename OverlayGraphT>
+inline void writeOverlayGraph(const boost::filesystem::path &path, const OverlayGraphT &graph)
+{
+    static_assert(std::is_same<OverlayGraphView, OverlayGraphT>::value ||
+                      std::is_same<OverlayGraph, OverlayGraphT>::value,
+                  "");
+
+    storage::container::FileWriter writer{path};
+
+    serialization::write(writer, "/mld/overlaygraph", graph);
+    writer.Finish();
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef OSRM_CUSTOMIZER_OVERLAY_GRAPH_HPP
+#define OSRM_CUSTOMIZER_OVERLAY_GRAPH_HPP
+
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class OverlayGraphImpl;
+}
+using OverlayGraph = detail::OverlayGraphImpl<storage::Ownership::Container>;
+using OverlayGraphView = detail::OverlayGraphImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 detail::OverlayGraphImpl<Ownership> &graph);
+template <storage::Ownership Ownership>
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
+                  const detail::OverlayGraphImpl<Ownership> &graph);
+}
+
+namespace detail
+{
+// Query optimized representation of the clique arcs stored in the CellStorage.
+//
+// For every level the boundary nodes are stored ordered by cell and node id.
+// Each node entry directly points to its clique arcs which are stored inline
+// with the target node and weight, so relaxing a node on an overlay level only
+// scans two contiguous arrays. Invalid arcs and self-loops are removed.
+//
+// Forward arcs are the rows of the cell weight matrix (source to destination),
+// backward arcs the columns (destination to source).
+template <storage::Ownership Ownership> class OverlayGraphImpl
+{
+  public:
+    using ArcOffset = std::uint32_t;
+    using NodeOffset = std::uint32_t;
+
+    struct OverlayNode
+    {
+        NodeID node;
+        ArcOffset arc_offset;
+    };
+
+    struct OverlayArc
+    {
+        NodeID node;
+        EdgeWeight weight;
+    };
+
+    struct CellOffsets
+    {
+        NodeOffset forward_offset;
+        NodeOffset backward_offset;
+    };
+
+  private:
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+    std::size_t LevelIDToIndex(LevelID level) const { return level - 1; }
+
+    // The offsets are 32 bit to keep the node entries small, the arcs of all levels of a
+    // planet sized graph can exceed that. Such graphs are rejected instead of wrapping around.
+    template <typename OffsetT> static OffsetT MakeOffset(const std::size_t size, const char *name)
+    {
+        if (size > std::numeric_limits<OffsetT>::max())
+        {
+            throw util::exception("The overlay graph has " + std::to_string(size) + " " + name +
+                                  ", more than its " + std::to_string(sizeof(OffsetT) * 8) +
+                                  "bit offsets can address" + SOURCE_REF);
+        }
+        return static_cast<OffsetT>(size);
+    }
+
+    static auto FindArcs(const Vector<OverlayNode> &nodes,
+                         const Vector<OverlayArc> &arcs,
+                         NodeOffset begin,
+                         NodeOffset end,
+                         NodeID node)
+    {
+        BOOST_ASSERT(begin <= end && end <= nodes.size());
+        const auto nodes_begin = nodes.data() + begin;
+        const auto nodes_end = nodes.data() + end;
+        const auto iter = std::lower_bound(
+            nodes_begin, nodes_end, node, [](const OverlayNode &lhs, const NodeID rhs) {
+                return lhs.node < rhs;
+            });
+        if (iter == nodes_end || iter->node != node)
+            return boost::make_iterator_range(arcs.data(), arcs.data());
+
+        // nodes contain a sentinel entry so the next arc offset always exists
+        const auto arcs_begin = arcs.data() + iter->arc_offset;
+        const auto arcs_end = arcs.data() + std::next(iter)->arc_offset;
+        return boost::make_iterator_range(arcs_begin, arcs_end);
+    }
+
+  public:
+    OverlayGraphImpl() = default;
+
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    OverlayGraphImpl(const partition::MultiLevelPartition &partition,
+                     const partition::CellStorage &storage)
+    {
+        std::uint64_t number_of_cells = 0;
+        for (LevelID level = 1u; level < partition.GetNumberOfLevels(); ++level)
+        {
+            level_to_cell_offset.push_back(number_of_cells);
+            number_of_cells += partition.GetNumberOfCells(level);
+        }
+        level_to_cell_offset.push_back(number_of_cells);
+        cell_offsets.reserve(number_of_cells + 1);
+
+        const auto node_offset = [](const auto &nodes) {
+            return MakeOffset<NodeOffset>(nodes.size(), "boundary nodes");
+        };
+        const auto arc_offset = [](const auto &arcs) {
+            return MakeOffset<ArcOffset>(arcs.size(), "clique arcs");
+        };
+
+        const auto sorted_nodes = [](const auto &boundary) {
+            std::vector<NodeID> nodes(boundary.begin(), boundary.end());
+            std::sort(nodes.begin(), nodes.end());
+            return nodes;
+        };
+
+        for (LevelID level = 1u; level < partition.GetNumberOfLevels(); ++level)
+        {
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+            {
+                cell_offsets.push_back({node_offset(forward_nodes), node_offset(backward_nodes)});
+
+                const auto cell = storage.GetCell(level, id);
+                const auto sources = cell.GetSourceNodes();
+                const auto destinations = cell.GetDestinationNodes();
+
+                for (const auto source : sorted_nodes(sources))
+                {
+                    forward_nodes.push_back({source, arc_offset(forward_arcs)});
+                    auto destination = destinations.begin();
+                    for (const auto weight : cell.GetOutWeight(source))
+                    {
+                        if (weight != INVALID_EDGE_WEIGHT && *destination != source)
+                            forward_arcs.push_back({*destination, weight});
+                        ++destination;
+                    }
+                }
+
+                for (const auto destination : sorted_nodes(destinations))
+                {
+                    backward_nodes.push_back({destination, arc_offset(backward_arcs)});
+                    auto source = sources.begin();
+                    for (const auto weight : cell.GetInWeight(destination))
+                    {
+                        if (weight != INVALID_EDGE_WEIGHT && *source != destination)
+                            backward_arcs.push_back({*source, weight});
+                        ++source;
+                    }
+                }
+            }
+        }
+
+        // Sentinels for the cell and the node ranges
+        cell_offsets.push_back({node_offset(forward_nodes), node_offset(backward_nodes)});
+        forward_nodes.push_back({SPECIAL_NODEID, arc_offset(forward_arcs)});
+        backward_nodes.push_back({SPECIAL_NODEID, arc_offset(backward_arcs)});
+    }
+
+    template <typename = std::enable_if<Ownership == storage::Ownership::View>>
+    OverlayGraphImpl(Vector<std::uint64_t> level_to_cell_offset_,
+                     Vector<CellOffsets> cell_offsets_,
+                     Vector<OverlayNode> forward_nodes_,
+                     Vector<OverlayArc> forward_arcs_,
+                     Vector<OverlayNode> backward_nodes_,
+                     Vector<OverlayArc> backward_arcs_)
+        : level_to_cell_offset(std::move(level_to_cell_offset_)),
+          cell_offsets(std::move(cell_offsets_)), forward_nodes(std::move(forward_nodes_)),
+          forward_arcs(std::move(forward_arcs_)), backward_nodes(std::move(backward_nodes_)),
+          backward_arcs(std::move(backward_arcs_))
+    {
+    }
+
+    bool Empty() const { return cell_offsets.empty(); }
+
+    // Clique arcs leaving the node in the given cell, equivalent to the valid entries
+    // of CellStorage::Cell::GetOutWeight
+    auto GetOutArcs(LevelID level, CellID id, NodeID node) const
+    {
+        const auto cell_index = GetCellIndex(level, id);
+        return FindArcs(forward_nodes,
+                        forward_arcs,
+                        cell_offsets[cell_index].forward_offset,
+                        cell_offsets[cell_index + 1].forward_offset,
+                        node);
+    }
+
+    // Clique arcs entering the node in the given cell, equivalent to the valid entries
+    // of CellStorage::Cell::GetInWeight
+    auto GetInArcs(LevelID level, CellID id, NodeID node) const
+    {
+        const auto cell_index = GetCellIndex(level, id);
+        return FindArcs(backward_nodes,
+                        backward_arcs,
+                        cell_offsets[cell_index].backward_offset,
+                        cell_offsets[cell_index + 1].backward_offset,
+                        node);
+    }
+
+    friend void serialization::read<Ownership>(storage::container::FileReader &reader,
+                                               const std::string &name,
+                                               detail::OverlayGraphImpl<Ownership> &graph);
+    friend void serialization::write<Ownership>(storage::container::FileWriter &writer,
+                                                const std::string &name,
+                                                const detail::OverlayGraphImpl<Ownership> &graph);
+
+  private:
+    std::size_t GetCellIndex(LevelID level, CellID id) const
+    {
+        const auto level_index = LevelIDToIndex(level);
+        BOOST_ASSERT(level_index < level_to_cell_offset.size());
+        const auto cell_index = level_to_cell_offset[level_index] + id;
+        BOOST_ASSERT(cell_index + 1 < cell_offsets.size());
+        return cell_index;
+    }
+
+    Vector<std::uint64_t> level_to_cell_offset;
+    Vector<CellOffsets> cell_offsets;
+    Vector<OverlayNode> forward_nodes;
+    Vector<OverlayArc> forward_arcs;
+    Vector<OverlayNode> backward_nodes;
+    Vector<OverlayArc> backward_arcs;
+};
+}
+}
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef OSRM_CUSTOMIZER_SERIALIZATION_HPP
+#define OSRM_CUSTOMIZER_SERIALIZATION_HPP
+
+#include "customizer/overlay_graph.hpp"
+
+#include "storage/container.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <string>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace serialization
+{
+
+template <storage::Ownership Ownership>
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 detail::OverlayGraphImpl<Ownership> &graph)
+{
+    reader.ReadInto(name + "/level_to_cell_offset", graph.level_to_cell_offset);
+    reader.ReadInto(name + "/cell_offsets", graph.cell_offsets);
+    reader.ReadInto(name + "/forward_nodes", graph.forward_nodes);
+    reader.ReadInto(name + "/forward_arcs", graph.forward_arcs);
+    reader.ReadInto(name + "/backward_nodes", graph.backward_nodes);
+    reader.ReadInto(name + "/backward_arcs", graph.backward_arcs);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
+                  const detail::OverlayGraphImpl<Ownership> &graph)
+{
+    writer.WriteFrom(name + "/level_to_cell_offset", graph.level_to_cell_offset);
+    writer.WriteFrom(name + "/cell_offsets", graph.cell_offsets);
+    writer.WriteFrom(name + "/forward_nodes", graph.forward_nodes);
+    writer.WriteFrom(name + "/forward_arcs", graph.forward_arcs);
+    writer.WriteFrom(name + "/backward_nodes", graph.backward_nodes);
+    writer.WriteFrom(name + "/backward_arcs", graph.backward_arcs);
+}
+}
+}
+}
+
+#endif
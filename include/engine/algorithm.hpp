@@ -56,6 +56,9 @@ template <typename AlgorithmT> struct HasManyToManySearch final : std::false_typ
 template <typename AlgorithmT> struct HasGetTileTurns final : std::false_type
 {
 };
+template <typename AlgorithmT> struct HasIsochroneSearch final : std::false_type
+{
+};
 
 // Algorithms supported by Contraction Hierarchies
 template <> struct HasAlternativePathSearch<ch::Algorithm> final : std::true_type
@@ -76,6 +79,9 @@ template <> struct HasManyToManySearch<ch::Algorithm> final : std::true_type
 template <> struct HasGetTileTurns<ch::Algorithm> final : std::true_type
 {
 };
+template <> struct HasIsochroneSearch<ch::Algorithm> final : std::true_type
+{
+};
 
 // Algorithms supported by Contraction Hierarchies with core
 // the rest is disabled because of performance reasons
@@ -102,6 +108,12 @@ template <> struct HasShortestPathSearch<mld::Algorithm> final : std::true_type
 template <> struct HasMapMatching<mld::Algorithm> final : std::true_type
 {
 };
+template <> struct HasGetTileTurns<mld::Algorithm> final : std::true_type
+{
+};
+template <> struct HasIsochroneSearch<mld::Algorithm> final : std::true_type
+{
+};
 }
 }
 }
@@ -0,0 +1,232 @@
+#ifndef ENGINE_API_ISOCHRONE_API_HPP
+#define ENGINE_API_ISOCHRONE_API_HPP
+
+#include "engine/api/base_api.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+
+#include "engine/api/json_factory.hpp"
+#include "engine/douglas_peucker.hpp"
+#include "engine/isochrone_contour.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/routing_algorithms/isochrone.hpp"
+
+#include "util/coordinate_calculation.hpp"
+#include "util/viewport.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+class IsochroneAPI final : public BaseAPI
+{
+  public:
+    IsochroneAPI(const datafacade::BaseDataFacade &facade_, const IsochroneParameters &parameters_)
+        : BaseAPI(facade_, parameters_), parameters(parameters_)
+    {
+    }
+
+    void MakeResponse(const PhantomNode &source,
+                      const std::vector<routing_algorithms::IsochroneNode> &reachable_nodes,
+                      util::json::Object &response) const
+    {
+        BOOST_ASSERT(parameters.coordinates.size() == 1);
+
+        util::json::Array waypoints;
+        waypoints.values.push_back(MakeWaypoint(source));
+
+        util::json::Array isochrones;
+        isochrones.values.reserve(parameters.contours.size());
+        for (const auto contour : parameters.contours)
+        {
+            const auto max_duration = static_cast<EdgeWeight>(std::round(contour * 10.));
+            const auto lines = MakeReachableLines(reachable_nodes, max_duration);
+
+            util::json::Object isochrone;
+            isochrone.values["duration"] = contour;
+            isochrone.values["geometry"] =
+                parameters.polygons ? MakePolygon(lines) : MakeMultiLineString(lines);
+            isochrones.values.push_back(std::move(isochrone));
+        }
+
+        response.values["code"] = "Ok";
+        response.values["waypoints"] = std::move(waypoints);
+        response.values["isochrones"] = std::move(isochrones);
+    }
+
+    const IsochroneParameters &parameters;
+
+  private:
+    using Line = std::vector<util::Coordinate>;
+
+    // Returns the part of every reachable segment that can be traversed within max_duration.
+    // The durations of the nodes are measured from the phantom node, so the parts of the
+    // source segments behind the phantom node start with a negative duration and are skipped.
+    std::vector<Line>
+    MakeReachableLines(const std::vector<routing_algorithms::IsochroneNode> &reachable_nodes,
+                       const EdgeWeight max_duration) const
+    {
+        std::vector<Line> lines;
+        for (const auto &reachable : reachable_nodes)
+        {
+            if (reachable.duration >= max_duration)
+                continue;
+
+            const auto geometry_id = facade.GetGeometryIndexForEdgeID(reachable.node);
+            if (geometry_id.forward)
+            {
+                AppendReachableLine(facade.GetUncompressedForwardGeometry(geometry_id.id),
+                                    facade.GetUncompressedForwardDurations(geometry_id.id),
+                                    reachable.duration,
+                                    max_duration,
+                                    lines);
+            }
+            else
+            {
+                AppendReachableLine(facade.GetUncompressedReverseGeometry(geometry_id.id),
+                                    facade.GetUncompressedReverseDurations(geometry_id.id),
+                                    reachable.duration,
+                                    max_duration,
+                                    lines);
+            }
+        }
+        return lines;
+    }
+
+    template <typename NodeRange, typename DurationRange>
+    void AppendReachableLine(const NodeRange &nodes,
+                             const DurationRange &durations,
+                             const EdgeWeight start_duration,
+                             const EdgeWeight max_duration,
+                             std::vector<Line> &lines) const
+    {
+        BOOST_ASSERT(nodes.size() == durations.size() + 1);
+
+        Line line;
+        auto from_duration = start_duration;
+        for (std::size_t index = 0; index < durations.size(); ++index)
+        {
+            if (from_duration >= max_duration)
+                break;
+
+            const auto segment_duration = static_cast<EdgeWeight>(durations[index]);
+            const auto to_duration = from_duration + segment_duration;
+            if (to_duration > 0)
+            {
+                const auto from = facade.GetCoordinateOfNode(nodes[index]);
+                const auto to = facade.GetCoordinateOfNode(nodes[index + 1]);
+                const auto interpolate = [&](const EdgeWeight duration) {
+                    const auto factor =
+                        static_cast<double>(duration - from_duration) / segment_duration;
+                    return util::coordinate_calculation::interpolateLinear(factor, from, to);
+                };
+
+                if (line.empty())
+                    line.push_back(from_duration < 0 ? interpolate(0) : from);
+                line.push_back(to_duration > max_duration ? interpolate(max_duration) : to);
+            }
+            from_duration = to_duration;
+        }
+
+        if (line.size() > 1)
+            lines.push_back(std::move(line));
+    }
+
+    util::json::Object MakeMultiLineString(const std::vector<Line> &lines) const
+    {
+        util::json::Array coordinates;
+        coordinates.values.reserve(lines.size());
+        for (const auto &line : lines)
+        {
+            util::json::Array line_coordinates;
+            line_coordinates.values.reserve(line.size());
+            std::transform(line.begin(),
+                           line.end(),
+                           std::back_inserter(line_coordinates.values),
+                           &json::detail::coordinateToLonLat);
+            coordinates.values.push_back(std::move(line_coordinates));
+        }
+
+        util::json::Object geojson;
+        geojson.values["type"] = "MultiLineString";
+        geojson.values["coordinates"] = std::move(coordinates);
+        return geojson;
+    }
+
+    // The polygons trace the area around the reachable segments, see traceContour. Their rings
+    // are simplified for the zoom level that fits the largest polygon.
+    util::json::Object MakePolygon(const std::vector<Line> &lines) const
+    {
+        const auto polygons = traceContour(lines);
+
+        util::json::Array coordinates;
+        coordinates.values.reserve(polygons.size());
+        if (!polygons.empty())
+        {
+            const auto &largest = polygons.front().front();
+            util::Coordinate south_west = largest.front();
+            util::Coordinate north_east = largest.front();
+            for (const auto &coordinate : largest)
+            {
+                south_west.lon = std::min(south_west.lon, coordinate.lon);
+                south_west.lat = std::min(south_west.lat, coordinate.lat);
+                north_east.lon = std::max(north_east.lon, coordinate.lon);
+                north_east.lat = std::max(north_east.lat, coordinate.lat);
+            }
+            const auto zoom = util::viewport::getFittedZoom(south_west, north_east);
+
+            for (const auto &polygon : polygons)
+            {
+                util::json::Array rings;
+                rings.values.reserve(polygon.size());
+                for (const auto &ring : polygon)
+                {
+                    const auto simplified = SimplifyRing(ring, zoom);
+                    util::json::Array ring_coordinates;
+                    ring_coordinates.values.reserve(simplified.size());
+                    std::transform(simplified.begin(),
+                                   simplified.end(),
+                                   std::back_inserter(ring_coordinates.values),
+                                   &json::detail::coordinateToLonLat);
+                    rings.values.push_back(std::move(ring_coordinates));
+                }
+                coordinates.values.push_back(std::move(rings));
+            }
+        }
+
+        util::json::Object geojson;
+        geojson.values["type"] = "MultiPolygon";
+        geojson.values["coordinates"] = std::move(coordinates);
+        return geojson;
+    }
+
+    // The first and last coordinate of a ring are the same, so it is split into two halves that
+    // are simplified on their own. Rings that would collapse are kept as they are.
+    static ContourRing SimplifyRing(const ContourRing &ring, const unsigned zoom)
+    {
+        BOOST_ASSERT(ring.size() >= 5);
+        const auto middle = ring.begin() + ring.size() / 2;
+        auto simplified = douglasPeucker(ring.begin(), middle + 1, zoom);
+        const auto second_half = douglasPeucker(middle, ring.end(), zoom);
+        simplified.insert(simplified.end(), std::next(second_half.begin()), second_half.end());
+
+        if (simplified.size() < 4)
+            return ring;
+        return simplified;
+    }
+};
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <iterator>
+#include <vector>
 
 #include "engine/api/match_parameters.hpp"
 #include "util/coordinate_calculation.hpp"
@@ -92,12 +93,15 @@ inline Result tidy(const MatchParameters &params, Thresholds cfg = {15., 5})
 
     Thresholds running{0., 0};
 
+    // distances between adjacent coordinates, computed in one vectorized pass
+    std::vector<double> distance_deltas(params.coordinates.size() - 1);
+    util::coordinate_calculation::approximateSegmentLengths(
+        params.coordinates.data(), params.coordinates.size(), distance_deltas.data());
+
     // Walk over adjacent (coord, ts)-pairs, with rhs being the candidate to discard or keep
     for (std::size_t current = 0, next = 1; next < params.coordinates.size() - 1; ++current, ++next)
     {
-        auto distance_delta = util::coordinate_calculation::haversineDistance(
-            params.coordinates[current], params.coordinates[next]);
-        running.distance_in_meters += distance_delta;
+        running.distance_in_meters += distance_deltas[current];
         const auto over_distance = running.distance_in_meters >= cfg.distance_in_meters;
 
         if (uses_timestamps)
@@ -13,6 +13,8 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
 
@@ -24,22 +26,30 @@ namespace engine
 // This class monitors the shared memory region that contains the pointers to
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
+//
+// The current facade is published with atomic shared_ptr operations: requests take a
+// reference with a single atomic load and keep using their facade until they finish. The
+// facade of a previous dataset, and with it the mapping of its region, is released by
+// the last request that still holds a reference to it.
 template <typename AlgorithmT> class DataWatchdog final
 {
     using mutex_type = typename storage::SharedMonitor<storage::SharedDataTimestamp>::mutex_type;
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdog() : active(true), timestamp(0)
+    DataWatchdog(const datafacade::PrewarmMode prewarm_ = datafacade::PrewarmMode::None,
+                 const bool record_accesses_ = false)
+        : active(true), timestamp(0), prewarm(prewarm_), record_accesses(record_accesses_)
     {
         // create the initial facade before launching the watchdog thread
+        std::unique_ptr<datafacade::SharedMemoryAllocator> allocator;
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-            facade = std::make_shared<const FacadeT>(
-                std::make_unique<datafacade::SharedMemoryAllocator>(barrier.data().region));
+            allocator = std::make_unique<datafacade::SharedMemoryAllocator>(barrier.data().region);
             timestamp = barrier.data().timestamp;
         }
+        facade = MakeFacade(std::move(allocator));
 
         watcher = std::thread(&DataWatchdog::Run, this);
     }
@@ -51,29 +61,62 @@ template <typename AlgorithmT> class DataWatchdog final
         watcher.join();
     }
 
-    std::shared_ptr<const FacadeT> Get() const { return facade; }
+    std::shared_ptr<const FacadeT> Get() const { return std::atomic_load(&facade); }
 
   private:
+    // The dataset is prewarmed before it is published, requests never hit a cold dataset.
+    // The region stays attached by the allocator, so this runs without holding the barrier
+    // lock and doesn't block osrm-datastore or the watchdogs of other processes.
+    std::shared_ptr<const FacadeT>
+    MakeFacade(std::unique_ptr<datafacade::SharedMemoryAllocator> allocator) const
+    {
+        allocator->Prewarm(prewarm);
+        if (record_accesses)
+            allocator->EnableAccessCounts();
+        return std::make_shared<const FacadeT>(std::move(allocator));
+    }
+
     void Run()
     {
         while (active)
         {
-            boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
-
-            while (active && timestamp == barrier.data().timestamp)
+            std::unique_ptr<datafacade::SharedMemoryAllocator> allocator;
+            storage::SharedDataType region;
+            unsigned new_timestamp;
             {
-                barrier.wait(current_region_lock);
+                boost::interprocess::scoped_lock<mutex_type> current_region_lock(
+                    barrier.get_mutex());
+
+                while (active && timestamp == barrier.data().timestamp)
+                {
+                    barrier.wait(current_region_lock);
+                }
+
+                if (timestamp == barrier.data().timestamp)
+                {
+                    continue;
+                }
+
+                region = barrier.data().region;
+                new_timestamp = barrier.data().timestamp;
+                allocator = std::make_unique<datafacade::SharedMemoryAllocator>(region);
             }
 
-            if (timestamp != barrier.data().timestamp)
-            {
-                auto region = barrier.data().region;
-                facade = std::make_shared<const FacadeT>(
-                    std::make_unique<datafacade::SharedMemoryAllocator>(region));
-                timestamp = barrier.data().timestamp;
-                util::Log() << "updated facade to region " << region << " with timestamp "
-                            << timestamp;
-            }
+            auto new_facade = MakeFacade(std::move(allocator));
+
+            const auto swap_start = std::chrono::steady_clock::now();
+            auto old_facade = std::atomic_exchange(&facade, std::move(new_facade));
+            const auto swap_duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - swap_start);
+            timestamp = new_timestamp;
+
+            // every reference except ours belongs to a request that is still in flight
+            const auto in_flight = old_facade.use_count() - 1;
+            old_facade.reset();
+
+            util::Log() << "updated facade to region " << region << " with timestamp "
+                        << timestamp << " in " << swap_duration.count() << "us, " << in_flight
+                        << " requests still use the previous data";
         }
 
         util::Log() << "DataWatchdog thread stopped";
@@ -81,8 +124,11 @@ template <typename AlgorithmT> class DataWatchdog final
 
     storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
     std::thread watcher;
-    bool active;
+    std::atomic<bool> active;
     unsigned timestamp;
+    const datafacade::PrewarmMode prewarm;
+    const bool record_accesses;
+    // only accessed through std::atomic_load / std::atomic_store / std::atomic_exchange
     std::shared_ptr<const FacadeT> facade;
 };
 }
@@ -5,6 +5,8 @@
 #include "extractor/edge_based_edge.hpp"
 #include "engine/algorithm.hpp"
 
+#include "customizer/overlay_graph.hpp"
+
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
 
@@ -95,6 +97,9 @@ template <> class AlgorithmDataFacade<MLD>
 
     virtual const partition::CellStorageView &GetCellStorage() const = 0;
 
+    // empty if the dataset was customized without --overlay-graph
+    virtual const customizer::OverlayGraphView &GetOverlayGraph() const = 0;
+
     virtual EdgeRange GetBorderEdgeRange(const LevelID level, const NodeID node) const = 0;
 
     // searches for a specific edge
@@ -1,8 +1,16 @@
 #ifndef OSRM_ENGINE_DATAFACADE_CONTIGUOUS_BLOCK_ALLOCATOR_HPP_
 #define OSRM_ENGINE_DATAFACADE_CONTIGUOUS_BLOCK_ALLOCATOR_HPP_
 
+#include "storage/residency.hpp"
 #include "storage/shared_datatype.hpp"
 
+#include "util/log.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -10,14 +18,121 @@ namespace engine
 namespace datafacade
 {
 
+enum class PrewarmMode
+{
+    None,
+    Touch, // fault in the hot blocks
+    Lock   // fault in and lock the hot blocks in RAM
+};
+
 class ContiguousBlockAllocator
 {
   public:
+    // Only every ACCESS_SAMPLE_RATE-th access of a thread is counted
+    static constexpr std::uint32_t ACCESS_SAMPLE_RATE = 64;
+
     virtual ~ContiguousBlockAllocator() = default;
 
     // interface to give access to the datafacades
     virtual storage::DataLayout &GetLayout() = 0;
     virtual char *GetMemory() = 0;
+
+    // Layout and memory that hold the given block. Allocators that combine blocks
+    // of several memory regions override these, the default is the single region.
+    virtual storage::DataLayout &GetBlockLayout(storage::DataLayout::BlockID)
+    {
+        return GetLayout();
+    }
+    virtual char *GetBlockMemory(storage::DataLayout::BlockID) { return GetMemory(); }
+
+    template <typename T> T *GetBlockPtr(storage::DataLayout::BlockID bid)
+    {
+        return GetBlockLayout(bid).template GetBlockPtr<T>(GetBlockMemory(bid), bid);
+    }
+
+    std::uint64_t GetBlockEntries(storage::DataLayout::BlockID bid)
+    {
+        return GetBlockLayout(bid).GetBlockEntries(bid);
+    }
+
+    std::uint64_t GetBlockSize(storage::DataLayout::BlockID bid)
+    {
+        return GetBlockLayout(bid).GetBlockSize(bid);
+    }
+
+    std::vector<storage::BlockMemory>
+    GetBlocks(const std::vector<storage::DataLayout::BlockID> &bids)
+    {
+        std::vector<storage::BlockMemory> blocks;
+        blocks.reserve(bids.size());
+        for (const auto bid : bids)
+        {
+            const auto begin = GetBlockLayout(bid).GetAlignedBlockPtr(GetBlockMemory(bid), bid);
+            blocks.push_back({bid, static_cast<const char *>(begin), GetBlockSize(bid)});
+        }
+        return blocks;
+    }
+
+    // Access counting is off by default, it costs a branch in every facade accessor
+    void EnableAccessCounts()
+    {
+        if (!access_counts)
+            access_counts = std::make_unique<PaddedAccessCount[]>(storage::DataLayout::NUM_BLOCKS);
+    }
+
+    bool HasAccessCounts() const { return access_counts != nullptr; }
+
+    // Called by the facade accessors, the counts are estimates of the number of accesses.
+    // Accesses are sampled pseudo-randomly so periodic access patterns don't skew the counts.
+    void RecordAccess(const storage::DataLayout::BlockID bid)
+    {
+        if (!access_counts)
+            return;
+
+        // xorshift32
+        thread_local std::uint32_t state = 2463534242;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if (state % ACCESS_SAMPLE_RATE == 0)
+        {
+            access_counts[bid].count.fetch_add(ACCESS_SAMPLE_RATE, std::memory_order_relaxed);
+        }
+    }
+
+    // The counts belong to the allocator of a dataset, so they start at zero again whenever
+    // a new dataset is loaded, e.g. after osrm-datastore swapped the dataset in shared memory.
+    std::uint64_t GetAccessCount(const storage::DataLayout::BlockID bid) const
+    {
+        return access_counts ? access_counts[bid].count.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Faults in the blocks that are used by every query before the first request
+    void Prewarm(const PrewarmMode mode)
+    {
+        if (mode == PrewarmMode::None)
+            return;
+
+        const auto blocks = GetBlocks(storage::getHotBlocks());
+        if (!storage::prewarmBlocks(blocks, mode == PrewarmMode::Lock))
+        {
+            util::Log(logWARNING) << "Could not lock the dataset in RAM, check the memlock limit";
+        }
+        storage::logResidency(blocks);
+    }
+
+  private:
+    // Counters of different blocks are updated by all query threads, so each one gets a cache
+    // line of its own. With the padding on both sides no other data shares its cache line,
+    // independent of the alignment of the allocator.
+    struct PaddedAccessCount
+    {
+        char padding_before[64];
+        std::atomic<std::uint64_t> count{0};
+        char padding_after[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    std::unique_ptr<PaddedAccessCount[]> access_counts;
 };
 
 } // namespace datafacade
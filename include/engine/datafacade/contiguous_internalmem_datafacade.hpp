@@ -37,6 +37,7 @@
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/rectangle.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
@@ -74,18 +75,18 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
-    void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGraphPointer()
     {
-        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
-            memory_block, storage::DataLayout::CH_GRAPH_NODE_LIST);
+        auto graph_nodes_ptr =
+            allocator->GetBlockPtr<GraphNode>(storage::DataLayout::CH_GRAPH_NODE_LIST);
 
-        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(
-            memory_block, storage::DataLayout::CH_GRAPH_EDGE_LIST);
+        auto graph_edges_ptr =
+            allocator->GetBlockPtr<GraphEdge>(storage::DataLayout::CH_GRAPH_EDGE_LIST);
 
         util::vector_view<GraphNode> node_list(
-            graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
+            graph_nodes_ptr, allocator->GetBlockEntries(storage::DataLayout::CH_GRAPH_NODE_LIST));
         util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+            graph_edges_ptr, allocator->GetBlockEntries(storage::DataLayout::CH_GRAPH_EDGE_LIST));
         m_query_graph = QueryGraph(node_list, edge_list);
     }
 
@@ -94,12 +95,12 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers();
     }
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers()
     {
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializeGraphPointer();
     }
 
     // search graph access
@@ -116,6 +117,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
 
     const EdgeData &GetEdgeData(const EdgeID e) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::CH_GRAPH_EDGE_LIST);
         return m_query_graph.GetEdgeData(e);
     }
 
@@ -125,6 +127,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
 
     EdgeRange GetAdjacentEdgeRange(const NodeID node) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::CH_GRAPH_NODE_LIST);
         return m_query_graph.GetAdjacentEdgeRange(node);
     }
 
@@ -163,12 +166,12 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
-    void InitializeCoreInformationPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeCoreInformationPointer()
     {
         auto core_marker_ptr =
-            data_layout.GetBlockPtr<unsigned>(memory_block, storage::DataLayout::CH_CORE_MARKER);
+            allocator->GetBlockPtr<unsigned>(storage::DataLayout::CH_CORE_MARKER);
         util::vector_view<bool> is_core_node(
-            core_marker_ptr, data_layout.num_entries[storage::DataLayout::CH_CORE_MARKER]);
+            core_marker_ptr, allocator->GetBlockEntries(storage::DataLayout::CH_CORE_MARKER));
         m_is_core_node = std::move(is_core_node);
     }
 
@@ -177,16 +180,17 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers();
     }
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers()
     {
-        InitializeCoreInformationPointer(data_layout, memory_block);
+        InitializeCoreInformationPointer();
     }
 
     bool IsCoreNode(const NodeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::CH_CORE_MARKER);
         BOOST_ASSERT(id < m_is_core_node.size());
         return m_is_core_node[id];
     }
@@ -205,9 +209,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     using super = BaseDataFacade;
     using IndexBlock = util::RangeTable<16, storage::Ownership::View>::BlockT;
     using RTreeLeaf = super::RTreeLeaf;
-    using SharedRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
+    using SharedRTree = super::SharedRTree;
     using SharedGeospatialQuery = GeospatialQuery<SharedRTree, BaseDataFacade>;
     using RTreeNode = SharedRTree::TreeNode;
+    using RTreeLeafNode = SharedRTree::LeafNode;
 
     std::string m_timestamp;
     extractor::ProfileProperties *m_profile_properties;
@@ -230,6 +235,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     util::vector_view<util::guidance::LaneTupleIdPair> m_lane_tupel_id_pairs;
 
     std::unique_ptr<SharedRTree> m_static_rtree;
+    util::SnappingGridView m_snapping_grid;
     std::unique_ptr<SharedGeospatialQuery> m_geospatial_query;
     boost::filesystem::path file_index_path;
 
@@ -250,117 +256,156 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
-    void InitializeProfilePropertiesPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeProfilePropertiesPointer()
     {
-        m_profile_properties = data_layout.GetBlockPtr<extractor::ProfileProperties>(
-            memory_block, storage::DataLayout::PROPERTIES);
+        m_profile_properties =
+            allocator->GetBlockPtr<extractor::ProfileProperties>(storage::DataLayout::PROPERTIES);
     }
 
-    void InitializeTimestampPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeTimestampPointer()
     {
-        auto timestamp_ptr =
-            data_layout.GetBlockPtr<char>(memory_block, storage::DataLayout::TIMESTAMP);
-        m_timestamp.resize(data_layout.GetBlockSize(storage::DataLayout::TIMESTAMP));
+        auto timestamp_ptr = allocator->GetBlockPtr<char>(storage::DataLayout::TIMESTAMP);
+        m_timestamp.resize(allocator->GetBlockSize(storage::DataLayout::TIMESTAMP));
         std::copy(timestamp_ptr,
-                  timestamp_ptr + data_layout.GetBlockSize(storage::DataLayout::TIMESTAMP),
+                  timestamp_ptr + allocator->GetBlockSize(storage::DataLayout::TIMESTAMP),
                   m_timestamp.begin());
     }
 
-    void InitializeChecksumPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeChecksumPointer()
     {
-        m_check_sum =
-            *data_layout.GetBlockPtr<unsigned>(memory_block, storage::DataLayout::HSGR_CHECKSUM);
+        m_check_sum = *allocator->GetBlockPtr<unsigned>(storage::DataLayout::HSGR_CHECKSUM);
         util::Log() << "set checksum: " << m_check_sum;
     }
 
-    void InitializeRTreePointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeRTreePointers()
     {
         BOOST_ASSERT_MSG(!m_coordinate_list.empty(), "coordinates must be loaded before r-tree");
 
         const auto file_index_ptr =
-            data_layout.GetBlockPtr<char>(memory_block, storage::DataLayout::FILE_INDEX_PATH);
+            allocator->GetBlockPtr<char>(storage::DataLayout::FILE_INDEX_PATH);
         file_index_path = boost::filesystem::path(file_index_ptr);
-        if (!boost::filesystem::exists(file_index_path))
+
+        auto tree_ptr = allocator->GetBlockPtr<RTreeNode>(storage::DataLayout::R_SEARCH_TREE);
+        const auto num_leaves =
+            allocator->GetBlockEntries(storage::DataLayout::R_SEARCH_TREE_LEAVES);
+        if (num_leaves > 0)
         {
-            util::Log(logDEBUG) << "Leaf file name " << file_index_path.string();
-            throw util::exception("Could not load " + file_index_path.string() +
-                                  "Is any data loaded into shared memory?" + SOURCE_REF);
+            // the leaves were loaded with the dataset, the leaf file is not used
+            m_static_rtree.reset(new SharedRTree(
+                tree_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::R_SEARCH_TREE),
+                allocator->GetBlockPtr<RTreeLeafNode>(storage::DataLayout::R_SEARCH_TREE_LEAVES),
+                num_leaves,
+                m_coordinate_list));
+        }
+        else
+        {
+            if (!boost::filesystem::exists(file_index_path))
+            {
+                util::Log(logDEBUG) << "Leaf file name " << file_index_path.string();
+                throw util::exception("Could not load " + file_index_path.string() +
+                                      "Is any data loaded into shared memory?" + SOURCE_REF);
+            }
+
+            m_static_rtree.reset(
+                new SharedRTree(tree_ptr,
+                                allocator->GetBlockEntries(storage::DataLayout::R_SEARCH_TREE),
+                                file_index_path,
+                                m_coordinate_list));
         }
 
-        auto tree_ptr =
-            data_layout.GetBlockPtr<RTreeNode>(memory_block, storage::DataLayout::R_SEARCH_TREE);
-        m_static_rtree.reset(
-            new SharedRTree(tree_ptr,
-                            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
-                            file_index_path,
-                            m_coordinate_list));
-        m_geospatial_query.reset(
-            new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
-    }
-
-    void InitializeNodeInformationPointers(storage::DataLayout &data_layout, char *memory_block)
-    {
-        const auto coordinate_list_ptr = data_layout.GetBlockPtr<util::Coordinate>(
-            memory_block, storage::DataLayout::COORDINATE_LIST);
+        // datasets without a grid have empty blocks
+        const auto grid_cell_size_ptr =
+            allocator->GetBlockPtr<std::int32_t>(storage::DataLayout::SNAPPING_GRID_CELL_SIZE);
+        const auto grid_cell_size =
+            allocator->GetBlockEntries(storage::DataLayout::SNAPPING_GRID_CELL_SIZE) > 0
+                ? *grid_cell_size_ptr
+                : 0;
+        util::vector_view<std::uint64_t> grid_cells(
+            allocator->GetBlockPtr<std::uint64_t>(storage::DataLayout::SNAPPING_GRID_CELLS),
+            allocator->GetBlockEntries(storage::DataLayout::SNAPPING_GRID_CELLS));
+        util::vector_view<std::uint32_t> grid_cell_offsets(
+            allocator->GetBlockPtr<std::uint32_t>(storage::DataLayout::SNAPPING_GRID_CELL_OFFSETS),
+            allocator->GetBlockEntries(storage::DataLayout::SNAPPING_GRID_CELL_OFFSETS));
+        util::vector_view<std::uint32_t> grid_leaf_ids(
+            allocator->GetBlockPtr<std::uint32_t>(storage::DataLayout::SNAPPING_GRID_LEAF_IDS),
+            allocator->GetBlockEntries(storage::DataLayout::SNAPPING_GRID_LEAF_IDS));
+        m_snapping_grid = util::SnappingGridView{grid_cell_size,
+                                                 std::move(grid_cells),
+                                                 std::move(grid_cell_offsets),
+                                                 std::move(grid_leaf_ids)};
+
+        m_geospatial_query.reset(new SharedGeospatialQuery(
+            *m_static_rtree, m_coordinate_list, *this, &m_snapping_grid));
+    }
+
+    void InitializeNodeInformationPointers()
+    {
+        const auto coordinate_list_ptr =
+            allocator->GetBlockPtr<util::Coordinate>(storage::DataLayout::COORDINATE_LIST);
         m_coordinate_list.reset(coordinate_list_ptr,
-                                data_layout.num_entries[storage::DataLayout::COORDINATE_LIST]);
+                                allocator->GetBlockEntries(storage::DataLayout::COORDINATE_LIST));
 
         for (unsigned i = 0; i < m_coordinate_list.size(); ++i)
         {
             BOOST_ASSERT(GetCoordinateOfNode(i).IsValid());
         }
 
-        const auto osmnodeid_list_ptr = data_layout.GetBlockPtr<std::uint64_t>(
-            memory_block, storage::DataLayout::OSM_NODE_ID_LIST);
+        const auto osmnodeid_list_ptr =
+            allocator->GetBlockPtr<std::uint64_t>(storage::DataLayout::OSM_NODE_ID_LIST);
         m_osmnodeid_list.reset(osmnodeid_list_ptr,
-                               data_layout.num_entries[storage::DataLayout::OSM_NODE_ID_LIST]);
+                               allocator->GetBlockEntries(storage::DataLayout::OSM_NODE_ID_LIST));
         // We (ab)use the number of coordinates here because we know we have the same amount of ids
         m_osmnodeid_list.set_number_of_entries(
-            data_layout.num_entries[storage::DataLayout::COORDINATE_LIST]);
+            allocator->GetBlockEntries(storage::DataLayout::COORDINATE_LIST));
     }
 
-    void InitializeEdgeInformationPointers(storage::DataLayout &layout, char *memory_ptr)
+    void InitializeEdgeInformationPointers()
     {
         auto via_geometry_list_ptr =
-            layout.GetBlockPtr<GeometryID>(memory_ptr, storage::DataLayout::VIA_NODE_LIST);
+            allocator->GetBlockPtr<GeometryID>(storage::DataLayout::VIA_NODE_LIST);
         util::vector_view<GeometryID> geometry_ids(
-            via_geometry_list_ptr, layout.num_entries[storage::DataLayout::VIA_NODE_LIST]);
+            via_geometry_list_ptr, allocator->GetBlockEntries(storage::DataLayout::VIA_NODE_LIST));
 
         const auto travel_mode_list_ptr =
-            layout.GetBlockPtr<extractor::TravelMode>(memory_ptr, storage::DataLayout::TRAVEL_MODE);
+            allocator->GetBlockPtr<extractor::TravelMode>(storage::DataLayout::TRAVEL_MODE);
         util::vector_view<extractor::TravelMode> travel_modes(
-            travel_mode_list_ptr, layout.num_entries[storage::DataLayout::TRAVEL_MODE]);
+            travel_mode_list_ptr, allocator->GetBlockEntries(storage::DataLayout::TRAVEL_MODE));
 
         const auto lane_data_id_ptr =
-            layout.GetBlockPtr<LaneDataID>(memory_ptr, storage::DataLayout::LANE_DATA_ID);
+            allocator->GetBlockPtr<LaneDataID>(storage::DataLayout::LANE_DATA_ID);
         util::vector_view<LaneDataID> lane_data_ids(
-            lane_data_id_ptr, layout.num_entries[storage::DataLayout::LANE_DATA_ID]);
+            lane_data_id_ptr, allocator->GetBlockEntries(storage::DataLayout::LANE_DATA_ID));
 
         const auto turn_instruction_list_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnInstruction>(
-                memory_ptr, storage::DataLayout::TURN_INSTRUCTION);
+            allocator->GetBlockPtr<extractor::guidance::TurnInstruction>(
+                storage::DataLayout::TURN_INSTRUCTION);
         util::vector_view<extractor::guidance::TurnInstruction> turn_instructions(
-            turn_instruction_list_ptr, layout.num_entries[storage::DataLayout::TURN_INSTRUCTION]);
+            turn_instruction_list_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::TURN_INSTRUCTION));
 
         const auto name_id_list_ptr =
-            layout.GetBlockPtr<NameID>(memory_ptr, storage::DataLayout::NAME_ID_LIST);
-        util::vector_view<NameID> name_ids(name_id_list_ptr,
-                                           layout.num_entries[storage::DataLayout::NAME_ID_LIST]);
+            allocator->GetBlockPtr<NameID>(storage::DataLayout::NAME_ID_LIST);
+        util::vector_view<NameID> name_ids(
+            name_id_list_ptr, allocator->GetBlockEntries(storage::DataLayout::NAME_ID_LIST));
 
         const auto entry_class_id_list_ptr =
-            layout.GetBlockPtr<EntryClassID>(memory_ptr, storage::DataLayout::ENTRY_CLASSID);
+            allocator->GetBlockPtr<EntryClassID>(storage::DataLayout::ENTRY_CLASSID);
         util::vector_view<EntryClassID> entry_class_ids(
-            entry_class_id_list_ptr, layout.num_entries[storage::DataLayout::ENTRY_CLASSID]);
+            entry_class_id_list_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::ENTRY_CLASSID));
 
-        const auto pre_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing>(
-            memory_ptr, storage::DataLayout::PRE_TURN_BEARING);
+        const auto pre_turn_bearing_ptr = allocator->GetBlockPtr<util::guidance::TurnBearing>(
+            storage::DataLayout::PRE_TURN_BEARING);
         util::vector_view<util::guidance::TurnBearing> pre_turn_bearings(
-            pre_turn_bearing_ptr, layout.num_entries[storage::DataLayout::PRE_TURN_BEARING]);
+            pre_turn_bearing_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::PRE_TURN_BEARING));
 
-        const auto post_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing>(
-            memory_ptr, storage::DataLayout::POST_TURN_BEARING);
+        const auto post_turn_bearing_ptr = allocator->GetBlockPtr<util::guidance::TurnBearing>(
+            storage::DataLayout::POST_TURN_BEARING);
         util::vector_view<util::guidance::TurnBearing> post_turn_bearings(
-            post_turn_bearing_ptr, layout.num_entries[storage::DataLayout::POST_TURN_BEARING]);
+            post_turn_bearing_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::POST_TURN_BEARING));
 
         turn_data = extractor::TurnDataView(std::move(geometry_ids),
                                             std::move(name_ids),
@@ -372,93 +417,99 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                             std::move(post_turn_bearings));
     }
 
-    void InitializeNamePointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeNamePointers()
     {
-        auto name_data_ptr =
-            data_layout.GetBlockPtr<char>(memory_block, storage::DataLayout::NAME_CHAR_DATA);
-        const auto name_data_size = data_layout.num_entries[storage::DataLayout::NAME_CHAR_DATA];
+        auto name_data_ptr = allocator->GetBlockPtr<char>(storage::DataLayout::NAME_CHAR_DATA);
+        const auto name_data_size = allocator->GetBlockEntries(storage::DataLayout::NAME_CHAR_DATA);
         m_name_table.reset(name_data_ptr, name_data_ptr + name_data_size);
     }
 
-    void InitializeTurnLaneDescriptionsPointers(storage::DataLayout &data_layout,
-                                                char *memory_block)
+    void InitializeTurnLaneDescriptionsPointers()
     {
-        auto offsets_ptr = data_layout.GetBlockPtr<std::uint32_t>(
-            memory_block, storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
+        auto offsets_ptr =
+            allocator->GetBlockPtr<std::uint32_t>(storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
         util::vector_view<std::uint32_t> offsets(
-            offsets_ptr, data_layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_OFFSETS]);
+            offsets_ptr, allocator->GetBlockEntries(storage::DataLayout::LANE_DESCRIPTION_OFFSETS));
         m_lane_description_offsets = std::move(offsets);
 
-        auto masks_ptr = data_layout.GetBlockPtr<extractor::guidance::TurnLaneType::Mask>(
-            memory_block, storage::DataLayout::LANE_DESCRIPTION_MASKS);
+        auto masks_ptr = allocator->GetBlockPtr<extractor::guidance::TurnLaneType::Mask>(
+            storage::DataLayout::LANE_DESCRIPTION_MASKS);
 
         util::vector_view<extractor::guidance::TurnLaneType::Mask> masks(
-            masks_ptr, data_layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_MASKS]);
+            masks_ptr, allocator->GetBlockEntries(storage::DataLayout::LANE_DESCRIPTION_MASKS));
         m_lane_description_masks = std::move(masks);
 
-        const auto lane_tupel_id_pair_ptr =
-            data_layout.GetBlockPtr<util::guidance::LaneTupleIdPair>(
-                memory_block, storage::DataLayout::TURN_LANE_DATA);
+        const auto lane_tupel_id_pair_ptr = allocator->GetBlockPtr<util::guidance::LaneTupleIdPair>(
+            storage::DataLayout::TURN_LANE_DATA);
         util::vector_view<util::guidance::LaneTupleIdPair> lane_tupel_id_pair(
-            lane_tupel_id_pair_ptr, data_layout.num_entries[storage::DataLayout::TURN_LANE_DATA]);
+            lane_tupel_id_pair_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::TURN_LANE_DATA));
         m_lane_tupel_id_pairs = std::move(lane_tupel_id_pair);
     }
 
-    void InitializeTurnPenalties(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeTurnPenalties()
     {
-        auto turn_weight_penalties_ptr = data_layout.GetBlockPtr<TurnPenalty>(
-            memory_block, storage::DataLayout::TURN_WEIGHT_PENALTIES);
+        auto turn_weight_penalties_ptr =
+            allocator->GetBlockPtr<TurnPenalty>(storage::DataLayout::TURN_WEIGHT_PENALTIES);
         m_turn_weight_penalties = util::vector_view<TurnPenalty>(
             turn_weight_penalties_ptr,
-            data_layout.num_entries[storage::DataLayout::TURN_WEIGHT_PENALTIES]);
-        auto turn_duration_penalties_ptr = data_layout.GetBlockPtr<TurnPenalty>(
-            memory_block, storage::DataLayout::TURN_DURATION_PENALTIES);
+            allocator->GetBlockEntries(storage::DataLayout::TURN_WEIGHT_PENALTIES));
+        auto turn_duration_penalties_ptr =
+            allocator->GetBlockPtr<TurnPenalty>(storage::DataLayout::TURN_DURATION_PENALTIES);
         m_turn_duration_penalties = util::vector_view<TurnPenalty>(
             turn_duration_penalties_ptr,
-            data_layout.num_entries[storage::DataLayout::TURN_DURATION_PENALTIES]);
+            allocator->GetBlockEntries(storage::DataLayout::TURN_DURATION_PENALTIES));
     }
 
-    void InitializeGeometryPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGeometryPointers()
     {
         auto geometries_index_ptr =
-            data_layout.GetBlockPtr<unsigned>(memory_block, storage::DataLayout::GEOMETRIES_INDEX);
+            allocator->GetBlockPtr<unsigned>(storage::DataLayout::GEOMETRIES_INDEX);
         util::vector_view<unsigned> geometry_begin_indices(
-            geometries_index_ptr, data_layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
+            geometries_index_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_INDEX));
 
-        auto geometries_node_list_ptr = data_layout.GetBlockPtr<NodeID>(
-            memory_block, storage::DataLayout::GEOMETRIES_NODE_LIST);
+        auto geometries_node_list_ptr =
+            allocator->GetBlockPtr<NodeID>(storage::DataLayout::GEOMETRIES_NODE_LIST);
         util::vector_view<NodeID> geometry_node_list(
             geometries_node_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST]);
-
-        auto geometries_fwd_weight_list_ptr = data_layout.GetBlockPtr<SegmentWeight>(
-            memory_block, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
-        util::vector_view<SegmentWeight> geometry_fwd_weight_list(
-            geometries_fwd_weight_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
-
-        auto geometries_rev_weight_list_ptr = data_layout.GetBlockPtr<SegmentWeight>(
-            memory_block, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
-        util::vector_view<SegmentWeight> geometry_rev_weight_list(
-            geometries_rev_weight_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
-
-        auto geometries_fwd_duration_list_ptr = data_layout.GetBlockPtr<SegmentDuration>(
-            memory_block, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
-        util::vector_view<SegmentDuration> geometry_fwd_duration_list(
-            geometries_fwd_duration_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]);
-
-        auto geometries_rev_duration_list_ptr = data_layout.GetBlockPtr<SegmentDuration>(
-            memory_block, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
-        util::vector_view<SegmentDuration> geometry_rev_duration_list(
-            geometries_rev_duration_list_ptr,
-            data_layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]);
-
-        auto datasources_list_ptr = data_layout.GetBlockPtr<DatasourceID>(
-            memory_block, storage::DataLayout::DATASOURCES_LIST);
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_NODE_LIST));
+
+        // the packed vectors hold one entry per node of the geometries
+        const auto number_of_segments =
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_NODE_LIST);
+
+        extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list;
+        geometry_fwd_weight_list.reset(
+            allocator->GetBlockPtr<std::uint64_t>(storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST),
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST));
+        geometry_fwd_weight_list.set_number_of_entries(number_of_segments);
+
+        extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list;
+        geometry_rev_weight_list.reset(
+            allocator->GetBlockPtr<std::uint64_t>(storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST),
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST));
+        geometry_rev_weight_list.set_number_of_entries(number_of_segments);
+
+        extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list;
+        geometry_fwd_duration_list.reset(
+            allocator->GetBlockPtr<std::uint64_t>(
+                storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST),
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST));
+        geometry_fwd_duration_list.set_number_of_entries(number_of_segments);
+
+        extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list;
+        geometry_rev_duration_list.reset(
+            allocator->GetBlockPtr<std::uint64_t>(
+                storage::DataLayout::GEOMETRIES_REV_DURATION_LIST),
+            allocator->GetBlockEntries(storage::DataLayout::GEOMETRIES_REV_DURATION_LIST));
+        geometry_rev_duration_list.set_number_of_entries(number_of_segments);
+
+        auto datasources_list_ptr =
+            allocator->GetBlockPtr<DatasourceID>(storage::DataLayout::DATASOURCES_LIST);
         util::vector_view<DatasourceID> datasources_list(
-            datasources_list_ptr, data_layout.num_entries[storage::DataLayout::DATASOURCES_LIST]);
+            datasources_list_ptr,
+            allocator->GetBlockEntries(storage::DataLayout::DATASOURCES_LIST));
 
         segment_data = extractor::SegmentDataView{std::move(geometry_begin_indices),
                                                   std::move(geometry_node_list),
@@ -468,56 +519,54 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                                   std::move(geometry_rev_duration_list),
                                                   std::move(datasources_list)};
 
-        m_datasources = data_layout.GetBlockPtr<extractor::Datasources>(
-            memory_block, storage::DataLayout::DATASOURCES_NAMES);
+        m_datasources =
+            allocator->GetBlockPtr<extractor::Datasources>(storage::DataLayout::DATASOURCES_NAMES);
     }
 
-    void InitializeIntersectionClassPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeIntersectionClassPointers()
     {
-        auto bearing_class_id_ptr = data_layout.GetBlockPtr<BearingClassID>(
-            memory_block, storage::DataLayout::BEARING_CLASSID);
+        auto bearing_class_id_ptr =
+            allocator->GetBlockPtr<BearingClassID>(storage::DataLayout::BEARING_CLASSID);
         typename util::vector_view<BearingClassID> bearing_class_id_table(
-            bearing_class_id_ptr, data_layout.num_entries[storage::DataLayout::BEARING_CLASSID]);
+            bearing_class_id_ptr, allocator->GetBlockEntries(storage::DataLayout::BEARING_CLASSID));
         m_bearing_class_id_table = std::move(bearing_class_id_table);
 
-        auto bearing_class_ptr = data_layout.GetBlockPtr<DiscreteBearing>(
-            memory_block, storage::DataLayout::BEARING_VALUES);
+        auto bearing_class_ptr =
+            allocator->GetBlockPtr<DiscreteBearing>(storage::DataLayout::BEARING_VALUES);
         typename util::vector_view<DiscreteBearing> bearing_class_table(
-            bearing_class_ptr, data_layout.num_entries[storage::DataLayout::BEARING_VALUES]);
+            bearing_class_ptr, allocator->GetBlockEntries(storage::DataLayout::BEARING_VALUES));
         m_bearing_values_table = std::move(bearing_class_table);
 
-        auto offsets_ptr =
-            data_layout.GetBlockPtr<unsigned>(memory_block, storage::DataLayout::BEARING_OFFSETS);
-        auto blocks_ptr =
-            data_layout.GetBlockPtr<IndexBlock>(memory_block, storage::DataLayout::BEARING_BLOCKS);
+        auto offsets_ptr = allocator->GetBlockPtr<unsigned>(storage::DataLayout::BEARING_OFFSETS);
+        auto blocks_ptr = allocator->GetBlockPtr<IndexBlock>(storage::DataLayout::BEARING_BLOCKS);
         util::vector_view<unsigned> bearing_offsets(
-            offsets_ptr, data_layout.num_entries[storage::DataLayout::BEARING_OFFSETS]);
+            offsets_ptr, allocator->GetBlockEntries(storage::DataLayout::BEARING_OFFSETS));
         util::vector_view<IndexBlock> bearing_blocks(
-            blocks_ptr, data_layout.num_entries[storage::DataLayout::BEARING_BLOCKS]);
+            blocks_ptr, allocator->GetBlockEntries(storage::DataLayout::BEARING_BLOCKS));
 
         m_bearing_ranges_table = std::make_unique<util::RangeTable<16, storage::Ownership::View>>(
             bearing_offsets, bearing_blocks, static_cast<unsigned>(m_bearing_values_table.size()));
 
-        auto entry_class_ptr = data_layout.GetBlockPtr<util::guidance::EntryClass>(
-            memory_block, storage::DataLayout::ENTRY_CLASS);
+        auto entry_class_ptr =
+            allocator->GetBlockPtr<util::guidance::EntryClass>(storage::DataLayout::ENTRY_CLASS);
         typename util::vector_view<util::guidance::EntryClass> entry_class_table(
-            entry_class_ptr, data_layout.num_entries[storage::DataLayout::ENTRY_CLASS]);
+            entry_class_ptr, allocator->GetBlockEntries(storage::DataLayout::ENTRY_CLASS));
         m_entry_class_table = std::move(entry_class_table);
     }
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers()
     {
-        InitializeChecksumPointer(data_layout, memory_block);
-        InitializeNodeInformationPointers(data_layout, memory_block);
-        InitializeEdgeInformationPointers(data_layout, memory_block);
-        InitializeTurnPenalties(data_layout, memory_block);
-        InitializeGeometryPointers(data_layout, memory_block);
-        InitializeTimestampPointer(data_layout, memory_block);
-        InitializeNamePointers(data_layout, memory_block);
-        InitializeTurnLaneDescriptionsPointers(data_layout, memory_block);
-        InitializeProfilePropertiesPointer(data_layout, memory_block);
-        InitializeRTreePointers(data_layout, memory_block);
-        InitializeIntersectionClassPointers(data_layout, memory_block);
+        InitializeChecksumPointer();
+        InitializeNodeInformationPointers();
+        InitializeEdgeInformationPointers();
+        InitializeTurnPenalties();
+        InitializeGeometryPointers();
+        InitializeTimestampPointer();
+        InitializeNamePointers();
+        InitializeTurnLaneDescriptionsPointers();
+        InitializeProfilePropertiesPointer();
+        InitializeRTreePointers();
+        InitializeIntersectionClassPointers();
     }
 
   public:
@@ -526,92 +575,97 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers();
     }
 
+    // memory of the dataset, used to report the size and usage of the blocks
+    ContiguousBlockAllocator &GetAllocator() const { return *allocator; }
+
     // node and edge information access
     util::Coordinate GetCoordinateOfNode(const NodeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::COORDINATE_LIST);
         return m_coordinate_list[id];
     }
 
     OSMNodeID GetOSMNodeIDOfNode(const NodeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::OSM_NODE_ID_LIST);
         return m_osmnodeid_list.at(id);
     }
 
-    virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    virtual NodeForwardRange GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
-
-        auto range = segment_data.GetForwardGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_NODE_LIST);
+        return segment_data.GetForwardGeometry(id);
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    virtual NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_NODE_LIST);
+        return segment_data.GetReverseGeometry(id);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual DurationForwardRange
     GetUncompressedForwardDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
+        return segment_data.GetForwardDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual DurationReverseRange
     GetUncompressedReverseDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
+        return segment_data.GetReverseDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardWeights(const EdgeID id) const override final
+    virtual WeightForwardRange GetUncompressedForwardWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+        return segment_data.GetForwardWeights(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseWeights(const EdgeID id) const override final
+    virtual WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+        return segment_data.GetReverseWeights(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
+    virtual DatasourceForwardRange
     GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::DATASOURCES_LIST);
+        return segment_data.GetForwardDatasources(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
+    virtual DatasourceReverseRange
     GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        allocator->RecordAccess(storage::DataLayout::DATASOURCES_LIST);
+        return segment_data.GetReverseDatasources(id);
     }
 
     virtual GeometryID GetGeometryIndexForEdgeID(const EdgeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::VIA_NODE_LIST);
         return turn_data.GetGeometryID(id);
     }
 
     virtual TurnPenalty GetWeightPenaltyForEdgeID(const unsigned id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::TURN_WEIGHT_PENALTIES);
         BOOST_ASSERT(m_turn_weight_penalties.size() > id);
         return m_turn_weight_penalties[id];
     }
 
     virtual TurnPenalty GetDurationPenaltyForEdgeID(const unsigned id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::TURN_DURATION_PENALTIES);
         BOOST_ASSERT(m_turn_duration_penalties.size() > id);
         return m_turn_duration_penalties[id];
     }
@@ -619,11 +673,13 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     extractor::guidance::TurnInstruction
     GetTurnInstructionForEdgeID(const EdgeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::TURN_INSTRUCTION);
         return turn_data.GetTurnInstruction(id);
     }
 
     extractor::TravelMode GetTravelModeForEdgeID(const EdgeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::TRAVEL_MODE);
         return turn_data.GetTravelMode(id);
     }
 
@@ -631,16 +687,31 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                          const util::Coordinate north_east) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
         const util::RectangleInt2D bbox{
             south_west.lon, north_east.lon, south_west.lat, north_east.lat};
         return m_geospatial_query->Search(bbox);
     }
 
+    std::vector<RTreeLeaf>
+    GetEdgesInBox(const util::Coordinate south_west,
+                  const util::Coordinate north_east,
+                  const std::vector<RTreeLeaf> &candidates) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+        // only the coordinates of the candidates are read, the tree is not visited
+        allocator->RecordAccess(storage::DataLayout::COORDINATE_LIST);
+        const util::RectangleInt2D bbox{
+            south_west.lon, north_east.lon, south_west.lat, north_east.lat};
+        return m_geospatial_query->Search(bbox, candidates);
+    }
+
     std::vector<PhantomNodeWithDistance>
     NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
                                const float max_distance) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodesInRange(input_coordinate, max_distance);
     }
@@ -652,6 +723,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                const int bearing_range) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodesInRange(
             input_coordinate, max_distance, bearing, bearing_range);
@@ -662,6 +734,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                         const unsigned max_results) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodes(input_coordinate, max_results);
     }
@@ -672,6 +745,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                         const double max_distance) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodes(input_coordinate, max_results, max_distance);
     }
@@ -683,6 +757,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                         const int bearing_range) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodes(
             input_coordinate, max_results, bearing, bearing_range);
@@ -696,6 +771,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                         const int bearing_range) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodes(
             input_coordinate, max_results, max_distance, bearing, bearing_range);
@@ -705,6 +781,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         const util::Coordinate input_coordinate) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
             input_coordinate);
@@ -714,6 +791,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         const util::Coordinate input_coordinate, const double max_distance) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
             input_coordinate, max_distance);
@@ -726,6 +804,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                                       const int bearing_range) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
             input_coordinate, max_distance, bearing, bearing_range);
@@ -737,35 +816,70 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                                                       const int bearing_range) const override final
     {
         BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
 
         return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
+
+        return m_geospatial_query->NearestPhantomNodesInRange(queries);
+    }
+
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<PhantomNodeQuery> &queries,
+                        const unsigned max_results) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
+
+        return m_geospatial_query->NearestPhantomNodes(queries, max_results);
+    }
+
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+        allocator->RecordAccess(storage::DataLayout::R_SEARCH_TREE);
+
+        return m_geospatial_query->NearestPhantomNodeWithAlternativeFromBigComponent(queries);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     NameID GetNameIndexFromEdgeID(const EdgeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::NAME_ID_LIST);
         return turn_data.GetNameID(id);
     }
 
     StringView GetNameForID(const NameID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::NAME_CHAR_DATA);
         return m_name_table.GetNameForID(id);
     }
 
     StringView GetRefForID(const NameID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::NAME_CHAR_DATA);
         return m_name_table.GetRefForID(id);
     }
 
     StringView GetPronunciationForID(const NameID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::NAME_CHAR_DATA);
         return m_name_table.GetPronunciationForID(id);
     }
 
     StringView GetDestinationsForID(const NameID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::NAME_CHAR_DATA);
         return m_name_table.GetDestinationsForID(id);
     }
 
@@ -800,6 +914,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     BearingClassID GetBearingClassID(const NodeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::BEARING_CLASSID);
         return m_bearing_class_id_table.at(id);
     }
 
@@ -818,6 +933,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     EntryClassID GetEntryClassID(const EdgeID eid) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::ENTRY_CLASSID);
         return turn_data.GetEntryClassID(eid);
     }
 
@@ -839,6 +955,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::LANE_DATA_ID);
         BOOST_ASSERT(HasLaneData(id));
         return m_lane_tupel_id_pairs.at(turn_data.GetLaneDataID(id));
     }
@@ -891,70 +1008,70 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     // MLD data
     partition::MultiLevelPartitionView mld_partition;
     partition::CellStorageView mld_cell_storage;
+    customizer::OverlayGraphView mld_overlay_graph;
     using QueryGraph = customizer::MultiLevelEdgeBasedGraphView;
     using GraphNode = QueryGraph::NodeArrayEntry;
     using GraphEdge = QueryGraph::EdgeArrayEntry;
 
     QueryGraph query_graph;
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers()
     {
-        InitializeMLDDataPointers(data_layout, memory_block);
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializeMLDDataPointers();
+        InitializeGraphPointer();
     }
 
-    void InitializeMLDDataPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeMLDDataPointers()
     {
-        if (data_layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0)
+        if (allocator->GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0)
         {
-            BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
-            BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
+            BOOST_ASSERT(allocator->GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
+            BOOST_ASSERT(allocator->GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
 
-            auto level_data =
-                data_layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData>(
-                    memory_block, storage::DataLayout::MLD_LEVEL_DATA);
+            auto level_data = allocator->GetBlockPtr<partition::MultiLevelPartitionView::LevelData>(
+                storage::DataLayout::MLD_LEVEL_DATA);
 
-            auto mld_partition_ptr = data_layout.GetBlockPtr<PartitionID>(
-                memory_block, storage::DataLayout::MLD_PARTITION);
+            auto mld_partition_ptr =
+                allocator->GetBlockPtr<PartitionID>(storage::DataLayout::MLD_PARTITION);
             auto partition_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_PARTITION);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_PARTITION);
             util::vector_view<PartitionID> partition(mld_partition_ptr, partition_entries_count);
 
-            auto mld_chilren_ptr = data_layout.GetBlockPtr<CellID>(
-                memory_block, storage::DataLayout::MLD_CELL_TO_CHILDREN);
+            auto mld_chilren_ptr =
+                allocator->GetBlockPtr<CellID>(storage::DataLayout::MLD_CELL_TO_CHILDREN);
             auto children_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_TO_CHILDREN);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_CELL_TO_CHILDREN);
             util::vector_view<CellID> cell_to_children(mld_chilren_ptr, children_entries_count);
 
             mld_partition =
                 partition::MultiLevelPartitionView{level_data, partition, cell_to_children};
         }
 
-        if (data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_WEIGHTS) > 0)
+        if (allocator->GetBlockSize(storage::DataLayout::MLD_CELL_WEIGHTS) > 0)
         {
-            BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
-            BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
-
-            auto mld_cell_weights_ptr = data_layout.GetBlockPtr<EdgeWeight>(
-                memory_block, storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto mld_source_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
-                memory_block, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
-            auto mld_destination_boundary_ptr = data_layout.GetBlockPtr<NodeID>(
-                memory_block, storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto mld_cells_ptr = data_layout.GetBlockPtr<partition::CellStorageView::CellData>(
-                memory_block, storage::DataLayout::MLD_CELLS);
-            auto mld_cell_level_offsets_ptr = data_layout.GetBlockPtr<std::uint64_t>(
-                memory_block, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+            BOOST_ASSERT(allocator->GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
+            BOOST_ASSERT(allocator->GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
+
+            auto mld_cell_weights_ptr =
+                allocator->GetBlockPtr<EdgeWeight>(storage::DataLayout::MLD_CELL_WEIGHTS);
+            auto mld_source_boundary_ptr =
+                allocator->GetBlockPtr<NodeID>(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+            auto mld_destination_boundary_ptr =
+                allocator->GetBlockPtr<NodeID>(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+            auto mld_cells_ptr = allocator->GetBlockPtr<partition::CellStorageView::CellData>(
+                storage::DataLayout::MLD_CELLS);
+            auto mld_cell_level_offsets_ptr =
+                allocator->GetBlockPtr<std::uint64_t>(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
             auto weight_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
             auto source_boundary_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
             auto destination_boundary_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto cells_entries_counts = data_layout.GetBlockEntries(storage::DataLayout::MLD_CELLS);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+            auto cells_entries_counts = allocator->GetBlockEntries(storage::DataLayout::MLD_CELLS);
             auto cell_level_offsets_entries_count =
-                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+                allocator->GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
 
             util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
             util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
@@ -972,25 +1089,69 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                                                           std::move(cells),
                                                           std::move(level_offsets)};
         }
+
+        if (allocator->GetBlockSize(storage::DataLayout::MLD_OVERLAY_CELL_OFFSETS) > 0)
+        {
+            using OverlayGraphView = customizer::OverlayGraphView;
+
+            auto level_offsets_ptr = allocator->GetBlockPtr<std::uint64_t>(
+                storage::DataLayout::MLD_OVERLAY_LEVEL_OFFSETS);
+            auto cell_offsets_ptr = allocator->GetBlockPtr<OverlayGraphView::CellOffsets>(
+                storage::DataLayout::MLD_OVERLAY_CELL_OFFSETS);
+            auto forward_nodes_ptr = allocator->GetBlockPtr<OverlayGraphView::OverlayNode>(
+                storage::DataLayout::MLD_OVERLAY_FWD_NODES);
+            auto forward_arcs_ptr = allocator->GetBlockPtr<OverlayGraphView::OverlayArc>(
+                storage::DataLayout::MLD_OVERLAY_FWD_ARCS);
+            auto backward_nodes_ptr = allocator->GetBlockPtr<OverlayGraphView::OverlayNode>(
+                storage::DataLayout::MLD_OVERLAY_BWD_NODES);
+            auto backward_arcs_ptr = allocator->GetBlockPtr<OverlayGraphView::OverlayArc>(
+                storage::DataLayout::MLD_OVERLAY_BWD_ARCS);
+
+            util::vector_view<std::uint64_t> level_offsets(
+                level_offsets_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_LEVEL_OFFSETS));
+            util::vector_view<OverlayGraphView::CellOffsets> cell_offsets(
+                cell_offsets_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_CELL_OFFSETS));
+            util::vector_view<OverlayGraphView::OverlayNode> forward_nodes(
+                forward_nodes_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_FWD_NODES));
+            util::vector_view<OverlayGraphView::OverlayArc> forward_arcs(
+                forward_arcs_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_FWD_ARCS));
+            util::vector_view<OverlayGraphView::OverlayNode> backward_nodes(
+                backward_nodes_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_BWD_NODES));
+            util::vector_view<OverlayGraphView::OverlayArc> backward_arcs(
+                backward_arcs_ptr,
+                allocator->GetBlockEntries(storage::DataLayout::MLD_OVERLAY_BWD_ARCS));
+
+            mld_overlay_graph = OverlayGraphView{std::move(level_offsets),
+                                                 std::move(cell_offsets),
+                                                 std::move(forward_nodes),
+                                                 std::move(forward_arcs),
+                                                 std::move(backward_nodes),
+                                                 std::move(backward_arcs)};
+        }
     }
-    void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGraphPointer()
     {
-        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
-            memory_block, storage::DataLayout::MLD_GRAPH_NODE_LIST);
+        auto graph_nodes_ptr =
+            allocator->GetBlockPtr<GraphNode>(storage::DataLayout::MLD_GRAPH_NODE_LIST);
 
-        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(
-            memory_block, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
+        auto graph_edges_ptr =
+            allocator->GetBlockPtr<GraphEdge>(storage::DataLayout::MLD_GRAPH_EDGE_LIST);
 
-        auto graph_node_to_offset_ptr = data_layout.GetBlockPtr<QueryGraph::EdgeOffset>(
-            memory_block, storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
+        auto graph_node_to_offset_ptr = allocator->GetBlockPtr<QueryGraph::EdgeOffset>(
+            storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
 
         util::vector_view<GraphNode> node_list(
-            graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
+            graph_nodes_ptr, allocator->GetBlockEntries(storage::DataLayout::MLD_GRAPH_NODE_LIST));
         util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
+            graph_edges_ptr, allocator->GetBlockEntries(storage::DataLayout::MLD_GRAPH_EDGE_LIST));
         util::vector_view<QueryGraph::EdgeOffset> node_to_offset(
             graph_node_to_offset_ptr,
-            data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
+            allocator->GetBlockEntries(storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET));
 
         query_graph =
             QueryGraph(std::move(node_list), std::move(edge_list), std::move(node_to_offset));
@@ -1004,7 +1165,7 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers();
     }
 
     const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
@@ -1014,6 +1175,11 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     const partition::CellStorageView &GetCellStorage() const override { return mld_cell_storage; }
 
+    const customizer::OverlayGraphView &GetOverlayGraph() const override
+    {
+        return mld_overlay_graph;
+    }
+
     // search graph access
     unsigned GetNumberOfNodes() const override final { return query_graph.GetNumberOfNodes(); }
 
@@ -1028,6 +1194,7 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     const EdgeData &GetEdgeData(const EdgeID e) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::MLD_GRAPH_EDGE_LIST);
         return query_graph.GetEdgeData(e);
     }
 
@@ -1037,11 +1204,13 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     EdgeRange GetAdjacentEdgeRange(const NodeID node) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::MLD_GRAPH_NODE_LIST);
         return query_graph.GetAdjacentEdgeRange(node);
     }
 
     EdgeRange GetBorderEdgeRange(const LevelID level, const NodeID node) const override final
     {
+        allocator->RecordAccess(storage::DataLayout::MLD_GRAPH_NODE_LIST);
         return query_graph.GetBorderEdgeRange(level, node);
     }
 
@@ -9,6 +9,7 @@
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/original_edge_data.hpp"
+#include "extractor/segment_data_container.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
@@ -17,11 +18,15 @@
 #include "util/guidance/turn_lanes.hpp"
 #include "util/integer_range.hpp"
 #include "util/string_util.hpp"
+#include "util/static_rtree.hpp"
 #include "util/string_view.hpp"
 #include "util/typedefs.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/iterator_range.hpp>
+
 #include <cstddef>
 
 #include <string>
@@ -41,6 +46,29 @@ class BaseDataFacade
 {
   public:
     using RTreeLeaf = extractor::EdgeBasedNode;
+    // The rtree as osrm-extract writes it and osrm-datastore loads it, its leaves store the
+    // segment coordinates
+    using SharedRTree = util::StaticRTree<RTreeLeaf,
+                                          storage::Ownership::View,
+                                          128,
+                                          4096,
+                                          util::LeafLayout::ObjectsAndCoordinates>;
+
+    // Read-only ranges over the compressed geometry in the facade memory, reverse ranges
+    // iterate the same memory back to front.
+    using NodeForwardRange = boost::iterator_range<
+        extractor::SegmentDataView::SegmentNodeVector::const_iterator>;
+    using NodeReverseRange = boost::reversed_range<const NodeForwardRange>;
+    using WeightForwardRange = boost::iterator_range<
+        extractor::SegmentDataView::SegmentWeightVector::const_iterator>;
+    using WeightReverseRange = boost::reversed_range<const WeightForwardRange>;
+    using DurationForwardRange = boost::iterator_range<
+        extractor::SegmentDataView::SegmentDurationVector::const_iterator>;
+    using DurationReverseRange = boost::reversed_range<const DurationForwardRange>;
+    using DatasourceForwardRange = boost::iterator_range<
+        extractor::SegmentDataView::SegmentDatasourceVector::const_iterator>;
+    using DatasourceReverseRange = boost::reversed_range<const DatasourceForwardRange>;
+
     BaseDataFacade() {}
     virtual ~BaseDataFacade() {}
 
@@ -53,9 +81,9 @@ class BaseDataFacade
 
     virtual GeometryID GetGeometryIndexForEdgeID(const EdgeID id) const = 0;
 
-    virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const = 0;
+    virtual NodeForwardRange GetUncompressedForwardGeometry(const EdgeID id) const = 0;
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const = 0;
+    virtual NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const = 0;
 
     virtual TurnPenalty GetWeightPenaltyForEdgeID(const unsigned id) const = 0;
 
@@ -63,18 +91,18 @@ class BaseDataFacade
 
     // Gets the weight values for each segment in an uncompressed geometry.
     // Should always be 1 shorter than GetUncompressedGeometry
-    virtual std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID id) const = 0;
-    virtual std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const = 0;
+    virtual WeightForwardRange GetUncompressedForwardWeights(const EdgeID id) const = 0;
+    virtual WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const = 0;
 
     // Gets the duration values for each segment in an uncompressed geometry.
     // Should always be 1 shorter than GetUncompressedGeometry
-    virtual std::vector<EdgeWeight> GetUncompressedForwardDurations(const EdgeID id) const = 0;
-    virtual std::vector<EdgeWeight> GetUncompressedReverseDurations(const EdgeID id) const = 0;
+    virtual DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const = 0;
+    virtual DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const = 0;
 
     // Returns the data source ids that were used to supply the edge
-    // weights.  Will return an empty array when only the base profile is used.
-    virtual std::vector<DatasourceID> GetUncompressedForwardDatasources(const EdgeID id) const = 0;
-    virtual std::vector<DatasourceID> GetUncompressedReverseDatasources(const EdgeID id) const = 0;
+    // weights.  Will return an empty range when only the base profile is used.
+    virtual DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID id) const = 0;
+    virtual DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const = 0;
 
     // Gets the name of a datasource
     virtual StringView GetDatasourceName(const DatasourceID id) const = 0;
@@ -87,6 +115,13 @@ class BaseDataFacade
     virtual std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate south_west,
                                                  const util::Coordinate north_east) const = 0;
 
+    // Same edges as GetEdgesInBox, taken from the result of a call for a box that contains
+    // this one instead of the rtree
+    virtual std::vector<RTreeLeaf>
+    GetEdgesInBox(const util::Coordinate south_west,
+                  const util::Coordinate north_east,
+                  const std::vector<RTreeLeaf> &candidates) const = 0;
+
     virtual std::vector<PhantomNodeWithDistance>
     NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
                                const float max_distance,
@@ -130,6 +165,16 @@ class BaseDataFacade
                                                       const int bearing,
                                                       const int bearing_range) const = 0;
 
+    // Snap all coordinates of a request at once, the results are in the order of the queries
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const = 0;
+    virtual std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<PhantomNodeQuery> &queries,
+                        const unsigned max_results) const = 0;
+    virtual std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const = 0;
+
     virtual bool HasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const = 0;
     virtual extractor::guidance::TurnLaneDescription
@@ -0,0 +1,51 @@
+#ifndef OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+
+#include "storage/storage_config.hpp"
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator memory-maps a dataset image file instead of loading
+ * the data into process memory. The image has the same structure and
+ * layout as the shared memory block, prefixed by a header holding the
+ * DataLayout. It is created from the .osrm.* files on first use and
+ * rebuilt if the size, modification time, change time or inode of any of
+ * them differs from when the image was written, or if the layout of their
+ * headers changed.
+ *
+ * Pages are loaded on demand and shared through the OS page cache between
+ * all processes mapping the same image. With prefetch the kernel is asked
+ * to read the whole image ahead, otherwise access is expected to be random.
+ */
+class MMapMemoryAllocator : public ContiguousBlockAllocator
+{
+  public:
+    MMapMemoryAllocator(const storage::StorageConfig &config, const bool prefetch);
+    ~MMapMemoryAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+
+  private:
+    boost::interprocess::file_mapping mapped_file;
+    boost::interprocess::mapped_region mapped_image;
+    storage::DataLayout *layout;
+    char *memory;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
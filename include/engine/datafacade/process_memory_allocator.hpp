@@ -19,11 +19,14 @@ namespace datafacade
  * shared memory.
  * This class holds a unique_ptr to the memory block, so it
  * is auto-freed upon destruction.
+ * With load_rtree_leaves the rtree leaves are copied into the block as well,
+ * instead of being memory mapped from the leaf file.
  */
 class ProcessMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit ProcessMemoryAllocator(const storage::StorageConfig &config);
+    explicit ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                    const bool load_rtree_leaves = false);
     ~ProcessMemoryAllocator() override final;
 
     // interface to give access to the datafacades
@@ -19,6 +19,9 @@ namespace datafacade
 * This allocator uses an IPC shared memory block as the data location.
 * Many SharedMemoryDataFacade objects can be created that point to the same shared
 * memory block.
+*
+* Regions written by an incremental update only contain some of the blocks, the
+* remaining blocks are served from the attached base region.
 */
 class SharedMemoryAllocator : public ContiguousBlockAllocator
 {
@@ -30,8 +33,15 @@ class SharedMemoryAllocator : public ContiguousBlockAllocator
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
 
+    storage::DataLayout &GetBlockLayout(storage::DataLayout::BlockID bid) override final;
+    char *GetBlockMemory(storage::DataLayout::BlockID bid) override final;
+
   private:
+    static storage::SharedRegionHeader &GetHeader(storage::SharedMemory &memory);
+    static char *GetData(storage::SharedMemory &memory);
+
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    std::unique_ptr<storage::SharedMemory> m_base_memory;
 };
 
 } // namespace datafacade
@@ -3,6 +3,7 @@
 
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/mmap_memory_allocator.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 
 namespace osrm
@@ -26,11 +27,20 @@ template <typename AlgorithmT> class ImmutableProvider final : public DataFacade
 
   public:
     ImmutableProvider(const storage::StorageConfig &config)
-        : immutable_data_facade(std::make_shared<FacadeT>(
-              std::make_shared<datafacade::ProcessMemoryAllocator>(config)))
+        : ImmutableProvider(std::make_shared<datafacade::ProcessMemoryAllocator>(config))
     {
     }
 
+    ImmutableProvider(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator,
+                      const datafacade::PrewarmMode prewarm = datafacade::PrewarmMode::None,
+                      const bool record_accesses = false)
+    {
+        allocator->Prewarm(prewarm);
+        if (record_accesses)
+            allocator->EnableAccessCounts();
+        immutable_data_facade = std::make_shared<FacadeT>(std::move(allocator));
+    }
+
     std::shared_ptr<const FacadeT> Get() const override final { return immutable_data_facade; }
 
   private:
@@ -43,6 +53,12 @@ template <typename AlgorithmT> class WatchingProvider final : public DataFacadeP
     DataWatchdog<AlgorithmT> watchdog;
 
   public:
+    WatchingProvider(const datafacade::PrewarmMode prewarm = datafacade::PrewarmMode::None,
+                     const bool record_accesses = false)
+        : watchdog(prewarm, record_accesses)
+    {
+    }
+
     std::shared_ptr<const FacadeT> Get() const override final
     {
         // We need a singleton here because multiple instances of DataWatchdog
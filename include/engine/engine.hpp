@@ -1,6 +1,7 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -9,9 +10,11 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "engine/datafacade/shared_memory_allocator.hpp"
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/plugins/isochrone.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
@@ -48,6 +51,9 @@ class EngineInterface
     virtual Status Match(const api::MatchParameters &parameters,
                          util::json::Object &result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, std::string &result) const = 0;
+    virtual Status Isochrone(const api::IsochroneParameters &parameters,
+                             util::json::Object &result) const = 0;
+    virtual Status MemoryUsage(util::json::Object &result) const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
@@ -59,20 +65,41 @@ template <typename Algorithm> class Engine final : public EngineInterface
           nearest_plugin(config.max_results_nearest),        //
           trip_plugin(config.max_locations_trip),            //
           match_plugin(config.max_locations_map_matching),   //
-          tile_plugin()                                      //
+          tile_plugin(),                                     //
+          isochrone_plugin(config.max_isochrone_duration)    //
 
     {
+        const auto prewarm = config.prewarm_lock
+                                 ? datafacade::PrewarmMode::Lock
+                                 : (config.prewarm ? datafacade::PrewarmMode::Touch
+                                                   : datafacade::PrewarmMode::None);
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                prewarm, config.record_block_accesses);
+        }
+        else if (config.use_mmap)
+        {
+            util::Log(logDEBUG) << "Using memory mapped data with algorithm "
+                                << routing_algorithms::name<Algorithm>();
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                std::make_shared<datafacade::MMapMemoryAllocator>(config.storage_config,
+                                                                  config.mmap_prefetch),
+                prewarm,
+                config.record_block_accesses);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                std::make_shared<datafacade::ProcessMemoryAllocator>(config.storage_config,
+                                                                     config.load_rtree_leaves),
+                prewarm,
+                config.record_block_accesses);
         }
     }
 
@@ -129,6 +156,51 @@ template <typename Algorithm> class Engine final : public EngineInterface
         return tile_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
+    Status Isochrone(const api::IsochroneParameters &params,
+                     util::json::Object &result) const override final
+    {
+        auto facade = facade_provider->Get();
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        return isochrone_plugin.HandleRequest(*facade, algorithms, params, result);
+    }
+
+    Status MemoryUsage(util::json::Object &result) const override final
+    {
+        auto facade = facade_provider->Get();
+        auto &allocator = facade->GetAllocator();
+
+        util::json::Array blocks;
+        std::uint64_t total_size = 0;
+        std::uint64_t total_resident = 0;
+        for (auto index = 0; index < storage::DataLayout::NUM_BLOCKS; ++index)
+        {
+            const auto bid = static_cast<storage::DataLayout::BlockID>(index);
+            const auto block = allocator.GetBlocks({bid}).front();
+            const auto resident = storage::getResidentSize(block.begin, block.size);
+
+            util::json::Object entry;
+            entry.values["name"] = storage::block_id_to_name[bid];
+            entry.values["entries"] = allocator.GetBlockEntries(bid);
+            entry.values["size"] = block.size;
+            entry.values["resident"] = resident;
+            if (allocator.HasAccessCounts())
+                entry.values["accesses"] = allocator.GetAccessCount(bid);
+            blocks.values.push_back(std::move(entry));
+
+            total_size += block.size;
+            total_resident += resident;
+        }
+
+        result.values["code"] = "Ok";
+        result.values["size"] = total_size;
+        result.values["resident"] = total_resident;
+        if (allocator.HasAccessCounts())
+            result.values["access_sample_rate"] =
+                datafacade::ContiguousBlockAllocator::ACCESS_SAMPLE_RATE;
+        result.values["blocks"] = std::move(blocks);
+        return Status::Ok;
+    }
+
     static bool CheckCompability(const EngineConfig &config);
 
   private:
@@ -141,6 +213,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+    const plugins::IsochronePlugin isochrone_plugin;
 };
 
 template <>
@@ -152,10 +225,9 @@ bool Engine<routing_algorithms::ch::Algorithm>::CheckCompability(const EngineCon
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
-        auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
-        return layout->GetBlockSize(storage::DataLayout::CH_GRAPH_NODE_LIST) > 4 &&
-               layout->GetBlockSize(storage::DataLayout::CH_GRAPH_EDGE_LIST) > 4;
+        datafacade::SharedMemoryAllocator allocator(barrier.data().region);
+        return allocator.GetBlockSize(storage::DataLayout::CH_GRAPH_NODE_LIST) > 4 &&
+               allocator.GetBlockSize(storage::DataLayout::CH_GRAPH_EDGE_LIST) > 4;
     }
     else
     {
@@ -183,9 +255,8 @@ bool Engine<routing_algorithms::corech::Algorithm>::CheckCompability(const Engin
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
-        auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
-        return layout->GetBlockSize(storage::DataLayout::CH_CORE_MARKER) >
+        datafacade::SharedMemoryAllocator allocator(barrier.data().region);
+        return allocator.GetBlockSize(storage::DataLayout::CH_CORE_MARKER) >
                sizeof(std::uint64_t) + sizeof(util::FingerPrint);
     }
     else
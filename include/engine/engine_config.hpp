@@ -52,8 +52,19 @@ namespace engine
  *  - Table
  *  - Match
  *  - Nearest
+ * and the maximum contour duration in seconds (-1 for unlimited) for the Isochrone service.
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * Without shared memory the dataset can be memory mapped from an image file next to the
+ * .osrm files instead of being loaded into process memory. The image is shared between all
+ * processes through the page cache and is either prefetched or paged in on demand.
+ * With prewarm the blocks used by every query are faulted in before the first request, and
+ * with prewarm_lock they are locked in RAM as well. Datasets that replace the current one
+ * in shared memory are prewarmed before they are used.
+ * When the dataset is loaded into process memory, load_rtree_leaves copies the rtree leaves
+ * into it as well instead of mapping the leaf file, so snapping does not fault in pages.
+ * With record_block_accesses the data facade samples the accesses to every block of the
+ * dataset for the memory usage report. It adds a little overhead to every access.
  *
  * You can chose between three algorithms:
  *  - Algorithm::CH
@@ -87,7 +98,14 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
+    int max_isochrone_duration = -1;
     bool use_shared_memory = true;
+    bool use_mmap = false;
+    bool mmap_prefetch = false;
+    bool prewarm = false;
+    bool prewarm_lock = false;
+    bool load_rtree_leaves = false;
+    bool record_block_accesses = false;
     Algorithm algorithm = Algorithm::CH;
 };
 }
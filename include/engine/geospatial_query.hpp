@@ -4,15 +4,23 @@
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/hilbert_value.hpp"
 #include "util/rectangle.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -29,15 +37,20 @@ inline std::pair<bool, bool> boolPairAnd(const std::pair<bool, bool> &A,
 // Implements complex queries on top of an RTree and builds PhantomNodes from it.
 //
 // Only holds a weak reference on the RTree and coordinates!
-template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
+template <typename RTreeT, typename DataFacadeT, typename SnappingGridT = util::SnappingGridView>
+class GeospatialQuery
 {
     using EdgeData = typename RTreeT::EdgeData;
     using CoordinateList = typename RTreeT::CoordinateList;
     using CandidateSegment = typename RTreeT::CandidateSegment;
 
   public:
-    GeospatialQuery(RTreeT &rtree_, const CoordinateList &coordinates_, DataFacadeT &datafacade_)
-        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_)
+    // The snapping grid is optional and needs to be built from the leaves of the RTree
+    GeospatialQuery(RTreeT &rtree_,
+                    const CoordinateList &coordinates_,
+                    DataFacadeT &datafacade_,
+                    const SnappingGridT *grid_ = nullptr)
+        : rtree(rtree_), coordinates(coordinates_), datafacade(datafacade_), grid(grid_)
     {
     }
 
@@ -46,6 +59,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         return rtree.SearchInBox(bbox);
     }
 
+    // Same result as Search if the candidates were found in a box that contains bbox
+    std::vector<EdgeData> Search(const util::RectangleInt2D &bbox,
+                                 const std::vector<EdgeData> &candidates)
+    {
+        return rtree.FilterInBox(candidates, bbox);
+    }
+
     // Returns nearest PhantomNodes in the given bearing range within max_distance.
     // Does not filter by small/big component!
     std::vector<PhantomNodeWithDistance>
@@ -80,7 +100,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             [this, max_distance, input_coordinate](const std::size_t,
                                                    const CandidateSegment &segment) {
                 return CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            util::bearing::toBucketMask(bearing, bearing_range));
 
         return MakePhantomNodes(input_coordinate, results);
     }
@@ -93,15 +114,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing,
                         const int bearing_range) const
     {
-        auto results = rtree.Nearest(
+        const auto results = NearestSegments(
             input_coordinate,
+            max_results,
             [this, bearing, bearing_range](const CandidateSegment &segment) {
                 return boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
                                    HasValidEdge(segment));
             },
-            [max_results](const std::size_t num_results, const CandidateSegment &) {
-                return num_results >= max_results;
-            });
+            util::bearing::toBucketMask(bearing, bearing_range));
 
         return MakePhantomNodes(input_coordinate, results);
     }
@@ -126,7 +146,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                                 const CandidateSegment &segment) {
                 return num_results >= max_results ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            util::bearing::toBucketMask(bearing, bearing_range));
 
         return MakePhantomNodes(input_coordinate, results);
     }
@@ -136,12 +157,10 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     std::vector<PhantomNodeWithDistance>
     NearestPhantomNodes(const util::Coordinate input_coordinate, const unsigned max_results) const
     {
-        auto results =
-            rtree.Nearest(input_coordinate,
-                          [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
-                          [max_results](const std::size_t num_results, const CandidateSegment &) {
-                              return num_results >= max_results;
-                          });
+        const auto results = NearestSegments(
+            input_coordinate, max_results, [this](const CandidateSegment &segment) {
+                return HasValidEdge(segment);
+            });
 
         return MakePhantomNodes(input_coordinate, results);
     }
@@ -278,7 +297,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             },
             [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
                 return num_results > 0 && has_big_component;
-            });
+            },
+            util::bearing::toBucketMask(bearing, bearing_range));
 
         if (results.size() == 0)
         {
@@ -327,7 +347,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 const std::size_t num_results, const CandidateSegment &segment) {
                 return (num_results > 0 && has_big_component) ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            util::bearing::toBucketMask(bearing, bearing_range));
 
         if (results.size() == 0)
         {
@@ -339,7 +360,177 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Batched versions of the queries above, the results are in the order of the queries.
+    // Every query needs a max_distance.
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodesInRange(const std::vector<PhantomNodeQuery> &queries) const
+    {
+        std::vector<std::vector<PhantomNodeWithDistance>> results(queries.size());
+        ForEachInHilbertOrder(queries, [&](const std::size_t index) {
+            const auto &query = queries[index];
+            BOOST_ASSERT(query.max_distance);
+            if (query.bearing)
+            {
+                results[index] = NearestPhantomNodesInRange(query.input_coordinate,
+                                                            *query.max_distance,
+                                                            query.bearing->bearing,
+                                                            query.bearing->range);
+            }
+            else
+            {
+                results[index] =
+                    NearestPhantomNodesInRange(query.input_coordinate, *query.max_distance);
+            }
+        });
+        return results;
+    }
+
+    std::vector<std::vector<PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<PhantomNodeQuery> &queries,
+                        const unsigned max_results) const
+    {
+        std::vector<std::vector<PhantomNodeWithDistance>> results(queries.size());
+        ForEachInHilbertOrder(queries, [&](const std::size_t index) {
+            const auto &query = queries[index];
+            if (query.bearing && query.max_distance)
+            {
+                results[index] = NearestPhantomNodes(query.input_coordinate,
+                                                     max_results,
+                                                     *query.max_distance,
+                                                     query.bearing->bearing,
+                                                     query.bearing->range);
+            }
+            else if (query.bearing)
+            {
+                results[index] = NearestPhantomNodes(query.input_coordinate,
+                                                     max_results,
+                                                     query.bearing->bearing,
+                                                     query.bearing->range);
+            }
+            else if (query.max_distance)
+            {
+                results[index] =
+                    NearestPhantomNodes(query.input_coordinate, max_results, *query.max_distance);
+            }
+            else
+            {
+                results[index] = NearestPhantomNodes(query.input_coordinate, max_results);
+            }
+        });
+        return results;
+    }
+
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<PhantomNodeQuery> &queries) const
+    {
+        std::vector<std::pair<PhantomNode, PhantomNode>> results(queries.size());
+        ForEachInHilbertOrder(queries, [&](const std::size_t index) {
+            const auto &query = queries[index];
+            if (query.bearing && query.max_distance)
+            {
+                results[index] =
+                    NearestPhantomNodeWithAlternativeFromBigComponent(query.input_coordinate,
+                                                                      *query.max_distance,
+                                                                      query.bearing->bearing,
+                                                                      query.bearing->range);
+            }
+            else if (query.bearing)
+            {
+                results[index] = NearestPhantomNodeWithAlternativeFromBigComponent(
+                    query.input_coordinate, query.bearing->bearing, query.bearing->range);
+            }
+            else if (query.max_distance)
+            {
+                results[index] = NearestPhantomNodeWithAlternativeFromBigComponent(
+                    query.input_coordinate, *query.max_distance);
+            }
+            else
+            {
+                results[index] =
+                    NearestPhantomNodeWithAlternativeFromBigComponent(query.input_coordinate);
+            }
+        });
+        return results;
+    }
+
   private:
+    // Returns the max_results nearest segments that pass the filter. In dense areas the leaves
+    // around the input coordinate are found in the snapping grid and searched first, the RTree is
+    // only searched from the root if they don't contain enough segments close enough.
+    template <typename FilterT>
+    std::vector<EdgeData>
+    NearestSegments(const util::Coordinate input_coordinate,
+                    const unsigned max_results,
+                    const FilterT filter,
+                    const util::bearing::BucketMask bearing_mask = util::bearing::ALL_BUCKETS) const
+    {
+        std::vector<EdgeData> results;
+        if (grid && !grid->Empty())
+        {
+            static thread_local std::vector<std::uint32_t> leaf_ids;
+            const util::Coordinate projected_coordinate{
+                util::web_mercator::fromWGS84(input_coordinate)};
+            const auto squared_radius = grid->GetCandidateLeaves(projected_coordinate, leaf_ids);
+            if (squared_radius > 0 && rtree.NearestInLeaves(input_coordinate,
+                                                            max_results,
+                                                            filter,
+                                                            leaf_ids.begin(),
+                                                            leaf_ids.end(),
+                                                            squared_radius,
+                                                            std::back_inserter(results),
+                                                            bearing_mask))
+            {
+                return results;
+            }
+        }
+
+        rtree.Nearest(
+            input_coordinate, max_results, filter, std::back_inserter(results), bearing_mask);
+        return results;
+    }
+
+    // Batches of at least this size are split over several threads
+    static constexpr std::size_t PARALLEL_BATCH_SIZE = 256;
+    // Number of consecutive queries in Hilbert order that are handled by one thread
+    static constexpr std::size_t BATCH_GRAIN_SIZE = 64;
+
+    // Runs the query for every index in the order of the Hilbert values of the coordinates.
+    // The rtree packs its leaves in the same order, so consecutive queries descend through
+    // the same tree nodes and read the same leaf pages while they are still cached.
+    template <typename QueryT>
+    void ForEachInHilbertOrder(const std::vector<PhantomNodeQuery> &queries,
+                               const QueryT &query) const
+    {
+        std::vector<std::pair<std::uint64_t, std::size_t>> order(queries.size());
+        for (std::size_t index = 0; index < queries.size(); ++index)
+        {
+            // the rtree computes the Hilbert values on projected coordinates as well
+            const util::Coordinate projected{
+                util::web_mercator::fromWGS84(queries[index].input_coordinate)};
+            order[index] = std::make_pair(util::GetHilbertCode(projected), index);
+        }
+        std::sort(order.begin(), order.end());
+
+        if (order.size() < PARALLEL_BATCH_SIZE)
+        {
+            for (const auto &entry : order)
+            {
+                query(entry.second);
+            }
+            return;
+        }
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, order.size(), BATCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (auto position = range.begin(); position != range.end(); ++position)
+                {
+                    query(order[position].second);
+                }
+            });
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -374,13 +565,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         EdgeDuration forward_duration_offset = 0, forward_duration = 0;
         EdgeDuration reverse_duration_offset = 0, reverse_duration = 0;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
+        const auto forward_weight_vector =
             datafacade.GetUncompressedForwardWeights(data.packed_geometry_id);
-        const std::vector<EdgeWeight> reverse_weight_vector =
+        const auto reverse_weight_vector =
             datafacade.GetUncompressedReverseWeights(data.packed_geometry_id);
-        const std::vector<EdgeWeight> forward_duration_vector =
+        const auto forward_duration_vector =
             datafacade.GetUncompressedForwardDurations(data.packed_geometry_id);
-        const std::vector<EdgeWeight> reverse_duration_vector =
+        const auto reverse_duration_vector =
             datafacade.GetUncompressedReverseDurations(data.packed_geometry_id);
 
         for (std::size_t i = 0; i < data.fwd_segment_position; i++)
@@ -444,8 +635,9 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         Coordinate wsg84_coordinate =
             util::web_mercator::toWGS84(segment.fixed_projected_coordinate);
 
-        return util::coordinate_calculation::haversineDistance(input_coordinate, wsg84_coordinate) >
-               max_distance;
+        // only compared against the radius, the approximation is close enough
+        return util::coordinate_calculation::approximateDistance(input_coordinate,
+                                                                 wsg84_coordinate) > max_distance;
     }
 
     std::pair<bool, bool> CheckSegmentBearing(const CandidateSegment &segment,
@@ -477,9 +669,9 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
     /**
      * Checks to see if the edge weights are valid.  We might have an edge,
-     * but a traffic update might set the speed to 0 (weight == INVALID_EDGE_WEIGHT).
-     * which means that this edge is not currently traversible.  If this is the case,
-     * then we shouldn't snap to this edge.
+     * but a traffic update might set the speed to 0. The updater stores the weight of
+     * such a segment as INVALID_SEGMENT_WEIGHT, which means that this edge is not
+     * currently traversible.  If this is the case, then we shouldn't snap to this edge.
      */
     std::pair<bool, bool> HasValidEdge(const CandidateSegment &segment) const
     {
@@ -487,18 +679,18 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool forward_edge_valid = false;
         bool reverse_edge_valid = false;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
+        const auto forward_weight_vector =
             datafacade.GetUncompressedForwardWeights(segment.data.packed_geometry_id);
 
-        if (forward_weight_vector[segment.data.fwd_segment_position] != INVALID_EDGE_WEIGHT)
+        if (forward_weight_vector[segment.data.fwd_segment_position] != INVALID_SEGMENT_WEIGHT)
         {
             forward_edge_valid = segment.data.forward_segment_id.enabled;
         }
 
-        const std::vector<EdgeWeight> reverse_weight_vector =
+        const auto reverse_weight_vector =
             datafacade.GetUncompressedReverseWeights(segment.data.packed_geometry_id);
         if (reverse_weight_vector[reverse_weight_vector.size() - segment.data.fwd_segment_position -
-                                  1] != INVALID_EDGE_WEIGHT)
+                                  1] != INVALID_SEGMENT_WEIGHT)
         {
             reverse_edge_valid = segment.data.reverse_segment_id.enabled;
         }
@@ -509,6 +701,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     const RTreeT &rtree;
     const CoordinateList &coordinates;
     DataFacadeT &datafacade;
+    const SnappingGridT *grid;
 };
 }
 }
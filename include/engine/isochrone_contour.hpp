@@ -0,0 +1,29 @@
+#ifndef OSRM_ENGINE_ISOCHRONE_CONTOUR_HPP
+#define OSRM_ENGINE_ISOCHRONE_CONTOUR_HPP
+
+#include "util/coordinate.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Closed ring, the outer rings are counter-clockwise and the holes clockwise
+using ContourRing = std::vector<util::Coordinate>;
+// The outer ring followed by its holes
+using ContourPolygon = std::vector<ContourRing>;
+
+// Traces the area covered by the lines. The lines are rasterized onto a grid of at most
+// 256 cells along the longer side of their bounding box, but with cells of at least about 50m.
+// Every covered cell is grown by its eight neighbours, so the roads of a block merge into one
+// area while unreachable areas larger than a few cells stay holes.
+//
+// Returns one polygon per connected area, the largest one first. The rings follow the cell
+// boundaries, only their corners are kept.
+std::vector<ContourPolygon> traceContour(const std::vector<std::vector<util::Coordinate>> &lines);
+}
+}
+
+#endif
@@ -28,12 +28,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef PHANTOM_NODES_H
 #define PHANTOM_NODES_H
 
+#include "engine/bearing.hpp"
 #include "extractor/travel_mode.hpp"
 #include "util/typedefs.hpp"
 
 #include "util/coordinate.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/optional.hpp>
 
 #include <iostream>
 #include <utility>
@@ -201,6 +203,14 @@ struct PhantomNodeWithDistance
     double distance;
 };
 
+// One coordinate of a batch of snapping queries with its optional restrictions
+struct PhantomNodeQuery
+{
+    util::Coordinate input_coordinate;
+    boost::optional<double> max_distance;
+    boost::optional<Bearing> bearing;
+};
+
 struct PhantomNodes
 {
     PhantomNode source_phantom;
@@ -0,0 +1,35 @@
+#ifndef ISOCHRONE_HPP
+#define ISOCHRONE_HPP
+
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/plugins/plugin_base.hpp"
+#include "engine/routing_algorithms.hpp"
+#include "osrm/json_container.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+class IsochronePlugin final : public BasePlugin
+{
+  public:
+    explicit IsochronePlugin(const int max_duration);
+
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::IsochroneParameters &params,
+                         util::json::Object &result) const;
+
+  private:
+    // maximal contour in seconds
+    const int max_duration;
+};
+}
+}
+}
+
+#endif /* ISOCHRONE_HPP */
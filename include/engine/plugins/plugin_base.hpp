@@ -106,6 +106,33 @@ class BasePlugin
         return snapped_phantoms;
     }
 
+    // Snapping queries for all coordinates that don't have a valid hint. The coordinates are
+    // snapped in one batch, so the rtree can process them in a cache friendly order.
+    std::vector<PhantomNodeQuery> GetPhantomNodeQueries(const datafacade::BaseDataFacade &facade,
+                                                        const api::BaseParameters &parameters,
+                                                        std::vector<bool> &use_hint) const
+    {
+        const bool use_hints = !parameters.hints.empty();
+        const bool use_bearings = !parameters.bearings.empty();
+        const bool use_radiuses = !parameters.radiuses.empty();
+
+        use_hint.resize(parameters.coordinates.size());
+        std::vector<PhantomNodeQuery> queries;
+        for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+        {
+            use_hint[i] = use_hints && parameters.hints[i] &&
+                          parameters.hints[i]->IsValid(parameters.coordinates[i], facade);
+            if (use_hint[i])
+                continue;
+
+            queries.push_back(
+                PhantomNodeQuery{parameters.coordinates[i],
+                                 use_radiuses ? parameters.radiuses[i] : boost::none,
+                                 use_bearings ? parameters.bearings[i] : boost::none});
+        }
+        return queries;
+    }
+
     // Falls back to default_radius for non-set radii
     std::vector<std::vector<PhantomNodeWithDistance>>
     GetPhantomNodesInRange(const datafacade::BaseDataFacade &facade,
@@ -116,13 +143,20 @@ class BasePlugin
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
+        std::vector<bool> use_hint;
+        auto queries = GetPhantomNodeQueries(facade, parameters, use_hint);
+        auto query = queries.begin();
+        for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
+        {
+            if (!use_hint[i])
+                (query++)->max_distance = radiuses[i];
+        }
+        auto snapped_phantoms = facade.NearestPhantomNodesInRange(queries);
 
+        auto snapped = snapped_phantoms.begin();
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (use_hint[i])
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
                     parameters.hints[i]->phantom,
@@ -131,19 +165,7 @@ class BasePlugin
                 });
                 continue;
             }
-            if (use_bearings && parameters.bearings[i])
-            {
-                phantom_nodes[i] =
-                    facade.NearestPhantomNodesInRange(parameters.coordinates[i],
-                                                      radiuses[i],
-                                                      parameters.bearings[i]->bearing,
-                                                      parameters.bearings[i]->range);
-            }
-            else
-            {
-                phantom_nodes[i] =
-                    facade.NearestPhantomNodesInRange(parameters.coordinates[i], radiuses[i]);
-            }
+            phantom_nodes[i] = std::move(*snapped++);
         }
 
         return phantom_nodes;
@@ -157,15 +179,15 @@ class BasePlugin
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_radiuses = !parameters.radiuses.empty();
-
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<bool> use_hint;
+        auto snapped_phantoms = facade.NearestPhantomNodes(
+            GetPhantomNodeQueries(facade, parameters, use_hint), number_of_results);
+
+        auto snapped = snapped_phantoms.begin();
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (use_hint[i])
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
                     parameters.hints[i]->phantom,
@@ -175,37 +197,7 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  *parameters.radiuses[i],
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(parameters.coordinates[i],
-                                                                  number_of_results,
-                                                                  parameters.bearings[i]->bearing,
-                                                                  parameters.bearings[i]->range);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_nodes[i] = facade.NearestPhantomNodes(
-                        parameters.coordinates[i], number_of_results, *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_nodes[i] =
-                        facade.NearestPhantomNodes(parameters.coordinates[i], number_of_results);
-                }
-            }
+            phantom_nodes[i] = std::move(*snapped++);
 
             // we didn't find a fitting node, return error
             if (phantom_nodes[i].empty())
@@ -221,56 +213,22 @@ class BasePlugin
     {
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
-        const bool use_bearings = !parameters.bearings.empty();
-        const bool use_radiuses = !parameters.radiuses.empty();
-
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<bool> use_hint;
+        const auto snapped_phantoms = facade.NearestPhantomNodeWithAlternativeFromBigComponent(
+            GetPhantomNodeQueries(facade, parameters, use_hint));
+
+        auto snapped = snapped_phantoms.begin();
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (use_hint[i])
             {
                 phantom_node_pairs[i].first = parameters.hints[i]->phantom;
                 // we don't set the second one - it will be marked as invalid
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i]);
-                }
-            }
+            phantom_node_pairs[i] = *snapped++;
 
             // we didn't find a fitting node, return error
             if (!phantom_node_pairs[i].first.IsValid())
@@ -4,6 +4,7 @@
 #include "engine/api/tile_parameters.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/tile_edge_cache.hpp"
 
 #include <utility>
 #include <vector>
@@ -30,6 +31,10 @@ class TilePlugin final : public BasePlugin
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::TileParameters &parameters,
                          std::string &pbf_buffer) const;
+
+  private:
+    // Edges extracted for recent tiles, shared by all requests
+    mutable TileEdgeCache edge_cache;
 };
 }
 }
@@ -6,6 +6,7 @@
 #include "engine/phantom_node.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
+#include "engine/routing_algorithms/isochrone.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/map_matching.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
@@ -45,12 +46,16 @@ class RoutingAlgorithmsInterface
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const = 0;
 
+    virtual std::vector<routing_algorithms::IsochroneNode>
+    IsochroneSearch(const PhantomNode &source, const EdgeWeight max_duration) const = 0;
+
     virtual bool HasAlternativePathSearch() const = 0;
     virtual bool HasShortestPathSearch() const = 0;
     virtual bool HasDirectShortestPathSearch() const = 0;
     virtual bool HasMapMatching() const = 0;
     virtual bool HasManyToManySearch() const = 0;
     virtual bool HasGetTileTurns() const = 0;
+    virtual bool HasIsochroneSearch() const = 0;
 };
 
 // Short-lived object passed to each plugin in request to wrap routing algorithms
@@ -91,6 +96,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const final override;
 
+    std::vector<routing_algorithms::IsochroneNode>
+    IsochroneSearch(const PhantomNode &source, const EdgeWeight max_duration) const final override;
+
     bool HasAlternativePathSearch() const final override
     {
         return routing_algorithms::HasAlternativePathSearch<Algorithm>::value;
@@ -121,6 +129,11 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
         return routing_algorithms::HasGetTileTurns<Algorithm>::value;
     }
 
+    bool HasIsochroneSearch() const final override
+    {
+        return routing_algorithms::HasIsochroneSearch<Algorithm>::value;
+    }
+
   private:
     SearchEngineData<Algorithm> &heaps;
 
@@ -186,6 +199,14 @@ inline std::vector<routing_algorithms::TurnData> RoutingAlgorithms<Algorithm>::G
     return routing_algorithms::getTileTurns(facade, edges, sorted_edge_indexes);
 }
 
+template <typename Algorithm>
+inline std::vector<routing_algorithms::IsochroneNode>
+RoutingAlgorithms<Algorithm>::IsochroneSearch(const PhantomNode &source,
+                                              const EdgeWeight max_duration) const
+{
+    return routing_algorithms::isochroneSearch(heaps, facade, source, max_duration);
+}
+
 // CoreCH overrides
 template <>
 InternalRouteResult inline RoutingAlgorithms<
@@ -204,6 +225,14 @@ RoutingAlgorithms<routing_algorithms::corech::Algorithm>::ManyToManySearch(
     throw util::exception("ManyToManySearch is disabled due to performance reasons");
 }
 
+template <>
+inline std::vector<routing_algorithms::IsochroneNode>
+RoutingAlgorithms<routing_algorithms::corech::Algorithm>::IsochroneSearch(const PhantomNode &,
+                                                                         const EdgeWeight) const
+{
+    throw util::exception("IsochroneSearch is not implemented");
+}
+
 // MLD overrides for not implemented
 template <>
 InternalRouteResult inline RoutingAlgorithms<
@@ -221,15 +250,6 @@ RoutingAlgorithms<routing_algorithms::mld::Algorithm>::ManyToManySearch(
 {
     throw util::exception("ManyToManySearch is not implemented");
 }
-
-template <>
-inline std::vector<routing_algorithms::TurnData>
-RoutingAlgorithms<routing_algorithms::mld::Algorithm>::GetTileTurns(
-    const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &,
-    const std::vector<std::size_t> &) const
-{
-    throw util::exception("GetTileTurns is not implemented");
-}
 }
 }
 
@@ -0,0 +1,50 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_ISOCHRONE_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_ISOCHRONE_HPP
+
+#include "engine/algorithm.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// An edge-based node reachable from the source. The duration is measured up to the start of
+// the node and is negative for the source nodes, which start behind the phantom node.
+struct IsochroneNode
+{
+    NodeID node;
+    EdgeWeight duration;
+};
+
+/// Bounded one-to-all search on durations: returns all edge-based nodes whose start can be
+/// reached from the source within max_duration.
+///
+/// CH runs a PHAST search: a bounded upward search followed by a sweep in descending
+/// contraction order over the nodes reached within max_duration. MLD runs a bounded Dijkstra
+/// on the edge-based graph.
+std::vector<IsochroneNode>
+isochroneSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                const PhantomNode &source,
+                const EdgeWeight max_duration);
+
+std::vector<IsochroneNode>
+isochroneSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+                const PhantomNode &source,
+                const EdgeWeight max_duration);
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif
@@ -91,6 +91,116 @@ void insertNodesInHeaps(Heap &forward_heap, Heap &reverse_heap, const PhantomNod
     insertNodesInHeap<REVERSE_DIRECTION>(reverse_heap, nodes.target_phantom);
 }
 
+// Appends the segments of the compressed geometry of one edge-based node to the path.
+// On the first edge-based node of the path only the segments after the source phantom are used.
+template <typename NodeRange,
+          typename WeightRange,
+          typename DurationRange,
+          typename DatasourceRange>
+void annotateSegments(const PhantomNodes &phantom_node_pair,
+                      const bool start_traversed_in_reverse,
+                      const NameID name_index,
+                      const extractor::TravelMode travel_mode,
+                      const NodeRange &id_range,
+                      const WeightRange &weight_range,
+                      const DurationRange &duration_range,
+                      const DatasourceRange &datasource_range,
+                      std::vector<PathData> &unpacked_path)
+{
+    BOOST_ASSERT(id_range.size() > 0);
+    BOOST_ASSERT(datasource_range.size() > 0);
+    BOOST_ASSERT(weight_range.size() == id_range.size() - 1);
+    BOOST_ASSERT(duration_range.size() == id_range.size() - 1);
+    const bool is_first_segment = unpacked_path.empty();
+
+    const std::size_t start_index =
+        (is_first_segment ? ((start_traversed_in_reverse)
+                                 ? weight_range.size() -
+                                       phantom_node_pair.source_phantom.fwd_segment_position - 1
+                                 : phantom_node_pair.source_phantom.fwd_segment_position)
+                          : 0);
+    const std::size_t end_index = weight_range.size();
+
+    BOOST_ASSERT(start_index >= 0);
+    BOOST_ASSERT(start_index < end_index);
+    for (std::size_t segment_idx = start_index; segment_idx < end_index; ++segment_idx)
+    {
+        unpacked_path.push_back(PathData{id_range[segment_idx + 1],
+                                         name_index,
+                                         static_cast<EdgeWeight>(weight_range[segment_idx]),
+                                         static_cast<EdgeWeight>(duration_range[segment_idx]),
+                                         extractor::guidance::TurnInstruction::NO_TURN(),
+                                         {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+                                         travel_mode,
+                                         INVALID_ENTRY_CLASSID,
+                                         datasource_range[segment_idx],
+                                         util::guidance::TurnBearing(0),
+                                         util::guidance::TurnBearing(0)});
+    }
+}
+
+// Appends the segments of the target edge-based node up to the target phantom.
+// Given the following compressed geometry:
+// U---v---w---x---y---Z
+//    s           t
+// s: fwd_segment 0
+// t: fwd_segment 3
+// -> (U, v), (v, w), (w, x)
+// note that (x, t) is _not_ included but needs to be added later.
+template <typename NodeRange,
+          typename WeightRange,
+          typename DurationRange,
+          typename DatasourceRange>
+void annotateTargetSegments(const PhantomNodes &phantom_node_pair,
+                            const bool target_traversed_in_reverse,
+                            const bool is_local_path,
+                            const NodeRange &id_range,
+                            const WeightRange &weight_range,
+                            const DurationRange &duration_range,
+                            const DatasourceRange &datasource_range,
+                            std::vector<PathData> &unpacked_path)
+{
+    std::size_t start_index = 0, end_index = 0;
+    if (target_traversed_in_reverse)
+    {
+        if (is_local_path)
+        {
+            start_index =
+                weight_range.size() - phantom_node_pair.source_phantom.fwd_segment_position - 1;
+        }
+        end_index =
+            weight_range.size() - phantom_node_pair.target_phantom.fwd_segment_position - 1;
+    }
+    else
+    {
+        if (is_local_path)
+        {
+            start_index = phantom_node_pair.source_phantom.fwd_segment_position;
+        }
+        end_index = phantom_node_pair.target_phantom.fwd_segment_position;
+    }
+
+    for (std::size_t segment_idx = start_index; segment_idx != end_index;
+         (start_index < end_index ? ++segment_idx : --segment_idx))
+    {
+        BOOST_ASSERT(segment_idx < id_range.size() - 1);
+        BOOST_ASSERT(phantom_node_pair.target_phantom.forward_travel_mode > 0);
+        unpacked_path.push_back(PathData{
+            id_range[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
+            phantom_node_pair.target_phantom.name_id,
+            static_cast<EdgeWeight>(weight_range[segment_idx]),
+            static_cast<EdgeWeight>(duration_range[segment_idx]),
+            extractor::guidance::TurnInstruction::NO_TURN(),
+            {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+            target_traversed_in_reverse ? phantom_node_pair.target_phantom.backward_travel_mode
+                                        : phantom_node_pair.target_phantom.forward_travel_mode,
+            INVALID_ENTRY_CLASSID,
+            datasource_range[segment_idx],
+            util::guidance::TurnBearing(0),
+            util::guidance::TurnBearing(0)});
+    }
+}
+
 template <typename FacadeT>
 void annotatePath(const FacadeT &facade,
                   const NodeID source_node,
@@ -124,54 +234,29 @@ void annotatePath(const FacadeT &facade,
                 : facade.GetTravelModeForEdgeID(turn_id);
 
         const auto geometry_index = facade.GetGeometryIndexForEdgeID(turn_id);
-        std::vector<NodeID> id_vector;
-
-        std::vector<EdgeWeight> weight_vector;
-        std::vector<EdgeWeight> duration_vector;
-        std::vector<DatasourceID> datasource_vector;
         if (geometry_index.forward)
         {
-            id_vector = facade.GetUncompressedForwardGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedForwardWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedForwardDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedForwardDatasources(geometry_index.id);
+            annotateSegments(phantom_node_pair,
+                             start_traversed_in_reverse,
+                             name_index,
+                             travel_mode,
+                             facade.GetUncompressedForwardGeometry(geometry_index.id),
+                             facade.GetUncompressedForwardWeights(geometry_index.id),
+                             facade.GetUncompressedForwardDurations(geometry_index.id),
+                             facade.GetUncompressedForwardDatasources(geometry_index.id),
+                             unpacked_path);
         }
         else
         {
-            id_vector = facade.GetUncompressedReverseGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedReverseWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedReverseDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedReverseDatasources(geometry_index.id);
-        }
-        BOOST_ASSERT(id_vector.size() > 0);
-        BOOST_ASSERT(datasource_vector.size() > 0);
-        BOOST_ASSERT(weight_vector.size() == id_vector.size() - 1);
-        BOOST_ASSERT(duration_vector.size() == id_vector.size() - 1);
-        const bool is_first_segment = unpacked_path.empty();
-
-        const std::size_t start_index =
-            (is_first_segment ? ((start_traversed_in_reverse)
-                                     ? weight_vector.size() -
-                                           phantom_node_pair.source_phantom.fwd_segment_position - 1
-                                     : phantom_node_pair.source_phantom.fwd_segment_position)
-                              : 0);
-        const std::size_t end_index = weight_vector.size();
-
-        BOOST_ASSERT(start_index >= 0);
-        BOOST_ASSERT(start_index < end_index);
-        for (std::size_t segment_idx = start_index; segment_idx < end_index; ++segment_idx)
-        {
-            unpacked_path.push_back(PathData{id_vector[segment_idx + 1],
-                                             name_index,
-                                             weight_vector[segment_idx],
-                                             duration_vector[segment_idx],
-                                             extractor::guidance::TurnInstruction::NO_TURN(),
-                                             {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-                                             travel_mode,
-                                             INVALID_ENTRY_CLASSID,
-                                             datasource_vector[segment_idx],
-                                             util::guidance::TurnBearing(0),
-                                             util::guidance::TurnBearing(0)});
+            annotateSegments(phantom_node_pair,
+                             start_traversed_in_reverse,
+                             name_index,
+                             travel_mode,
+                             facade.GetUncompressedReverseGeometry(geometry_index.id),
+                             facade.GetUncompressedReverseWeights(geometry_index.id),
+                             facade.GetUncompressedReverseDurations(geometry_index.id),
+                             facade.GetUncompressedReverseDatasources(geometry_index.id),
+                             unpacked_path);
         }
         BOOST_ASSERT(unpacked_path.size() > 0);
         if (facade.HasLaneData(turn_id))
@@ -185,83 +270,32 @@ void annotatePath(const FacadeT &facade,
         unpacked_path.back().post_turn_bearing = facade.PostTurnBearing(turn_id);
     }
 
-    std::size_t start_index = 0, end_index = 0;
-    std::vector<unsigned> id_vector;
-    std::vector<EdgeWeight> weight_vector;
-    std::vector<EdgeWeight> duration_vector;
-    std::vector<DatasourceID> datasource_vector;
     const bool is_local_path = (phantom_node_pair.source_phantom.packed_geometry_id ==
                                 phantom_node_pair.target_phantom.packed_geometry_id) &&
                                unpacked_path.empty();
 
+    const auto target_geometry_id = phantom_node_pair.target_phantom.packed_geometry_id;
     if (target_traversed_in_reverse)
     {
-        id_vector = facade.GetUncompressedReverseGeometry(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        weight_vector = facade.GetUncompressedReverseWeights(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        duration_vector = facade.GetUncompressedReverseDurations(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        datasource_vector = facade.GetUncompressedReverseDatasources(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        if (is_local_path)
-        {
-            start_index =
-                weight_vector.size() - phantom_node_pair.source_phantom.fwd_segment_position - 1;
-        }
-        end_index =
-            weight_vector.size() - phantom_node_pair.target_phantom.fwd_segment_position - 1;
+        annotateTargetSegments(phantom_node_pair,
+                               target_traversed_in_reverse,
+                               is_local_path,
+                               facade.GetUncompressedReverseGeometry(target_geometry_id),
+                               facade.GetUncompressedReverseWeights(target_geometry_id),
+                               facade.GetUncompressedReverseDurations(target_geometry_id),
+                               facade.GetUncompressedReverseDatasources(target_geometry_id),
+                               unpacked_path);
     }
     else
     {
-        if (is_local_path)
-        {
-            start_index = phantom_node_pair.source_phantom.fwd_segment_position;
-        }
-        end_index = phantom_node_pair.target_phantom.fwd_segment_position;
-
-        id_vector = facade.GetUncompressedForwardGeometry(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        weight_vector = facade.GetUncompressedForwardWeights(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        duration_vector = facade.GetUncompressedForwardDurations(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-
-        datasource_vector = facade.GetUncompressedForwardDatasources(
-            phantom_node_pair.target_phantom.packed_geometry_id);
-    }
-
-    // Given the following compressed geometry:
-    // U---v---w---x---y---Z
-    //    s           t
-    // s: fwd_segment 0
-    // t: fwd_segment 3
-    // -> (U, v), (v, w), (w, x)
-    // note that (x, t) is _not_ included but needs to be added later.
-    for (std::size_t segment_idx = start_index; segment_idx != end_index;
-         (start_index < end_index ? ++segment_idx : --segment_idx))
-    {
-        BOOST_ASSERT(segment_idx < id_vector.size() - 1);
-        BOOST_ASSERT(phantom_node_pair.target_phantom.forward_travel_mode > 0);
-        unpacked_path.push_back(PathData{
-            id_vector[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
-            phantom_node_pair.target_phantom.name_id,
-            weight_vector[segment_idx],
-            duration_vector[segment_idx],
-            extractor::guidance::TurnInstruction::NO_TURN(),
-            {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-            target_traversed_in_reverse ? phantom_node_pair.target_phantom.backward_travel_mode
-                                        : phantom_node_pair.target_phantom.forward_travel_mode,
-            INVALID_ENTRY_CLASSID,
-            datasource_vector[segment_idx],
-            util::guidance::TurnBearing(0),
-            util::guidance::TurnBearing(0)});
+        annotateTargetSegments(phantom_node_pair,
+                               target_traversed_in_reverse,
+                               is_local_path,
+                               facade.GetUncompressedForwardGeometry(target_geometry_id),
+                               facade.GetUncompressedForwardWeights(target_geometry_id),
+                               facade.GetUncompressedForwardDurations(target_geometry_id),
+                               facade.GetUncompressedForwardDatasources(target_geometry_id),
+                               unpacked_path);
     }
 
     if (unpacked_path.size() > 0)
@@ -6,6 +6,7 @@
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
+#include "util/relax_kernels.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
@@ -100,55 +101,58 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
 
     if (level >= 1 && !forward_heap.GetData(node).from_clique_arc)
     {
-        if (DIRECTION == FORWARD_DIRECTION)
+        const auto relax_shortcut = [&](const NodeID to, const EdgeWeight to_weight) {
+            if (node == to)
+                return;
+
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_weight, {node, true});
+            }
+            else if (to_weight < forward_heap.GetKey(to))
+            {
+                forward_heap.GetData(to) = {node, true};
+                forward_heap.DecreaseKey(to, to_weight);
+            }
+        };
+
+        const auto &overlay_graph = facade.GetOverlayGraph();
+        if (!overlay_graph.Empty())
         {
-            // Shortcuts in forward direction
-            const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
-            auto destination = cell.GetDestinationNodes().begin();
-            for (auto shortcut_weight : cell.GetOutWeight(node))
+            // The overlay graph stores the valid clique arcs of the node contiguously
+            const auto cell_id = partition.GetCell(level, node);
+            const auto arcs = DIRECTION == FORWARD_DIRECTION
+                                  ? overlay_graph.GetOutArcs(level, cell_id, node)
+                                  : overlay_graph.GetInArcs(level, cell_id, node);
+            for (const auto &arc : arcs)
             {
-                BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
-                const NodeID to = *destination;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
-                {
-                    const EdgeWeight to_weight = weight + shortcut_weight;
-                    if (!forward_heap.WasInserted(to))
-                    {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
-                    {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
-                    }
-                }
-                ++destination;
+                relax_shortcut(arc.node, weight + arc.weight);
             }
         }
+        else if (DIRECTION == FORWARD_DIRECTION)
+        {
+            // Shortcuts in forward direction
+            const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
+            const auto destinations = cell.GetDestinationNodes();
+            util::simd::relaxWeights(
+                cell.GetOutWeight(node), 1, weight, [&](const auto index, const auto to_weight) {
+                    BOOST_ASSERT(index < destinations.size());
+                    relax_shortcut(destinations[index], to_weight);
+                });
+        }
         else
         {
-            // Shortcuts in backward direction
+            // Shortcuts in backward direction, the column stride is the row length
             const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
-            auto source = cell.GetSourceNodes().begin();
-            for (auto shortcut_weight : cell.GetInWeight(node))
-            {
-                BOOST_ASSERT(source != cell.GetSourceNodes().end());
-                const NodeID to = *source;
-                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
-                {
-                    const EdgeWeight to_weight = weight + shortcut_weight;
-                    if (!forward_heap.WasInserted(to))
-                    {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
-                    {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
-                    }
-                }
-                ++source;
-            }
+            const auto sources = cell.GetSourceNodes();
+            const auto destinations = cell.GetDestinationNodes();
+            util::simd::relaxWeights(cell.GetInWeight(node),
+                                     destinations.size(),
+                                     weight,
+                                     [&](const auto index, const auto to_weight) {
+                                         BOOST_ASSERT(index < sources.size());
+                                         relax_shortcut(sources[index], to_weight);
+                                     });
         }
     }
 
@@ -0,0 +1,185 @@
+#ifndef OSRM_ENGINE_TILE_EDGE_CACHE_HPP
+#define OSRM_ENGINE_TILE_EDGE_CACHE_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Edges of recently requested tiles, one map per zoom level keyed on the tile coordinates.
+// Viewers request neighbouring tiles and zoom into them, so a tile whose parent is cached can
+// be derived from the edges of the parent instead of querying the rtree.
+//
+// The entries belong to one dataset. A lookup or insert for another dataset, after the data
+// was swapped, drops all of them. The least recently used tiles are evicted once the cached
+// tiles hold more than max_edges edges.
+class TileEdgeCache
+{
+  public:
+    using RTreeLeaf = datafacade::BaseDataFacade::RTreeLeaf;
+    using Edges = std::shared_ptr<const std::vector<RTreeLeaf>>;
+
+    // Filtering the edges of an ancestor gets slower with every level, it covers 4x the area
+    static constexpr const unsigned MAX_PARENT_LEVELS = 2;
+    static constexpr const std::size_t DEFAULT_MAX_EDGES = 1 << 20;
+
+    struct Dataset
+    {
+        unsigned checksum;
+        std::string timestamp;
+
+        bool operator==(const Dataset &other) const
+        {
+            return std::tie(checksum, timestamp) == std::tie(other.checksum, other.timestamp);
+        }
+        bool operator!=(const Dataset &other) const { return !(*this == other); }
+    };
+
+    // Edges of the tile itself if z is the requested zoom level, otherwise of an ancestor
+    struct Result
+    {
+        Edges edges;
+        unsigned z;
+    };
+
+    TileEdgeCache(const std::size_t max_edges_ = DEFAULT_MAX_EDGES) : max_edges(max_edges_) {}
+
+    // Returns the cached edges of the tile or of its closest ancestor at most MAX_PARENT_LEVELS
+    // above it. The edges are empty if none of them is cached.
+    Result Find(const Dataset &dataset, const unsigned x, const unsigned y, const unsigned z)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SetDataset(dataset);
+
+        for (unsigned levels = 0; levels <= MAX_PARENT_LEVELS && levels <= z; ++levels)
+        {
+            const auto parent_z = z - levels;
+            if (parent_z >= zoom_levels.size())
+                continue;
+
+            auto &tiles = zoom_levels[parent_z];
+            const auto tile = tiles.find(ToKey(x >> levels, y >> levels));
+            if (tile != tiles.end())
+            {
+                // move to the front of the usage list
+                usage.splice(usage.begin(), usage, tile->second.usage);
+                return {tile->second.edges, parent_z};
+            }
+        }
+        return {nullptr, z};
+    }
+
+    void Insert(const Dataset &dataset,
+                const unsigned x,
+                const unsigned y,
+                const unsigned z,
+                Edges edges)
+    {
+        BOOST_ASSERT(edges);
+        std::lock_guard<std::mutex> lock(mutex);
+        SetDataset(dataset);
+
+        if (edges->size() > max_edges)
+            return;
+
+        if (z >= zoom_levels.size())
+            zoom_levels.resize(z + 1);
+
+        const auto key = ToKey(x, y);
+        auto &tiles = zoom_levels[z];
+        const auto existing = tiles.find(key);
+        if (existing != tiles.end())
+        {
+            // another request extracted the same tile concurrently
+            return;
+        }
+
+        num_edges += Cost(*edges);
+        usage.emplace_front(z, key);
+        tiles.emplace(key, Entry{std::move(edges), usage.begin()});
+
+        while (num_edges > max_edges)
+        {
+            const auto &oldest = usage.back();
+            auto &oldest_tiles = zoom_levels[oldest.first];
+            const auto entry = oldest_tiles.find(oldest.second);
+            BOOST_ASSERT(entry != oldest_tiles.end());
+            num_edges -= Cost(*entry->second.edges);
+            oldest_tiles.erase(entry);
+            usage.pop_back();
+        }
+    }
+
+    std::size_t GetNumberOfTiles() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return usage.size();
+    }
+
+    std::size_t GetNumberOfEdges() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return num_edges;
+    }
+
+  private:
+    // zoom level and key of a tile
+    using Usage = std::list<std::pair<unsigned, std::uint64_t>>;
+
+    struct Entry
+    {
+        Edges edges;
+        Usage::iterator usage;
+    };
+
+    // empty tiles count as one edge, so their number is bounded as well
+    static std::size_t Cost(const std::vector<RTreeLeaf> &edges)
+    {
+        return std::max<std::size_t>(edges.size(), 1);
+    }
+
+    static std::uint64_t ToKey(const unsigned x, const unsigned y)
+    {
+        return (static_cast<std::uint64_t>(x) << 32) | y;
+    }
+
+    void SetDataset(const Dataset &dataset)
+    {
+        if (dataset != current_dataset)
+        {
+            current_dataset = dataset;
+            zoom_levels.clear();
+            usage.clear();
+            num_edges = 0;
+        }
+    }
+
+    const std::size_t max_edges;
+
+    mutable std::mutex mutex;
+    Dataset current_dataset{0, ""};
+    std::vector<std::unordered_map<std::uint64_t, Entry>> zoom_levels;
+    // most recently used tiles first
+    Usage usage;
+    std::size_t num_edges = 0;
+};
+}
+}
+
+#endif
@@ -40,7 +40,7 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
+    ExtractorConfig() noexcept : requested_num_threads(0), snapping_grid_cell_size(0) {}
     void UseDefaultOutputNames()
     {
         std::string basepath = input_path.string();
@@ -70,6 +70,7 @@ struct ExtractorConfig
         edge_graph_output_path = basepath + ".osrm.ebg";
         rtree_nodes_output_path = basepath + ".osrm.ramIndex";
         rtree_leafs_output_path = basepath + ".osrm.fileIndex";
+        snapping_grid_output_path = basepath + ".osrm.grid";
         turn_duration_penalties_path = basepath + ".osrm.turn_duration_penalties";
         turn_weight_penalties_path = basepath + ".osrm.turn_weight_penalties";
         turn_penalties_index_path = basepath + ".osrm.turn_penalties_index";
@@ -96,6 +97,7 @@ struct ExtractorConfig
     std::string node_output_path;
     std::string rtree_nodes_output_path;
     std::string rtree_leafs_output_path;
+    std::string snapping_grid_output_path;
     std::string profile_properties_output_path;
     std::string intersection_class_data_output_path;
     std::string turn_weight_penalties_path;
@@ -105,6 +107,8 @@ struct ExtractorConfig
 
     unsigned requested_num_threads;
     unsigned small_component_size;
+    // edge length of the snapping grid cells in meters, 0 disables the grid
+    double snapping_grid_cell_size;
 
     bool generate_edge_lookup;
     std::string turn_penalties_index_path;
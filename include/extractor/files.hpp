@@ -7,6 +7,7 @@
 #include "util/coordinate.hpp"
 #include "util/packed_vector.hpp"
 #include "util/serialization.hpp"
+#include "util/snapping_grid.hpp"
 
 #include <boost/assert.hpp>
 
@@ -112,6 +113,32 @@ inline void writeSegmentData(const boost::filesystem::path &path, const SegmentD
     serialization::write(writer, segment_data);
 }
 
+// reads .osrm.grid
+template <typename SnappingGridT>
+inline void readSnappingGrid(const boost::filesystem::path &path, SnappingGridT &grid)
+{
+    static_assert(std::is_same<util::SnappingGrid, SnappingGridT>::value ||
+                      std::is_same<util::SnappingGridView, SnappingGridT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    util::serialization::read(reader, grid);
+}
+
+// writes .osrm.grid
+template <typename SnappingGridT>
+inline void writeSnappingGrid(const boost::filesystem::path &path, const SnappingGridT &grid)
+{
+    static_assert(std::is_same<util::SnappingGrid, SnappingGridT>::value ||
+                      std::is_same<util::SnappingGridView, SnappingGridT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    util::serialization::write(writer, grid);
+}
+
 // reads .osrm.edges
 template <typename TurnDataT>
 inline void readTurnData(const boost::filesystem::path &path, TurnDataT &turn_data)
@@ -1,6 +1,7 @@
 #ifndef OSRM_EXTRACTOR_SEGMENT_DATA_CONTAINER_HPP_
 #define OSRM_EXTRACTOR_SEGMENT_DATA_CONTAINER_HPP_
 
+#include "util/packed_vector.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 
@@ -14,6 +15,7 @@
 #include <unordered_map>
 
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -51,15 +53,31 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
     using DirectionalGeometryID = std::uint32_t;
     using SegmentOffset = std::uint32_t;
 
+    using SegmentNodeVector = Vector<NodeID>;
+    using SegmentDatasourceVector = Vector<DatasourceID>;
+
+    // The read-only view keeps weights and durations bit packed to SEGMENT_WEIGHT_BITS /
+    // SEGMENT_DURATION_BITS. They are unpacked when a response is assembled and, for the
+    // weights, for every snapping candidate checked by GeospatialQuery::HasValidEdge.
+    // packed-bench measures the cost of both access patterns.
+    using SegmentWeightVector = typename std::conditional<
+        Ownership == storage::Ownership::View,
+        util::PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS>,
+        std::vector<SegmentWeight>>::type;
+    using SegmentDurationVector = typename std::conditional<
+        Ownership == storage::Ownership::View,
+        util::PackedVectorView<SegmentDuration, SEGMENT_DURATION_BITS>,
+        std::vector<SegmentDuration>>::type;
+
     SegmentDataContainerImpl() = default;
 
     SegmentDataContainerImpl(Vector<std::uint32_t> index_,
-                             Vector<NodeID> nodes_,
-                             Vector<SegmentWeight> fwd_weights_,
-                             Vector<SegmentWeight> rev_weights_,
-                             Vector<SegmentDuration> fwd_durations_,
-                             Vector<SegmentDuration> rev_durations_,
-                             Vector<DatasourceID> datasources_)
+                             SegmentNodeVector nodes_,
+                             SegmentWeightVector fwd_weights_,
+                             SegmentWeightVector rev_weights_,
+                             SegmentDurationVector fwd_durations_,
+                             SegmentDurationVector rev_durations_,
+                             SegmentDatasourceVector datasources_)
         : index(std::move(index_)), nodes(std::move(nodes_)), fwd_weights(std::move(fwd_weights_)),
           rev_weights(std::move(rev_weights_)), fwd_durations(std::move(fwd_durations_)),
           rev_durations(std::move(rev_durations_)), datasources(std::move(datasources_))
@@ -200,12 +218,12 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
 
   private:
     Vector<std::uint32_t> index;
-    Vector<NodeID> nodes;
-    Vector<SegmentWeight> fwd_weights;
-    Vector<SegmentWeight> rev_weights;
-    Vector<SegmentDuration> fwd_durations;
-    Vector<SegmentDuration> rev_durations;
-    Vector<DatasourceID> datasources;
+    SegmentNodeVector nodes;
+    SegmentWeightVector fwd_weights;
+    SegmentWeightVector rev_weights;
+    SegmentDurationVector fwd_durations;
+    SegmentDurationVector rev_durations;
+    SegmentDatasourceVector datasources;
 };
 }
 
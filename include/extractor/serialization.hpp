@@ -9,7 +9,11 @@
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
 
-#include <boost/assert.hpp>
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -28,16 +32,56 @@ inline void write(storage::io::FileWriter &writer, Datasources &sources)
     writer.WriteFrom(sources);
 }
 
+template <typename T>
+inline void readSegmentValues(storage::io::FileReader &reader, std::vector<T> &values)
+{
+    storage::serialization::read(reader, values);
+}
+
+// The file stores the values unpacked, they are packed while loading them into memory.
+// Writers clip the values to the packed range, larger values would be silently truncated.
+template <typename T, std::size_t Bits>
+inline void readSegmentValues(storage::io::FileReader &reader,
+                              util::PackedVectorView<T, Bits> &packed_values)
+{
+    std::vector<T> values;
+    storage::serialization::read(reader, values);
+    for (const auto value : values)
+    {
+        if (value >= (1ULL << Bits))
+        {
+            throw util::exception("Segment value " + std::to_string(value) +
+                                  " does not fit into " + std::to_string(Bits) + " bits" +
+                                  SOURCE_REF);
+        }
+        packed_values.push_back(value);
+    }
+}
+
+template <typename T>
+inline void writeSegmentValues(storage::io::FileWriter &writer, const std::vector<T> &values)
+{
+    storage::serialization::write(writer, values);
+}
+
+template <typename T, std::size_t Bits>
+inline void writeSegmentValues(storage::io::FileWriter &writer,
+                               const util::PackedVectorView<T, Bits> &packed_values)
+{
+    const std::vector<T> values(packed_values.begin(), packed_values.end());
+    storage::serialization::write(writer, values);
+}
+
 template <storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader,
                  detail::SegmentDataContainerImpl<Ownership> &segment_data)
 {
     storage::serialization::read(reader, segment_data.index);
     storage::serialization::read(reader, segment_data.nodes);
-    storage::serialization::read(reader, segment_data.fwd_weights);
-    storage::serialization::read(reader, segment_data.rev_weights);
-    storage::serialization::read(reader, segment_data.fwd_durations);
-    storage::serialization::read(reader, segment_data.rev_durations);
+    readSegmentValues(reader, segment_data.fwd_weights);
+    readSegmentValues(reader, segment_data.rev_weights);
+    readSegmentValues(reader, segment_data.fwd_durations);
+    readSegmentValues(reader, segment_data.rev_durations);
     storage::serialization::read(reader, segment_data.datasources);
 }
 
@@ -47,10 +91,10 @@ inline void write(storage::io::FileWriter &writer,
 {
     storage::serialization::write(writer, segment_data.index);
     storage::serialization::write(writer, segment_data.nodes);
-    storage::serialization::write(writer, segment_data.fwd_weights);
-    storage::serialization::write(writer, segment_data.rev_weights);
-    storage::serialization::write(writer, segment_data.fwd_durations);
-    storage::serialization::write(writer, segment_data.rev_durations);
+    writeSegmentValues(writer, segment_data.fwd_weights);
+    writeSegmentValues(writer, segment_data.rev_weights);
+    writeSegmentValues(writer, segment_data.fwd_durations);
+    writeSegmentValues(writer, segment_data.rev_durations);
     storage::serialization::write(writer, segment_data.datasources);
 }
 
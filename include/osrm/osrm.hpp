@@ -44,6 +44,7 @@ using engine::api::NearestParameters;
 using engine::api::TripParameters;
 using engine::api::MatchParameters;
 using engine::api::TileParameters;
+using engine::api::IsochroneParameters;
 
 /**
  * Represents a Open Source Routing Machine with access to its services.
@@ -56,6 +57,8 @@ using engine::api::TileParameters;
  *  - Trip: shortest round trip between coordinates
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
+ *  - Isochrone: area reachable from a coordinate within travel times
+ *  - MemoryUsage: size and usage of the blocks of the loaded dataset
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
  */
@@ -130,6 +133,23 @@ class OSRM final
      */
     Status Tile(const TileParameters &parameters, std::string &result) const;
 
+    /**
+     * Isochrone: area reachable from a coordinate within travel times
+     *
+     * \param parameters isochrone query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, IsochroneParameters and json::Object
+     */
+    Status Isochrone(const IsochroneParameters &parameters, json::Object &result) const;
+
+    /**
+     * MemoryUsage: size, resident size and sampled access count of every block of the dataset
+     *
+     * \return Status indicating success for the query or failure
+     * \see Status and json::Object
+     */
+    Status MemoryUsage(json::Object &result) const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
 };
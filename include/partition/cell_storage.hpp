@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -35,9 +36,12 @@ using CellStorageView = detail::CellStorageImpl<storage::Ownership::View>;
 namespace serialization
 {
 template <storage::Ownership Ownership>
-inline void read(storage::io::FileReader &reader, detail::CellStorageImpl<Ownership> &storage);
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 detail::CellStorageImpl<Ownership> &storage);
 template <storage::Ownership Ownership>
-inline void write(storage::io::FileWriter &writer,
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
                   const detail::CellStorageImpl<Ownership> &storage);
 }
 
@@ -352,9 +356,11 @@ template <storage::Ownership Ownership> class CellStorageImpl
             cells[cell_index], weights.data(), source_boundary.data(), destination_boundary.data()};
     }
 
-    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+    friend void serialization::read<Ownership>(storage::container::FileReader &reader,
+                                               const std::string &name,
                                                detail::CellStorageImpl<Ownership> &storage);
-    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+    friend void serialization::write<Ownership>(storage::container::FileWriter &writer,
+                                                const std::string &name,
                                                 const detail::CellStorageImpl<Ownership> &storage);
 
   private:
@@ -5,7 +5,7 @@
 
 #include "partition/serialization.hpp"
 
-#include "storage/io.hpp"
+#include "storage/container.hpp"
 
 namespace osrm
 {
@@ -22,10 +22,9 @@ inline void readGraph(const boost::filesystem::path &path, MultiLevelGraphT &gra
                       std::is_same<customizer::MultiLevelEdgeBasedGraph, MultiLevelGraphT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
-    storage::io::FileReader reader{path, fingerprint};
+    storage::container::FileReader reader{path};
 
-    serialization::read(reader, graph);
+    serialization::read(reader, "/mld/multilevelgraph", graph);
 }
 
 // writes .osrm.mldgr file
@@ -36,10 +35,10 @@ inline void writeGraph(const boost::filesystem::path &path, const MultiLevelGrap
                       std::is_same<customizer::MultiLevelEdgeBasedGraph, MultiLevelGraphT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
-    storage::io::FileWriter writer{path, fingerprint};
+    storage::container::FileWriter writer{path};
 
-    serialization::write(writer, graph);
+    serialization::write(writer, "/mld/multilevelgraph", graph);
+    writer.Finish();
 }
 
 // read .osrm.partition file
@@ -50,10 +49,9 @@ inline void readPartition(const boost::filesystem::path &path, MultiLevelPartiti
                       std::is_same<MultiLevelPartition, MultiLevelPartitionT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
-    storage::io::FileReader reader{path, fingerprint};
+    storage::container::FileReader reader{path};
 
-    serialization::read(reader, mlp);
+    serialization::read(reader, "/mld/multilevelpartition", mlp);
 }
 
 // writes .osrm.partition file
@@ -64,10 +62,10 @@ inline void writePartition(const boost::filesystem::path &path, const MultiLevel
                       std::is_same<MultiLevelPartition, MultiLevelPartitionT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
-    storage::io::FileWriter writer{path, fingerprint};
+    storage::container::FileWriter writer{path};
 
-    serialization::write(writer, mlp);
+    serialization::write(writer, "/mld/multilevelpartition", mlp);
+    writer.Finish();
 }
 
 // reads .osrm.cells file
@@ -78,10 +76,9 @@ inline void readCells(const boost::filesystem::path &path, CellStorageT &storage
                       std::is_same<CellStorage, CellStorageT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
-    storage::io::FileReader reader{path, fingerprint};
+    storage::container::FileReader reader{path};
 
-    serialization::read(reader, storage);
+    serialization::read(reader, "/mld/cellstorage", storage);
 }
 
 // writes .osrm.cells file
@@ -92,10 +89,10 @@ inline void writeCells(const boost::filesystem::path &path, CellStorageT &storag
                       std::is_same<CellStorage, CellStorageT>::value,
                   "");
 
-    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
-    storage::io::FileWriter writer{path, fingerprint};
+    storage::container::FileWriter writer{path};
 
-    serialization::write(writer, storage);
+    serialization::write(writer, "/mld/cellstorage", storage);
+    writer.Finish();
 }
 }
 }
@@ -14,6 +14,8 @@
 #include <boost/iterator/permutation_iterator.hpp>
 #include <boost/range/combine.hpp>
 
+#include <string>
+
 namespace osrm
 {
 
@@ -24,10 +26,14 @@ template <typename EdgeDataT, storage::Ownership Ownership> class MultiLevelGrap
 namespace serialization
 {
 template <typename EdgeDataT, storage::Ownership Ownership>
-void read(storage::io::FileReader &reader, MultiLevelGraph<EdgeDataT, Ownership> &graph);
+void read(storage::container::FileReader &reader,
+          const std::string &name,
+          MultiLevelGraph<EdgeDataT, Ownership> &graph);
 
 template <typename EdgeDataT, storage::Ownership Ownership>
-void write(storage::io::FileWriter &writer, const MultiLevelGraph<EdgeDataT, Ownership> &graph);
+void write(storage::container::FileWriter &writer,
+           const std::string &name,
+           const MultiLevelGraph<EdgeDataT, Ownership> &graph);
 }
 
 template <typename EdgeDataT, storage::Ownership Ownership>
@@ -194,10 +200,12 @@ class MultiLevelGraph : public util::StaticGraph<EdgeDataT, Ownership>
     }
 
     friend void
-    serialization::read<EdgeDataT, Ownership>(storage::io::FileReader &reader,
+    serialization::read<EdgeDataT, Ownership>(storage::container::FileReader &reader,
+                                              const std::string &name,
                                               MultiLevelGraph<EdgeDataT, Ownership> &graph);
     friend void
-    serialization::write<EdgeDataT, Ownership>(storage::io::FileWriter &writer,
+    serialization::write<EdgeDataT, Ownership>(storage::container::FileWriter &writer,
+                                               const std::string &name,
                                                const MultiLevelGraph<EdgeDataT, Ownership> &graph);
 
     Vector<EdgeOffset> node_to_edge_offset;
@@ -16,6 +16,7 @@
 #include <cmath>
 #include <cstdint>
 #include <numeric>
+#include <string>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -34,9 +35,13 @@ using MultiLevelPartitionView = detail::MultiLevelPartitionImpl<storage::Ownersh
 namespace serialization
 {
 template <storage::Ownership Ownership>
-void read(storage::io::FileReader &reader, detail::MultiLevelPartitionImpl<Ownership> &mlp);
+void read(storage::container::FileReader &reader,
+          const std::string &name,
+          detail::MultiLevelPartitionImpl<Ownership> &mlp);
 template <storage::Ownership Ownership>
-void write(storage::io::FileWriter &writer, const detail::MultiLevelPartitionImpl<Ownership> &mlp);
+void write(storage::container::FileWriter &writer,
+           const std::string &name,
+           const detail::MultiLevelPartitionImpl<Ownership> &mlp);
 }
 
 namespace detail
@@ -136,9 +141,11 @@ template <storage::Ownership Ownership> class MultiLevelPartitionImpl final
         return cell_to_children[offset + cell + 1];
     }
 
-    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+    friend void serialization::read<Ownership>(storage::container::FileReader &reader,
+                                               const std::string &name,
                                                MultiLevelPartitionImpl &mlp);
-    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+    friend void serialization::write<Ownership>(storage::container::FileWriter &writer,
+                                                const std::string &name,
                                                 const MultiLevelPartitionImpl &mlp);
 
   private:
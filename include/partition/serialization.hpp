@@ -6,10 +6,11 @@
 #include "partition/multi_level_graph.hpp"
 #include "partition/multi_level_partition.hpp"
 
-#include "storage/io.hpp"
-#include "storage/serialization.hpp"
+#include "storage/container.hpp"
 #include "storage/shared_memory_ownership.hpp"
 
+#include <string>
+
 namespace osrm
 {
 namespace partition
@@ -18,58 +19,67 @@ namespace serialization
 {
 
 template <typename EdgeDataT, storage::Ownership Ownership>
-inline void read(storage::io::FileReader &reader, MultiLevelGraph<EdgeDataT, Ownership> &graph)
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 MultiLevelGraph<EdgeDataT, Ownership> &graph)
 {
-    storage::serialization::read(reader, graph.node_array);
-    storage::serialization::read(reader, graph.edge_array);
-    storage::serialization::read(reader, graph.node_to_edge_offset);
+    reader.ReadInto(name + "/node_array", graph.node_array);
+    reader.ReadInto(name + "/edge_array", graph.edge_array);
+    reader.ReadInto(name + "/node_to_edge_offset", graph.node_to_edge_offset);
 }
 
 template <typename EdgeDataT, storage::Ownership Ownership>
-inline void write(storage::io::FileWriter &writer,
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
                   const MultiLevelGraph<EdgeDataT, Ownership> &graph)
 {
-    storage::serialization::write(writer, graph.node_array);
-    storage::serialization::write(writer, graph.edge_array);
-    storage::serialization::write(writer, graph.node_to_edge_offset);
+    writer.WriteFrom(name + "/node_array", graph.node_array);
+    writer.WriteFrom(name + "/edge_array", graph.edge_array);
+    writer.WriteFrom(name + "/node_to_edge_offset", graph.node_to_edge_offset);
 }
 
 template <storage::Ownership Ownership>
-inline void read(storage::io::FileReader &reader, detail::MultiLevelPartitionImpl<Ownership> &mlp)
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 detail::MultiLevelPartitionImpl<Ownership> &mlp)
 {
-    reader.ReadInto(*mlp.level_data);
-    storage::serialization::read(reader, mlp.partition);
-    storage::serialization::read(reader, mlp.cell_to_children);
+    reader.ReadInto(name + "/level_data", *mlp.level_data);
+    reader.ReadInto(name + "/partition", mlp.partition);
+    reader.ReadInto(name + "/cell_to_children", mlp.cell_to_children);
 }
 
 template <storage::Ownership Ownership>
-inline void write(storage::io::FileWriter &writer,
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
                   const detail::MultiLevelPartitionImpl<Ownership> &mlp)
 {
-    writer.WriteOne(*mlp.level_data);
-    storage::serialization::write(writer, mlp.partition);
-    storage::serialization::write(writer, mlp.cell_to_children);
+    writer.WriteFrom(name + "/level_data", *mlp.level_data);
+    writer.WriteFrom(name + "/partition", mlp.partition);
+    writer.WriteFrom(name + "/cell_to_children", mlp.cell_to_children);
 }
 
 template <storage::Ownership Ownership>
-inline void read(storage::io::FileReader &reader, detail::CellStorageImpl<Ownership> &storage)
+inline void read(storage::container::FileReader &reader,
+                 const std::string &name,
+                 detail::CellStorageImpl<Ownership> &storage)
 {
-    storage::serialization::read(reader, storage.weights);
-    storage::serialization::read(reader, storage.source_boundary);
-    storage::serialization::read(reader, storage.destination_boundary);
-    storage::serialization::read(reader, storage.cells);
-    storage::serialization::read(reader, storage.level_to_cell_offset);
+    reader.ReadInto(name + "/weights", storage.weights);
+    reader.ReadInto(name + "/source_boundary", storage.source_boundary);
+    reader.ReadInto(name + "/destination_boundary", storage.destination_boundary);
+    reader.ReadInto(name + "/cells", storage.cells);
+    reader.ReadInto(name + "/level_to_cell_offset", storage.level_to_cell_offset);
 }
 
 template <storage::Ownership Ownership>
-inline void write(storage::io::FileWriter &writer,
+inline void write(storage::container::FileWriter &writer,
+                  const std::string &name,
                   const detail::CellStorageImpl<Ownership> &storage)
 {
-    storage::serialization::write(writer, storage.weights);
-    storage::serialization::write(writer, storage.source_boundary);
-    storage::serialization::write(writer, storage.destination_boundary);
-    storage::serialization::write(writer, storage.cells);
-    storage::serialization::write(writer, storage.level_to_cell_offset);
+    writer.WriteFrom(name + "/weights", storage.weights);
+    writer.WriteFrom(name + "/source_boundary", storage.source_boundary);
+    writer.WriteFrom(name + "/destination_boundary", storage.destination_boundary);
+    writer.WriteFrom(name + "/cells", storage.cells);
+    writer.WriteFrom(name + "/level_to_cell_offset", storage.level_to_cell_offset);
 }
 }
 }
@@ -34,7 +34,8 @@ class ServiceHandlerInterface
 class ServiceHandler final : public ServiceHandlerInterface
 {
   public:
-    ServiceHandler(osrm::EngineConfig &config);
+    // The admin service reports internals of the instance and is only served if enabled
+    ServiceHandler(osrm::EngineConfig &config, const bool enable_admin);
     using ResultT = service::BaseService::ResultT;
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
@@ -0,0 +1,279 @@
+#ifndef OSRM_STORAGE_CONTAINER_HPP_
+#define OSRM_STORAGE_CONTAINER_HPP_
+
+#include "storage/io.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/log.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+namespace container
+{
+
+// Self-describing container for the binary data files.
+//
+// [FingerPrint][Header][section 0]...[section n][section index]
+//
+// Every section holds a named array of trivially copyable elements. Sections start at a
+// multiple of SECTION_ALIGNMENT from the beginning of the file, so they can be memory mapped
+// directly. The index at the end of the file stores name, position, element count and size
+// and a CRC32 of each section, a reader only needs the header and the index to read any
+// section in O(1). Readers of the same file are independent and can be used in parallel.
+namespace detail
+{
+constexpr const std::array<char, 8> MAGIC = {{'O', 'S', 'R', 'M', 'C', 'O', 'N', 'T'}};
+constexpr const std::uint32_t VERSION = 1;
+}
+
+constexpr const std::uint64_t SECTION_ALIGNMENT = 64;
+constexpr const std::size_t MAX_SECTION_NAME_LENGTH = 64;
+
+struct Header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t number_of_sections;
+    std::uint64_t index_offset;
+};
+
+struct SectionEntry
+{
+    std::array<char, MAX_SECTION_NAME_LENGTH> name;
+    std::uint64_t offset;
+    std::uint64_t count;
+    std::uint64_t size;
+    std::uint32_t element_size;
+    std::uint32_t checksum;
+};
+
+static_assert(sizeof(Header) == 24, "Container header has unexpected size");
+static_assert(sizeof(SectionEntry) == 96, "Container section entry has unexpected size");
+
+inline std::uint32_t computeChecksum(const void *data, const std::uint64_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+class FileReader
+{
+  public:
+    enum ChecksumFlag
+    {
+        VerifyChecksum,
+        SkipChecksum
+    };
+
+    FileReader(const boost::filesystem::path &path_, const ChecksumFlag flag = VerifyChecksum)
+        : path(path_), reader(path_, io::FileReader::VerifyFingerprint), checksum(flag)
+    {
+        const auto header = reader.ReadOne<Header>();
+        if (header.magic != detail::MAGIC)
+        {
+            throw util::exception("Invalid container header in " + path.string() + SOURCE_REF);
+        }
+        if (header.version != detail::VERSION)
+        {
+            throw util::exception("Unsupported container version " +
+                                  std::to_string(header.version) + " in " + path.string() +
+                                  SOURCE_REF);
+        }
+
+        std::vector<SectionEntry> entries(header.number_of_sections);
+        reader.Seek(header.index_offset);
+        reader.ReadInto(entries);
+        for (const auto &entry : entries)
+        {
+            sections.emplace(std::string(entry.name.data()), entry);
+        }
+    }
+
+    bool HasSection(const std::string &name) const { return sections.count(name) > 0; }
+
+    const SectionEntry &GetSection(const std::string &name) const
+    {
+        const auto iter = sections.find(name);
+        if (iter == sections.end())
+        {
+            throw util::exception("Section " + name + " not found in " + path.string() +
+                                  SOURCE_REF);
+        }
+        return iter->second;
+    }
+
+    std::uint64_t GetElementCount(const std::string &name) const
+    {
+        return GetSection(name).count;
+    }
+
+    // Position of the section data relative to the start of the file
+    std::uint64_t GetOffset(const std::string &name) const { return GetSection(name).offset; }
+
+    template <typename T> void ReadInto(const std::string &name, T *dest, const std::size_t count)
+    {
+        const auto &entry = GetSection(name);
+        if (entry.element_size != sizeof(T) || entry.count != count)
+        {
+            throw util::exception("Section " + name + " in " + path.string() +
+                                  " does not match the expected size" + SOURCE_REF);
+        }
+
+        reader.Seek(entry.offset);
+        reader.ReadInto(dest, count);
+
+        if (checksum == VerifyChecksum && computeChecksum(dest, entry.size) != entry.checksum)
+        {
+            throw util::exception("Checksum mismatch of section " + name + " in " +
+                                  path.string() + SOURCE_REF);
+        }
+    }
+
+    template <typename T> void ReadInto(const std::string &name, std::vector<T> &target)
+    {
+        target.resize(GetElementCount(name));
+        ReadInto(name, target.data(), target.size());
+    }
+
+    template <typename T> void ReadInto(const std::string &name, util::vector_view<T> &target)
+    {
+        ReadInto(name, target.data(), target.size());
+    }
+
+    template <typename T> void ReadInto(const std::string &name, T &target)
+    {
+        ReadInto(name, &target, 1);
+    }
+
+  private:
+    const boost::filesystem::path path;
+    io::FileReader reader;
+    ChecksumFlag checksum;
+    std::unordered_map<std::string, SectionEntry> sections;
+};
+
+class FileWriter
+{
+  public:
+    FileWriter(const boost::filesystem::path &path_)
+        : path(path_), writer(path_, io::FileWriter::GenerateFingerprint),
+          position(sizeof(util::FingerPrint) + sizeof(Header))
+    {
+        // the header is written once the position of the index is known
+        writer.Skip<Header>(1);
+    }
+
+    // Finish has to be called explicitly, the destructor must not throw
+    ~FileWriter()
+    {
+        if (!finished)
+        {
+            util::Log(logWARNING) << path.string() << " was not finished and can not be read";
+        }
+    }
+
+    template <typename T>
+    void WriteFrom(const std::string &name, const T *src, const std::size_t count)
+    {
+        BOOST_ASSERT(!finished);
+        if (name.empty() || name.size() >= MAX_SECTION_NAME_LENGTH)
+        {
+            throw util::exception("Invalid section name " + name + SOURCE_REF);
+        }
+        if (std::find_if(entries.begin(), entries.end(), [&](const SectionEntry &entry) {
+                return name == entry.name.data();
+            }) != entries.end())
+        {
+            throw util::exception("Duplicate section " + name + " in " + path.string() +
+                                  SOURCE_REF);
+        }
+
+        Align();
+
+        SectionEntry entry;
+        entry.name.fill('\0');
+        std::copy(name.begin(), name.end(), entry.name.begin());
+        entry.offset = position;
+        entry.count = count;
+        entry.size = count * sizeof(T);
+        entry.element_size = sizeof(T);
+        entry.checksum = computeChecksum(src, entry.size);
+        entries.push_back(entry);
+
+        writer.WriteFrom(src, count);
+        position += entry.size;
+    }
+
+    template <typename T> void WriteFrom(const std::string &name, const std::vector<T> &src)
+    {
+        WriteFrom(name, src.data(), src.size());
+    }
+
+    template <typename T>
+    void WriteFrom(const std::string &name, const util::vector_view<T> &src)
+    {
+        WriteFrom(name, src.data(), src.size());
+    }
+
+    template <typename T> void WriteFrom(const std::string &name, const T &src)
+    {
+        WriteFrom(name, &src, 1);
+    }
+
+    // Writes the section index and the header, the file is only readable afterwards
+    void Finish()
+    {
+        BOOST_ASSERT(!finished);
+        Align();
+
+        Header header;
+        header.magic = detail::MAGIC;
+        header.version = detail::VERSION;
+        header.number_of_sections = entries.size();
+        header.index_offset = position;
+
+        writer.WriteFrom(entries);
+        writer.SkipToBeginning();
+        writer.WriteOne(header);
+        finished = true;
+    }
+
+  private:
+    void Align()
+    {
+        const auto padding = (SECTION_ALIGNMENT - position % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+        const std::array<char, SECTION_ALIGNMENT> zeros = {};
+        writer.WriteFrom(zeros.data(), padding);
+        position += padding;
+    }
+
+    const boost::filesystem::path path;
+    io::FileWriter writer;
+    std::uint64_t position;
+    std::vector<SectionEntry> entries;
+    bool finished = false;
+};
+}
+}
+}
+
+#endif
@@ -127,6 +127,12 @@ class FileReader
         boost::iostreams::seek(input_stream, element_count * sizeof(T), BOOST_IOS::cur);
     }
 
+    // Moves to an absolute position, the fingerprint is part of the offset
+    void Seek(const std::uint64_t position)
+    {
+        boost::iostreams::seek(input_stream, position, BOOST_IOS::beg);
+    }
+
     /*******************************************/
 
     std::uint64_t ReadElementCount64() { return ReadOne<std::uint64_t>(); }
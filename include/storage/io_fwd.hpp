@@ -12,6 +12,14 @@ class FileReader;
 class FileWriter;
 
 } // ns io
+
+namespace container
+{
+
+class FileReader;
+class FileWriter;
+
+} // ns container
 } // ns storage
 } // ns osrm
 
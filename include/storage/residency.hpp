@@ -0,0 +1,43 @@
+#ifndef OSRM_STORAGE_RESIDENCY_HPP_
+#define OSRM_STORAGE_RESIDENCY_HPP_
+
+#include "storage/shared_datatype.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+// Memory of a single block. The blocks of one dataset can be spread over several regions.
+struct BlockMemory
+{
+    DataLayout::BlockID id;
+    const char *begin;
+    std::uint64_t size;
+};
+
+// Blocks that are read by almost every query: the search graphs, the rtree and the segment
+// data of snapped and unpacked edges. The blocks of the algorithms that are not used are empty.
+std::vector<DataLayout::BlockID> getHotBlocks();
+
+// Memory of the given blocks of a dataset in a single region
+std::vector<BlockMemory> getBlockMemory(const DataLayout &layout,
+                                        const char *memory,
+                                        const std::vector<DataLayout::BlockID> &blocks);
+
+// Reads every page of the blocks in parallel so they are faulted in before the first query.
+// With lock the pages are pinned in RAM, returns false if that is not possible.
+bool prewarmBlocks(const std::vector<BlockMemory> &blocks, const bool lock);
+
+// Number of bytes of the memory range that are resident in RAM
+std::uint64_t getResidentSize(const char *begin, const std::uint64_t size);
+
+// Logs the resident and total size of every non-empty block
+void logResidency(const std::vector<BlockMemory> &blocks);
+}
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <boost/assert.hpp>
 
 #include <array>
+#include <bitset>
 #include <cstdint>
 
 namespace osrm
@@ -65,7 +66,18 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "MLD_CELL_LEVEL_OFFSETS",
                                             "MLD_GRAPH_NODE_LIST",
                                             "MLD_GRAPH_EDGE_LIST",
-                                            "MLD_GRAPH_NODE_TO_OFFSET"};
+                                            "MLD_GRAPH_NODE_TO_OFFSET",
+                                            "MLD_OVERLAY_LEVEL_OFFSETS",
+                                            "MLD_OVERLAY_CELL_OFFSETS",
+                                            "MLD_OVERLAY_FWD_NODES",
+                                            "MLD_OVERLAY_FWD_ARCS",
+                                            "MLD_OVERLAY_BWD_NODES",
+                                            "MLD_OVERLAY_BWD_ARCS",
+                                            "SNAPPING_GRID_CELL_SIZE",
+                                            "SNAPPING_GRID_CELLS",
+                                            "SNAPPING_GRID_CELL_OFFSETS",
+                                            "SNAPPING_GRID_LEAF_IDS",
+                                            "R_SEARCH_TREE_LEAVES"};
 
 struct DataLayout
 {
@@ -119,6 +131,17 @@ struct DataLayout
         MLD_GRAPH_NODE_LIST,
         MLD_GRAPH_EDGE_LIST,
         MLD_GRAPH_NODE_TO_OFFSET,
+        MLD_OVERLAY_LEVEL_OFFSETS,
+        MLD_OVERLAY_CELL_OFFSETS,
+        MLD_OVERLAY_FWD_NODES,
+        MLD_OVERLAY_FWD_ARCS,
+        MLD_OVERLAY_BWD_NODES,
+        MLD_OVERLAY_BWD_ARCS,
+        SNAPPING_GRID_CELL_SIZE,
+        SNAPPING_GRID_CELLS,
+        SNAPPING_GRID_CELL_OFFSETS,
+        SNAPPING_GRID_LEAF_IDS,
+        R_SEARCH_TREE_LEAVES,
         NUM_BLOCKS
     };
 
@@ -228,7 +251,23 @@ enum SharedDataType
 {
     REGION_NONE,
     REGION_1,
-    REGION_2
+    REGION_2,
+    REGION_3
+};
+
+// Header at the start of every shared memory region, followed by the data of the layout.
+// A region either holds the full dataset or only the blocks marked in `blocks`, in which
+// case all other blocks are read from the full dataset in `base_region`.
+struct SharedRegionHeader
+{
+    SharedRegionHeader() : base_region(REGION_NONE) {}
+
+    bool IsIncremental() const { return base_region != REGION_NONE; }
+    bool HasBlock(DataLayout::BlockID bid) const { return !IsIncremental() || blocks.test(bid); }
+
+    SharedDataType base_region;
+    std::bitset<DataLayout::NUM_BLOCKS> blocks;
+    DataLayout layout;
 };
 
 struct SharedDataTimestamp
@@ -252,6 +291,8 @@ inline std::string regionToString(const SharedDataType region)
         return "REGION_1";
     case REGION_2:
         return "REGION_2";
+    case REGION_3:
+        return "REGION_3";
     case REGION_NONE:
         return "REGION_NONE";
     default:
@@ -15,13 +15,20 @@
 #endif
 
 #ifdef __linux__
+#include <linux/mempolicy.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
+#include <climits>
 #include <cstdint>
+#include <cstring>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <exception>
 #include <thread>
 
@@ -42,6 +49,24 @@ struct OSRMLockFile
     }
 };
 
+// Page size backing a newly created shared memory region
+enum class HugePages
+{
+    None,
+    Huge2MB,
+    Huge1GB
+};
+
+struct SharedMemoryOptions
+{
+    HugePages huge_pages = HugePages::None;
+    // spread the pages of the region evenly over all NUMA nodes
+    bool numa_interleave = false;
+    // touch the blocks read by every query before clients are notified and log how much
+    // of them is resident
+    bool prewarm = false;
+};
+
 #ifndef _WIN32
 class SharedMemory
 {
@@ -54,7 +79,8 @@ class SharedMemory
     template <typename IdentifierT>
     SharedMemory(const boost::filesystem::path &lock_file,
                  const IdentifierT id,
-                 const uint64_t size = 0)
+                 const uint64_t size = 0,
+                 const SharedMemoryOptions &options = {})
         : key(lock_file.string().c_str(), id)
     {
         // open only
@@ -69,10 +95,17 @@ class SharedMemory
         // open or create
         else
         {
+            auto region_size = size;
+#ifdef __linux__
+            if (options.huge_pages != HugePages::None)
+            {
+                region_size = CreateHugePageSegment(size, options.huge_pages);
+            }
+#endif
             shm = boost::interprocess::xsi_shared_memory(
-                boost::interprocess::open_or_create, key, size);
+                boost::interprocess::open_or_create, key, region_size);
             util::Log(logDEBUG) << "opening/creating " << shm.get_shmid() << " from id " << id
-                                << " with size " << size;
+                                << " with size " << region_size;
 #ifdef __linux__
             if (-1 == shmctl(shm.get_shmid(), SHM_LOCK, nullptr))
             {
@@ -83,6 +116,12 @@ class SharedMemory
             }
 #endif
             region = boost::interprocess::mapped_region(shm, boost::interprocess::read_write);
+#ifdef __linux__
+            if (options.numa_interleave)
+            {
+                InterleaveNUMANodes();
+            }
+#endif
         }
     }
 
@@ -110,8 +149,12 @@ class SharedMemory
     }
 
 #ifdef __linux__
-    void WaitForDetach()
+    // Waits until all other processes detached, returns false if some are still attached
+    // after max_wait seconds. A negative max_wait waits without a limit.
+    bool WaitForDetach(const int max_wait = -1)
     {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(std::max(max_wait, 0));
         auto shmid = shm.get_shmid();
         ::shmid_ds xsi_ds;
         const auto errorToMessage = [](int error) -> std::string {
@@ -147,20 +190,82 @@ class SharedMemory
             }
             BOOST_ASSERT(ret >= 0);
 
+            if (xsi_ds.shm_nattch <= 1)
+            {
+                return true;
+            }
+
             std::this_thread::sleep_for(std::chrono::microseconds(100));
-        } while (xsi_ds.shm_nattch > 1);
+        } while (max_wait < 0 || std::chrono::steady_clock::now() < deadline);
+
+        return false;
     }
 #else
-    void WaitForDetach()
+    bool WaitForDetach(const int /* max_wait */ = -1)
     {
         util::Log(logDEBUG)
             << "Shared memory support for non-Linux systems does not wait for clients to "
                "dettach. Going to sleep for 50ms.";
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return true;
     }
 #endif
 
   private:
+#ifdef __linux__
+    // Creates the segment with huge pages, open_or_create will then only open it.
+    // Returns the size rounded to full huge pages or the unchanged size if no
+    // huge pages are available and normal pages need to be used.
+    uint64_t CreateHugePageSegment(const uint64_t size, const HugePages huge_pages)
+    {
+        const int page_shift = huge_pages == HugePages::Huge1GB ? 30 : 21;
+        const uint64_t page_size = uint64_t{1} << page_shift;
+        const uint64_t rounded_size = (size + page_size - 1) / page_size * page_size;
+
+        // see linux/shm.h, not exposed by all libc versions
+        const int huge_page_shift = 26;
+        const int flags = IPC_CREAT | 0644 | SHM_HUGETLB | (page_shift << huge_page_shift);
+        if (-1 == ::shmget(key.get_key(), rounded_size, flags))
+        {
+            const auto error_code = errno;
+            util::Log(logWARNING) << "could not allocate shared memory with "
+                                  << (page_size >> 20) << "MB huge pages ("
+                                  << std::strerror(error_code) << "), using normal pages";
+            return size;
+        }
+        return rounded_size;
+    }
+
+    // Sets an interleaved memory policy on the region so that pages are spread
+    // round-robin over all NUMA nodes this process may allocate memory on.
+    void InterleaveNUMANodes()
+    {
+        const constexpr unsigned long MAX_NODES = 4096;
+        std::array<unsigned long, MAX_NODES / (sizeof(unsigned long) * CHAR_BIT)> nodes{};
+
+        int mode;
+        // mbind ignores the last bit of the node mask, hence MAX_NODES + 1
+        if (-1 == ::syscall(SYS_get_mempolicy,
+                            &mode,
+                            nodes.data(),
+                            MAX_NODES,
+                            nullptr,
+                            MPOL_F_MEMS_ALLOWED) ||
+            -1 == ::syscall(SYS_mbind,
+                            region.get_address(),
+                            region.get_size(),
+                            MPOL_INTERLEAVE,
+                            nodes.data(),
+                            MAX_NODES + 1,
+                            MPOL_MF_MOVE))
+        {
+            const auto error_code = errno;
+            util::Log(logWARNING) << "could not interleave shared memory over NUMA nodes ("
+                                  << std::strerror(error_code) << ")";
+        }
+    }
+#endif
+
     static bool RegionExists(const boost::interprocess::xsi_key &key)
     {
         bool result = true;
@@ -201,7 +306,10 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
-    SharedMemory(const boost::filesystem::path &lock_file, const int id, const uint64_t size = 0)
+    SharedMemory(const boost::filesystem::path &lock_file,
+                 const int id,
+                 const uint64_t size = 0,
+                 const SharedMemoryOptions & /*options*/ = {})
     {
         sprintf(key, "%s.%d", "osrm.lock", id);
         if (0 == size)
@@ -244,12 +352,13 @@ class SharedMemory
         return Remove(k);
     }
 
-    void WaitForDetach()
+    bool WaitForDetach(const int /* max_wait */ = -1)
     {
         // FIXME this needs an implementation for Windows
         util::Log(logDEBUG) << "Shared memory support for Windows does not wait for clients to "
                                "dettach. Going to sleep for 50ms.";
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return true;
     }
 
   private:
@@ -283,7 +392,9 @@ class SharedMemory
 #endif
 
 template <typename IdentifierT, typename LockFileT = OSRMLockFile>
-std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint64_t size = 0)
+std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id,
+                                               const uint64_t size = 0,
+                                               const SharedMemoryOptions &options = {})
 {
     try
     {
@@ -299,7 +410,7 @@ std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint
                 boost::filesystem::ofstream ofs(lock_file());
             }
         }
-        return std::make_unique<SharedMemory>(lock_file(), id, size);
+        return std::make_unique<SharedMemory>(lock_file(), id, size, options);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
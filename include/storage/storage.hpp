@@ -29,11 +29,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define STORAGE_HPP
 
 #include "storage/shared_datatype.hpp"
+#include "storage/shared_memory.hpp"
 #include "storage/storage_config.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <bitset>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -42,15 +46,39 @@ namespace storage
 class Storage
 {
   public:
-    Storage(StorageConfig config);
+    Storage(StorageConfig config, SharedMemoryOptions memory_options = {});
 
-    int Run(int max_wait);
+    using BlockSet = std::bitset<DataLayout::NUM_BLOCKS>;
+
+    // Loads the dataset into a new shared memory region. If update_blocks is not empty
+    // only these blocks are loaded and all others are shared with the currently active
+    // full dataset. A negative max_wait waits without a limit for the region lock and for the
+    // clients of the previous region to detach.
+    int Run(int max_wait, const std::vector<DataLayout::BlockID> &update_blocks = {});
 
     void PopulateLayout(DataLayout &layout);
     void PopulateData(const DataLayout &layout, char *memory_ptr);
+    void PopulateData(const DataLayout &layout, char *memory_ptr, const BlockSet &blocks);
+
+    // Blocks can only be loaded together with all other blocks that are read from the same
+    // file, and the outputs of osrm-customize only together with each other. Returns the
+    // requested blocks extended by these blocks.
+    BlockSet GetLoadedBlocks(const BlockSet &requested);
 
   private:
+    // A unit of work of PopulateData. Every task reads its own input file and
+    // only writes the blocks it lists, so tasks can be executed concurrently.
+    struct LoadTask
+    {
+        std::string name;
+        std::vector<DataLayout::BlockID> blocks;
+        std::function<void()> load;
+    };
+
+    std::vector<LoadTask> MakeLoadTasks(const DataLayout &layout, char *memory_ptr);
+
     StorageConfig config;
+    SharedMemoryOptions memory_options;
 };
 }
 }
@@ -54,6 +54,7 @@ struct StorageConfig final
 
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
+    boost::filesystem::path snapping_grid_path;
     boost::filesystem::path hsgr_data_path;
     boost::filesystem::path nodes_data_path;
     boost::filesystem::path edges_data_path;
@@ -72,6 +73,13 @@ struct StorageConfig final
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path mld_overlay_path;
+    // image of the loaded dataset used when memory mapping the data
+    boost::filesystem::path mmap_image_path;
+
+    // Copy the rtree leaves into a block of the dataset. Otherwise the leaf file is memory
+    // mapped by every process that uses the dataset and its pages can be evicted.
+    bool load_rtree_leaves = false;
 };
 }
 }
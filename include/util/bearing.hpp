@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <boost/assert.hpp>
 #include <cmath>
+#include <cstdint>
 #include <string>
 
 namespace osrm
@@ -92,6 +93,36 @@ inline bool CheckInBounds(const int A, const int B, const int range)
     }
 }
 
+// Bearings are grouped into 8 buckets of 45 degrees, bucket i holds [45 * i, 45 * (i + 1)).
+// A bucket mask has the bit of every bucket that contains one of a set of bearings.
+using BucketMask = std::uint8_t;
+const constexpr BucketMask ALL_BUCKETS = 0xff;
+
+// Mask of the bucket that contains the bearing, modulo 360
+inline BucketMask toBucketMask(const int bearing)
+{
+    const int normalized = (bearing < 0) ? (bearing % 360) + 360 : (bearing % 360);
+    return static_cast<BucketMask>(1u << ((normalized % 360) / 45));
+}
+
+// Mask of all buckets that contain a bearing A with CheckInBounds(A, B, range). A segment
+// whose bucket mask does not intersect it can't match the bearing.
+inline BucketMask toBucketMask(const int B, const int range)
+{
+    if (range >= 180)
+        return ALL_BUCKETS;
+    if (range < 0)
+        return 0;
+
+    // every bucket that intersects the window contains one of the samples
+    BucketMask mask = toBucketMask(B + range);
+    for (int A = B - range; A < B + range; A += 45)
+    {
+        mask |= toBucketMask(A);
+    }
+    return mask;
+}
+
 inline double reverse(const double bearing)
 {
     if (bearing >= 180)
@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -38,6 +40,18 @@ inline double radToDeg(const double radian)
     using namespace boost::math::constants;
     return radian * (180.0 * (1. / pi<double>()));
 }
+
+// Taylor polynomial of cos(x), the absolute error is below 1e-8 for |x| <= pi/2. Unlike std::cos
+// it is inlined, so loops over many coordinates can be vectorized.
+inline double cosPolynomial(const double x)
+{
+    const double x2 = x * x;
+    return 1. +
+           x2 * (-1. / 2. +
+                 x2 * (1. / 24. +
+                       x2 * (-1. / 720. +
+                             x2 * (1. / 40320. + x2 * (-1. / 3628800. + x2 / 479001600.)))));
+}
 }
 
 //! Takes the squared euclidean distance of the input coordinates. Does not return meters!
@@ -47,6 +61,17 @@ double haversineDistance(const Coordinate first_coordinate, const Coordinate sec
 
 double greatCircleDistance(const Coordinate first_coordinate, const Coordinate second_coordinate);
 
+// Equirectangular approximation of haversineDistance that needs no trigonometric functions.
+// Below 100km and 80 degrees latitude the relative error is smaller than 0.01%. Use it where
+// many distances are compared against thresholds, not for the distances that are returned.
+inline double approximateDistance(const Coordinate first_coordinate,
+                                  const Coordinate second_coordinate);
+
+// Writes the count - 1 approximate distances between consecutive coordinates to distances
+void approximateSegmentLengths(const Coordinate *coordinates,
+                               const std::size_t count,
+                               double *distances);
+
 // get the length of a full coordinate vector, using one of our basic functions to compute distances
 template <class BinaryOperation, typename iterator_type>
 double getLength(iterator_type begin, const iterator_type end, BinaryOperation op);
@@ -143,6 +168,40 @@ Coordinate rotateCCWAroundZero(Coordinate coordinate, double angle_in_radians);
 Coordinate difference(const Coordinate lhs, const Coordinate rhs);
 
 // TEMPLATE/INLINE DEFINITIONS
+namespace detail
+{
+// Squared central angle between the coordinates in the equirectangular projection around their
+// mean latitude. Its square root is left to the callers, the errno handling of std::sqrt keeps
+// the compiler from vectorizing loops that call it.
+inline double approximateSquaredAngle(const Coordinate first_coordinate,
+                                      const Coordinate second_coordinate)
+{
+    const constexpr double FIXED_TO_RAD = DEGREE_TO_RAD / COORDINATE_PRECISION;
+
+    const constexpr auto FIXED_HALF_TURN = static_cast<std::int32_t>(180 * COORDINATE_PRECISION);
+
+    const double lat1 = static_cast<std::int32_t>(first_coordinate.lat) * FIXED_TO_RAD;
+    const double lat2 = static_cast<std::int32_t>(second_coordinate.lat) * FIXED_TO_RAD;
+    std::int32_t fixed_lon_delta = static_cast<std::int32_t>(second_coordinate.lon) -
+                                   static_cast<std::int32_t>(first_coordinate.lon);
+    // take the shorter way around the antimeridian
+    fixed_lon_delta -= (fixed_lon_delta > FIXED_HALF_TURN) * (2 * FIXED_HALF_TURN);
+    fixed_lon_delta += (fixed_lon_delta < -FIXED_HALF_TURN) * (2 * FIXED_HALF_TURN);
+    const double lon_delta = fixed_lon_delta * FIXED_TO_RAD;
+
+    const double x_value = lon_delta * cosPolynomial((lat1 + lat2) / 2.);
+    const double y_value = lat2 - lat1;
+    return x_value * x_value + y_value * y_value;
+}
+}
+
+inline double approximateDistance(const Coordinate first_coordinate,
+                                  const Coordinate second_coordinate)
+{
+    return std::sqrt(detail::approximateSquaredAngle(first_coordinate, second_coordinate)) *
+           detail::EARTH_RADIUS;
+}
+
 inline std::pair<double, FloatCoordinate> projectPointOnSegment(const FloatCoordinate &source,
                                                                 const FloatCoordinate &target,
                                                                 const FloatCoordinate &coordinate)
@@ -0,0 +1,75 @@
+#ifndef OSRM_UTIL_LEAF_SCAN_HPP
+#define OSRM_UTIL_LEAF_SCAN_HPP
+
+#include "util/coordinate.hpp"
+#include "util/rectangle.hpp"
+
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+namespace leaf_scan
+{
+
+// Kernels that test all segments of a StaticRTree leaf at once. They work on the projected
+// segment coordinates that are stored one array per component in the leaf pages, so 4 (SSE)
+// or 8 (AVX2) segments are handled per instruction. All implementations compute in integers
+// and return bit-identical results, the scalar one is the reference and the fallback.
+enum class Implementation
+{
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+// Projected end points of count segments, one array per component
+struct SegmentColumns
+{
+    const FixedLongitude *u_lons;
+    const FixedLatitude *u_lats;
+    const FixedLongitude *v_lons;
+    const FixedLatitude *v_lats;
+    std::uint32_t count;
+};
+
+// Fastest implementation the CPU supports, detected once at runtime
+Implementation getImplementation();
+
+bool isSupported(const Implementation implementation);
+
+const char *toString(const Implementation implementation);
+
+// Writes the indices of the segments whose bounding box intersects the rectangle to indices,
+// which needs space for segments.count entries. Returns the number of indices written.
+std::uint32_t findIntersecting(const Implementation implementation,
+                               const SegmentColumns &segments,
+                               const RectangleInt2D &rectangle,
+                               std::uint32_t *indices);
+
+// Writes the squared euclidean distance from the point to the bounding box of every segment
+// to bounds. This is a lower bound of the squared distance to the segment itself.
+void computeSquaredLowerBounds(const Implementation implementation,
+                               const SegmentColumns &segments,
+                               const Coordinate point,
+                               std::uint64_t *bounds);
+
+inline std::uint32_t findIntersecting(const SegmentColumns &segments,
+                                      const RectangleInt2D &rectangle,
+                                      std::uint32_t *indices)
+{
+    return findIntersecting(getImplementation(), segments, rectangle, indices);
+}
+
+inline void computeSquaredLowerBounds(const SegmentColumns &segments,
+                                      const Coordinate point,
+                                      std::uint64_t *bounds)
+{
+    computeSquaredLowerBounds(getImplementation(), segments, point, bounds);
+}
+}
+}
+}
+
+#endif
@@ -7,7 +7,10 @@
 #include "storage/io_fwd.hpp"
 #include "storage/shared_memory_ownership.hpp"
 
+#include <boost/iterator/iterator_facade.hpp>
+
 #include <cmath>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -41,10 +44,44 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
 
     static const constexpr std::size_t ELEMSIZE = sizeof(std::uint64_t) * CHAR_BIT;
     static const constexpr std::size_t PACKSIZE = Bits * ELEMSIZE;
+    // Masks are computed with shifts, std::pow with a run time exponent dominated the unpacking
+    static const constexpr std::uint64_t VALUE_MASK =
+        Bits == ELEMSIZE ? ~std::uint64_t{0} : (std::uint64_t{1} << (Bits % ELEMSIZE)) - 1;
 
   public:
     using value_type = T;
 
+    // Read-only random access iterator, elements are unpacked on dereference
+    class const_iterator
+        : public boost::iterator_facade<const_iterator,
+                                        T,
+                                        boost::random_access_traversal_tag,
+                                        T>
+    {
+      public:
+        const_iterator() : container(nullptr), index(0) {}
+        const_iterator(const PackedVector *container, const std::size_t index)
+            : container(container), index(index)
+        {
+        }
+
+      private:
+        friend class boost::iterator_core_access;
+
+        T dereference() const { return container->at(index); }
+        bool equal(const const_iterator &other) const { return index == other.index; }
+        void increment() { ++index; }
+        void decrement() { --index; }
+        void advance(std::ptrdiff_t offset) { index += offset; }
+        std::ptrdiff_t distance_to(const const_iterator &other) const
+        {
+            return static_cast<std::ptrdiff_t>(other.index) - static_cast<std::ptrdiff_t>(index);
+        }
+
+        const PackedVector *container;
+        std::size_t index;
+    };
+
     /**
      * Returns the size of the packed vector datastructure with `elements` packed elements (the size
      * of
@@ -60,8 +97,7 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
         std::uint64_t node_id = static_cast<std::uint64_t>(data);
 
         // mask incoming values, just in case they are > bitsize
-        const std::uint64_t incoming_mask = static_cast<std::uint64_t>(pow(2, Bits)) - 1;
-        node_id = node_id & incoming_mask;
+        node_id = node_id & VALUE_MASK;
 
         const std::size_t available = (PACKSIZE - Bits * num_elements) % ELEMSIZE;
 
@@ -101,13 +137,12 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
     {
         BOOST_ASSERT(a_index < num_elements);
 
-        const std::size_t pack_group = trunc(a_index / ELEMSIZE);
-        const std::size_t pack_index = (a_index + ELEMSIZE) % ELEMSIZE;
+        // ELEMSIZE consecutive elements fill exactly Bits blocks
+        const std::size_t pack_group = a_index / ELEMSIZE;
+        const std::size_t pack_index = a_index % ELEMSIZE;
         const std::size_t left_index = (PACKSIZE - Bits * pack_index) % ELEMSIZE;
 
-        const bool back_half = pack_index >= Bits;
-        const std::size_t index =
-            pack_group * Bits + trunc(pack_index / Bits) + trunc((pack_index - back_half) / 2);
+        const std::size_t index = pack_group * Bits + pack_index * Bits / ELEMSIZE;
 
         BOOST_ASSERT(index < vec.size());
         const std::uint64_t elem = static_cast<std::uint64_t>(vec.at(index));
@@ -115,31 +150,36 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
         if (left_index == 0)
         {
             // ID is at the far left side of this element
-            return T{elem >> (ELEMSIZE - Bits)};
+            return make_value(elem >> (ELEMSIZE - Bits));
         }
         else if (left_index >= Bits)
         {
             // ID is entirely contained within this element
             const std::uint64_t at_right = elem >> (left_index - Bits);
-            const std::uint64_t left_mask = static_cast<std::uint64_t>(pow(2, Bits)) - 1;
-            return T{at_right & left_mask};
+            return make_value(at_right & VALUE_MASK);
         }
         else
         {
             // ID is split between this and the next element
-            const std::uint64_t left_mask = static_cast<std::uint64_t>(pow(2, left_index)) - 1;
+            // left_index < Bits <= 64, so the shift is defined
+            const std::uint64_t left_mask = (std::uint64_t{1} << left_index) - 1;
             const std::uint64_t left_side = (elem & left_mask) << (Bits - left_index);
 
             BOOST_ASSERT(index < vec.size() - 1);
             const std::uint64_t next_elem = static_cast<std::uint64_t>(vec.at(index + 1));
 
             const std::uint64_t right_side = next_elem >> (ELEMSIZE - (Bits - left_index));
-            return T{left_side | right_side};
+            return make_value(left_side | right_side);
         }
     }
 
     std::size_t size() const { return num_elements; }
 
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, num_elements); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
     template <bool enabled = (Ownership == storage::Ownership::View)>
     void reserve(typename std::enable_if<!enabled, std::size_t>::type capacity)
     {
@@ -171,6 +211,21 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
                                                          const PackedVector &vec);
 
   private:
+    // Integral types are narrowed explicitly, strong typedefs are constructed from the value
+    template <typename U = T>
+    static typename std::enable_if<std::is_integral<U>::value, T>::type
+    make_value(const std::uint64_t value)
+    {
+        return static_cast<T>(value);
+    }
+
+    template <typename U = T>
+    static typename std::enable_if<!std::is_integral<U>::value, T>::type
+    make_value(const std::uint64_t value)
+    {
+        return T{value};
+    }
+
     util::ViewOrVector<std::uint64_t, Ownership> vec;
 
     std::uint64_t num_elements = 0;
@@ -0,0 +1,99 @@
+#ifndef OSRM_UTIL_RELAX_KERNELS_HPP
+#define OSRM_UTIL_RELAX_KERNELS_HPP
+
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+namespace simd
+{
+
+// Computes base + weights[i * stride] for all i < count with a valid weight and writes
+// the candidate weights and their row indices compactly into candidates and indices.
+// Both output arrays must provide space for count elements.
+// Returns the number of valid entries. All implementations yield bit-identical results.
+using FilterValidWeightsFn = std::size_t (*)(const EdgeWeight *weights,
+                                             std::size_t count,
+                                             std::size_t stride,
+                                             EdgeWeight base,
+                                             EdgeWeight *candidates,
+                                             std::uint32_t *indices);
+
+namespace detail
+{
+std::size_t filterValidWeightsScalar(const EdgeWeight *weights,
+                                     std::size_t count,
+                                     std::size_t stride,
+                                     EdgeWeight base,
+                                     EdgeWeight *candidates,
+                                     std::uint32_t *indices);
+
+// Returns nullptr if the implementation is not available for the build or CPU
+FilterValidWeightsFn getFilterValidWeightsSSE2();
+FilterValidWeightsFn getFilterValidWeightsAVX2();
+}
+
+// Kernel selected at runtime for the best instruction set supported by the CPU
+std::size_t filterValidWeights(const EdgeWeight *weights,
+                               std::size_t count,
+                               std::size_t stride,
+                               EdgeWeight base,
+                               EdgeWeight *candidates,
+                               std::uint32_t *indices);
+
+// Name of the instruction set used by filterValidWeights
+std::string getKernelName();
+
+// Calls callback(index, base + weights[index * stride]) for every valid weight.
+// The valid entries are filtered in blocks on the stack so no allocation is required.
+template <typename Callback>
+inline void relaxWeights(const EdgeWeight *weights,
+                         std::size_t count,
+                         std::size_t stride,
+                         EdgeWeight base,
+                         Callback &&callback)
+{
+    constexpr std::size_t BLOCK_SIZE = 128;
+    EdgeWeight candidates[BLOCK_SIZE];
+    std::uint32_t indices[BLOCK_SIZE];
+
+    BOOST_ASSERT(count == 0 || weights != nullptr);
+    for (std::size_t offset = 0; offset < count; offset += BLOCK_SIZE)
+    {
+        const auto block_size = std::min(BLOCK_SIZE, count - offset);
+        const auto num_valid = filterValidWeights(
+            weights + offset * stride, block_size, stride, base, candidates, indices);
+        for (std::size_t index = 0; index < num_valid; ++index)
+        {
+            callback(offset + indices[index], candidates[index]);
+        }
+    }
+}
+
+// Relaxes all clique arcs of a weight row (GetOutWeight) or column (GetInWeight) of a cell
+template <typename WeightRange, typename Callback>
+inline void relaxWeights(const WeightRange &range,
+                         std::size_t stride,
+                         EdgeWeight base,
+                         Callback &&callback)
+{
+    if (range.empty())
+        return;
+
+    relaxWeights(&*range.begin(), range.size(), stride, base, std::forward<Callback>(callback));
+}
+}
+}
+}
+
+#endif
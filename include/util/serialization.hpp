@@ -3,6 +3,7 @@
 
 #include "util/dynamic_graph.hpp"
 #include "util/packed_vector.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/static_graph.hpp"
 
 #include "storage/io.hpp"
@@ -43,6 +44,26 @@ inline void write(storage::io::FileWriter &writer, const StaticGraph<EdgeDataT,
     storage::serialization::write(writer, graph.edge_array);
 }
 
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::SnappingGridImpl<Ownership> &grid)
+{
+    grid.cell_size = reader.ReadOne<std::int32_t>();
+    grid.number_of_leaves = reader.ReadOne<std::uint64_t>();
+    storage::serialization::read(reader, grid.cells);
+    storage::serialization::read(reader, grid.cell_offsets);
+    storage::serialization::read(reader, grid.leaf_ids);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer, const detail::SnappingGridImpl<Ownership> &grid)
+{
+    writer.WriteOne(grid.cell_size);
+    writer.WriteOne(grid.number_of_leaves);
+    storage::serialization::write(writer, grid.cells);
+    storage::serialization::write(writer, grid.cell_offsets);
+    storage::serialization::write(writer, grid.leaf_ids);
+}
+
 template <typename EdgeDataT>
 inline void read(storage::io::FileReader &reader, DynamicGraph<EdgeDataT> &graph)
 {
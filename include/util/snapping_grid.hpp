@@ -0,0 +1,266 @@
+#ifndef OSRM_UTIL_SNAPPING_GRID_HPP
+#define OSRM_UTIL_SNAPPING_GRID_HPP
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+#include "util/rectangle.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class SnappingGridImpl;
+}
+using SnappingGrid = detail::SnappingGridImpl<storage::Ownership::Container>;
+using SnappingGridView = detail::SnappingGridImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+void read(storage::io::FileReader &reader, detail::SnappingGridImpl<Ownership> &grid);
+template <storage::Ownership Ownership>
+void write(storage::io::FileWriter &writer, const detail::SnappingGridImpl<Ownership> &grid);
+}
+
+namespace detail
+{
+
+// Uniform grid over the projected coordinates of the StaticRTree that maps every cell to the
+// leaves whose bounding box intersects it. Only cells that contain leaves are stored, sorted by
+// their key, so a cell is found with a binary search.
+//
+// A nearest query in a dense area can start from the leaves around the query coordinate instead
+// of descending the tree from the root. The result is exact if the found segments are closer than
+// the border of the searched cells, otherwise the tree has to be searched.
+template <storage::Ownership Ownership> class SnappingGridImpl final
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    // Leaves that cover more cells are not stored. They are sparse leaves in rural areas, the
+    // cells they intersect are dropped from the grid, so these queries use the tree.
+    static constexpr const std::uint64_t MAX_CELLS_PER_LEAF = 64;
+
+    SnappingGridImpl() = default;
+
+    // Builds the grid for the leaf bounding boxes, which are indexed by leaf id. A cell size of 0
+    // gives an empty grid.
+    template <typename = typename std::enable_if<Ownership == storage::Ownership::Container>>
+    SnappingGridImpl(const std::vector<RectangleInt2D> &leaf_rectangles,
+                     const std::int32_t cell_size_)
+        : cell_size(cell_size_), number_of_leaves(leaf_rectangles.size())
+    {
+        if (cell_size > 0)
+        {
+            Build(leaf_rectangles);
+        }
+    }
+
+    template <typename = typename std::enable_if<Ownership == storage::Ownership::View>>
+    SnappingGridImpl(const std::int32_t cell_size_,
+                     Vector<std::uint64_t> cells_,
+                     Vector<std::uint32_t> cell_offsets_,
+                     Vector<std::uint32_t> leaf_ids_)
+        : cell_size(cell_size_), cells(std::move(cells_)), cell_offsets(std::move(cell_offsets_)),
+          leaf_ids(std::move(leaf_ids_))
+    {
+    }
+
+    bool Empty() const { return cells.empty(); }
+
+    // Cell size in projected fixed point coordinates
+    std::int32_t GetCellSize() const { return cell_size; }
+
+    std::size_t GetNumberOfCells() const { return cells.size(); }
+
+    std::size_t GetNumberOfEntries() const { return leaf_ids.size(); }
+
+    // Number of leaves of the rtree the grid was built for, the leaf ids are only valid for it
+    std::uint64_t GetNumberOfLeaves() const { return number_of_leaves; }
+
+    // Writes the sorted ids of the leaves in the 3x3 cells around the projected coordinate to
+    // candidates. Returns the squared distance from the coordinate to the border of these cells:
+    // every segment that is closer is in one of the leaves. If a cell is not stored 0 is returned.
+    std::uint64_t GetCandidateLeaves(const Coordinate projected_coordinate,
+                                     std::vector<std::uint32_t> &candidates) const
+    {
+        candidates.clear();
+        if (Empty())
+            return 0;
+
+        const auto x = static_cast<std::int32_t>(projected_coordinate.lon);
+        const auto y = static_cast<std::int32_t>(projected_coordinate.lat);
+        const auto cell_x = ToCell(x);
+        const auto cell_y = ToCell(y);
+
+        for (auto dx = -1; dx <= 1; ++dx)
+        {
+            for (auto dy = -1; dy <= 1; ++dy)
+            {
+                const auto key = ToKey(cell_x + dx, cell_y + dy);
+                const auto cell = std::lower_bound(cells.begin(), cells.end(), key);
+                if (cell == cells.end() || *cell != key)
+                {
+                    candidates.clear();
+                    return 0;
+                }
+
+                const auto index = std::distance(cells.begin(), cell);
+                candidates.insert(candidates.end(),
+                                  leaf_ids.begin() + cell_offsets[index],
+                                  leaf_ids.begin() + cell_offsets[index + 1]);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        const std::int64_t size = cell_size;
+        const auto radius = std::min({x - (cell_x - 1) * size,
+                                      (cell_x + 2) * size - x,
+                                      y - (cell_y - 1) * size,
+                                      (cell_y + 2) * size - y});
+        BOOST_ASSERT(radius > 0);
+        return static_cast<std::uint64_t>(radius * radius);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               SnappingGridImpl &grid);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const SnappingGridImpl &grid);
+
+  private:
+    std::int64_t ToCell(const std::int64_t value) const
+    {
+        // rounds towards negative infinity
+        return value >= 0 ? value / cell_size : -((cell_size - 1 - value) / cell_size);
+    }
+
+    // Cells are ordered by column and by row inside a column
+    static std::uint64_t ToKey(const std::int64_t cell_x, const std::int64_t cell_y)
+    {
+        const auto biased_x = static_cast<std::uint32_t>(cell_x) ^ 0x80000000u;
+        const auto biased_y = static_cast<std::uint32_t>(cell_y) ^ 0x80000000u;
+        return (static_cast<std::uint64_t>(biased_x) << 32) | biased_y;
+    }
+
+    static std::int64_t ToColumn(const std::uint64_t key)
+    {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32) ^ 0x80000000u);
+    }
+
+    void Build(const std::vector<RectangleInt2D> &leaf_rectangles)
+    {
+        struct CellRange
+        {
+            std::int64_t min_x;
+            std::int64_t max_x;
+            std::int64_t min_y;
+            std::int64_t max_y;
+        };
+        const auto to_cells = [this](const RectangleInt2D &rectangle) {
+            return CellRange{ToCell(static_cast<std::int32_t>(rectangle.min_lon)),
+                             ToCell(static_cast<std::int32_t>(rectangle.max_lon)),
+                             ToCell(static_cast<std::int32_t>(rectangle.min_lat)),
+                             ToCell(static_cast<std::int32_t>(rectangle.max_lat))};
+        };
+
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+        std::vector<CellRange> large_leaves;
+        for (const auto leaf_id : irange<std::size_t>(0, leaf_rectangles.size()))
+        {
+            const auto range = to_cells(leaf_rectangles[leaf_id]);
+            const auto num_cells = static_cast<std::uint64_t>(range.max_x - range.min_x + 1) *
+                                   static_cast<std::uint64_t>(range.max_y - range.min_y + 1);
+            if (num_cells > MAX_CELLS_PER_LEAF)
+            {
+                large_leaves.push_back(range);
+                continue;
+            }
+
+            for (auto cell_x = range.min_x; cell_x <= range.max_x; ++cell_x)
+            {
+                for (auto cell_y = range.min_y; cell_y <= range.max_y; ++cell_y)
+                {
+                    entries.emplace_back(ToKey(cell_x, cell_y), leaf_id);
+                }
+            }
+        }
+        tbb::parallel_sort(entries.begin(), entries.end());
+
+        std::vector<std::uint64_t> all_cells;
+        for (const auto &entry : entries)
+        {
+            if (all_cells.empty() || all_cells.back() != entry.first)
+                all_cells.push_back(entry.first);
+        }
+
+        // Cells that intersect a large leaf are incomplete. Only the columns that contain
+        // cells are visited, a large leaf can span many empty ones.
+        std::vector<bool> is_incomplete(all_cells.size(), false);
+        for (const auto &range : large_leaves)
+        {
+            auto cell = std::lower_bound(
+                all_cells.begin(), all_cells.end(), ToKey(range.min_x, range.min_y));
+            while (cell != all_cells.end() && ToColumn(*cell) <= range.max_x)
+            {
+                const auto cell_x = ToColumn(*cell);
+                cell = std::lower_bound(cell, all_cells.end(), ToKey(cell_x, range.min_y));
+                const auto last = ToKey(cell_x, range.max_y);
+                for (; cell != all_cells.end() && *cell <= last; ++cell)
+                {
+                    is_incomplete[std::distance(all_cells.begin(), cell)] = true;
+                }
+                if (cell != all_cells.end() && ToColumn(*cell) == cell_x)
+                {
+                    cell = std::lower_bound(cell, all_cells.end(), ToKey(cell_x + 1, range.min_y));
+                }
+            }
+        }
+
+        cell_offsets.push_back(0);
+        auto entry = entries.begin();
+        for (const auto index : irange<std::size_t>(0, all_cells.size()))
+        {
+            const auto key = all_cells[index];
+            if (!is_incomplete[index])
+                cells.push_back(key);
+
+            for (; entry != entries.end() && entry->first == key; ++entry)
+            {
+                if (!is_incomplete[index])
+                    leaf_ids.push_back(entry->second);
+            }
+            if (!is_incomplete[index])
+                cell_offsets.push_back(leaf_ids.size());
+        }
+        BOOST_ASSERT(cell_offsets.size() == cells.size() + 1);
+    }
+
+    std::int32_t cell_size = 0;
+    std::uint64_t number_of_leaves = 0;
+    Vector<std::uint64_t> cells;
+    Vector<std::uint32_t> cell_offsets;
+    Vector<std::uint32_t> leaf_ids;
+};
+}
+}
+}
+
+#endif
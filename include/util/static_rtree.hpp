@@ -8,6 +8,7 @@
 #include "util/exception.hpp"
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
+#include "util/leaf_scan.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
@@ -22,16 +23,25 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/format.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/optional.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <new>
 #include <queue>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -49,26 +59,108 @@ namespace osrm
 namespace util
 {
 
+// Layout of the leaf pages of the StaticRTree
+enum class LeafLayout
+{
+    // Only the edge data, the segment coordinates are looked up in the coordinate list
+    Objects,
+    // The projected segment coordinates are stored in the page next to the edge data,
+    // scanning a leaf does not touch the coordinate list
+    ObjectsAndCoordinates
+};
+
+namespace detail
+{
+template <class EdgeDataT, std::uint32_t LEAF_PAGE_SIZE, LeafLayout Layout> struct RTreeLeafNode;
+
+template <class EdgeDataT, std::uint32_t LEAF_PAGE_SIZE>
+struct ALIGNED(LEAF_PAGE_SIZE) RTreeLeafNode<EdgeDataT, LEAF_PAGE_SIZE, LeafLayout::Objects>
+{
+    static constexpr std::uint32_t CAPACITY =
+        (LEAF_PAGE_SIZE - sizeof(std::uint32_t) - sizeof(RectangleInt2D) -
+         sizeof(bearing::BucketMask)) /
+        (sizeof(EdgeDataT) + sizeof(bearing::BucketMask));
+
+    RTreeLeafNode() : object_count(0), objects(), bearing_mask(0), bearing_masks() {}
+    std::uint32_t object_count;
+    RectangleInt2D minimum_bounding_rectangle;
+    std::array<EdgeDataT, CAPACITY> objects;
+    // Buckets of the enabled directions of all segments and of every segment
+    bearing::BucketMask bearing_mask;
+    std::array<bearing::BucketMask, CAPACITY> bearing_masks;
+};
+
+template <class EdgeDataT, std::uint32_t LEAF_PAGE_SIZE>
+struct ALIGNED(LEAF_PAGE_SIZE)
+    RTreeLeafNode<EdgeDataT, LEAF_PAGE_SIZE, LeafLayout::ObjectsAndCoordinates>
+{
+    static constexpr std::uint32_t CAPACITY =
+        (LEAF_PAGE_SIZE - sizeof(std::uint32_t) - sizeof(RectangleInt2D) -
+         sizeof(bearing::BucketMask)) /
+        (sizeof(EdgeDataT) + 2 * sizeof(FixedLongitude) + 2 * sizeof(FixedLatitude) +
+         sizeof(bearing::BucketMask));
+
+    RTreeLeafNode()
+        : object_count(0), objects(), u_lons(), u_lats(), v_lons(), v_lats(), bearing_mask(0),
+          bearing_masks()
+    {
+    }
+    std::uint32_t object_count;
+    RectangleInt2D minimum_bounding_rectangle;
+    std::array<EdgeDataT, CAPACITY> objects;
+    // Web Mercator projected segment end points in fixed point, one array per component
+    std::array<FixedLongitude, CAPACITY> u_lons;
+    std::array<FixedLatitude, CAPACITY> u_lats;
+    std::array<FixedLongitude, CAPACITY> v_lons;
+    std::array<FixedLatitude, CAPACITY> v_lats;
+    // Buckets of the enabled directions of all segments and of every segment
+    bearing::BucketMask bearing_mask;
+    std::array<bearing::BucketMask, CAPACITY> bearing_masks;
+};
+
+// Written after the fingerprint of the tree node file. The leaf file has no header of its own,
+// it is always written along with the tree nodes, so this describes the leaves as well.
+struct RTreeFileHeader
+{
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint32_t leaf_layout;
+    std::uint32_t tree_node_size;
+    std::uint32_t leaf_node_size;
+    std::uint32_t leaf_capacity;
+    std::uint64_t number_of_leaves;
+};
+static_assert(sizeof(RTreeFileHeader) == 32, "RTreeFileHeader has unexpected padding");
+}
+
 // Static RTree for serving nearest neighbour queries
 // All coordinates are pojected first to Web Mercator before the bounding boxes
 // are computed, this means the internal distance metric doesn not represent meters!
 template <class EdgeDataT,
           storage::Ownership Ownership = storage::Ownership::Container,
           std::uint32_t BRANCHING_FACTOR = 128,
-          std::uint32_t LEAF_PAGE_SIZE = 4096>
+          std::uint32_t LEAF_PAGE_SIZE = 4096,
+          LeafLayout Layout = LeafLayout::Objects>
 class StaticRTree
 {
     template <typename T> using Vector = ViewOrVector<T, Ownership>;
+    using HasLeafCoordinates =
+        std::integral_constant<bool, Layout == LeafLayout::ObjectsAndCoordinates>;
 
   public:
     using Rectangle = RectangleInt2D;
     using EdgeData = EdgeDataT;
     using CoordinateList = Vector<util::Coordinate>;
+    using LeafNode = detail::RTreeLeafNode<EdgeDataT, LEAF_PAGE_SIZE, Layout>;
 
-    static_assert(LEAF_PAGE_SIZE >= sizeof(uint32_t) + sizeof(EdgeDataT), "page size is too small");
     static_assert(((LEAF_PAGE_SIZE - 1) & LEAF_PAGE_SIZE) == 0, "page size is not a power of 2");
-    static constexpr std::uint32_t LEAF_NODE_SIZE =
-        (LEAF_PAGE_SIZE - sizeof(uint32_t) - sizeof(Rectangle)) / sizeof(EdgeDataT);
+    static constexpr std::uint32_t LEAF_NODE_SIZE = LeafNode::CAPACITY;
+    static_assert(LEAF_NODE_SIZE > 0, "page size is too small");
+    static_assert(sizeof(LeafNode) == LEAF_PAGE_SIZE, "LeafNode size does not fit the page size");
+    // number of tree nodes whose leaves are built and written at once by the construction
+    static constexpr std::uint64_t LEAF_BATCH_NODES = 64;
+    // Version of the layout of TreeNode and LeafNode in the files, bump it on every change
+    static constexpr std::uint32_t FILE_VERSION = 1;
 
     struct CandidateSegment
     {
@@ -86,21 +178,15 @@ class StaticRTree
 
     struct TreeNode
     {
-        TreeNode() : child_count(0) {}
-        std::uint32_t child_count;
+        // not user provided, so value initialized nodes have their padding zeroed as well
+        TreeNode() = default;
+        std::uint32_t child_count = 0;
         Rectangle minimum_bounding_rectangle;
+        // Buckets of the enabled directions of all segments below the node
+        bearing::BucketMask bearing_mask = 0;
         TreeIndex children[BRANCHING_FACTOR];
     };
 
-    struct ALIGNED(LEAF_PAGE_SIZE) LeafNode
-    {
-        LeafNode() : object_count(0), objects() {}
-        std::uint32_t object_count;
-        Rectangle minimum_bounding_rectangle;
-        std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
-    };
-    static_assert(sizeof(LeafNode) == LEAF_PAGE_SIZE, "LeafNode size does not fit the page size");
-
   private:
     struct WrappedInputElement
     {
@@ -129,12 +215,24 @@ class StaticRTree
         {
         }
 
+        // Segment with the exact distance and the projected input coordinate
         QueryCandidate(std::uint64_t squared_min_dist,
                        TreeIndex tree_index,
                        std::uint32_t segment_index,
                        const Coordinate &coordinate)
             : squared_min_dist(squared_min_dist), tree_index(tree_index),
-              segment_index(segment_index), fixed_projected_coordinate(coordinate)
+              segment_index(segment_index), fixed_projected_coordinate(coordinate),
+              is_refined(true)
+        {
+        }
+
+        // Segment with a lower bound of the distance, the projection is deferred until
+        // the segment is extracted from the queue
+        QueryCandidate(std::uint64_t squared_min_dist,
+                       TreeIndex tree_index,
+                       std::uint32_t segment_index)
+            : squared_min_dist(squared_min_dist), tree_index(tree_index),
+              segment_index(segment_index), is_refined(false)
         {
         }
 
@@ -153,6 +251,57 @@ class StaticRTree
         TreeIndex tree_index;
         std::uint32_t segment_index;
         Coordinate fixed_projected_coordinate;
+        bool is_refined = true;
+    };
+
+    // Binary heap of query candidates with the nearest one on top. The memory is owned by the
+    // caller and reused between queries. Candidates farther away than the bound are dropped on
+    // push, they can't be part of the result anymore.
+    class QueryHeap
+    {
+      public:
+        explicit QueryHeap(std::vector<QueryCandidate> &storage) : storage(storage)
+        {
+            storage.clear();
+        }
+
+        void push(const QueryCandidate &candidate)
+        {
+            if (candidate.squared_min_dist > bound)
+                return;
+            storage.push_back(candidate);
+            std::push_heap(storage.begin(), storage.end());
+        }
+
+        void pop()
+        {
+            std::pop_heap(storage.begin(), storage.end());
+            storage.pop_back();
+        }
+
+        const QueryCandidate &top() const { return storage.front(); }
+        bool empty() const { return storage.empty(); }
+        // the bound can only be lowered
+        void set_bound(const std::uint64_t new_bound) { bound = std::min(bound, new_bound); }
+
+      private:
+        std::vector<QueryCandidate> &storage;
+        std::uint64_t bound = std::numeric_limits<std::uint64_t>::max();
+    };
+
+    // Accepted segment of a bounded nearest query
+    struct NearestResult
+    {
+        // The farthest result is on top of the heap. Segments at the same distance keep the
+        // order in which they were accepted.
+        bool operator<(const NearestResult &other) const
+        {
+            return std::tie(squared_distance, rank) < std::tie(other.squared_distance, other.rank);
+        }
+
+        std::uint64_t squared_distance;
+        std::size_t rank;
+        EdgeDataT data;
     };
 
     Vector<TreeNode> m_search_tree;
@@ -204,107 +353,106 @@ class StaticRTree
                 }
             });
 
-        // open leaf file
-        boost::filesystem::ofstream leaf_node_file(leaf_node_filename, std::ios::binary);
-
         // sort the hilbert-value representatives
         tbb::parallel_sort(input_wrapper_vector.begin(), input_wrapper_vector.end());
-        std::vector<TreeNode> tree_nodes_in_level;
-
-        // pack M elements into leaf node, write to leaf file and add child index to the parent node
-        uint64_t wrapped_element_index = 0;
-        for (std::uint32_t node_index = 0; wrapped_element_index < element_count; ++node_index)
-        {
-            TreeNode current_node;
-            for (std::uint32_t leaf_index = 0;
-                 leaf_index < BRANCHING_FACTOR && wrapped_element_index < element_count;
-                 ++leaf_index)
-            {
-                LeafNode current_leaf;
-                Rectangle &rectangle = current_leaf.minimum_bounding_rectangle;
-                for (std::uint32_t object_index = 0;
-                     object_index < LEAF_NODE_SIZE && wrapped_element_index < element_count;
-                     ++object_index, ++wrapped_element_index)
-                {
-                    const std::uint32_t input_object_index =
-                        input_wrapper_vector[wrapped_element_index].m_array_index;
-                    const EdgeDataT &object = input_data_vector[input_object_index];
-
-                    current_leaf.object_count += 1;
-                    current_leaf.objects[object_index] = object;
-
-                    Coordinate projected_u{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
-                    Coordinate projected_v{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
-
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
-
-                    rectangle.min_lon =
-                        std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
-                    rectangle.max_lon =
-                        std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
-
-                    rectangle.min_lat =
-                        std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
-                    rectangle.max_lat =
-                        std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
-
-                    BOOST_ASSERT(rectangle.IsValid());
-                }
 
-                // append the leaf node to the current tree node
-                current_node.child_count += 1;
-                current_node.children[leaf_index] =
-                    TreeIndex{node_index * BRANCHING_FACTOR + leaf_index, true};
-                current_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                    current_leaf.minimum_bounding_rectangle);
+        // pack M elements into every leaf node and BRANCHING_FACTOR leaves into every tree node
+        // of the lowest level. The leaves are built in parallel in batches of tree nodes, every
+        // batch is written to the leaf file while the next one is built.
+        const std::uint64_t num_leaves = (element_count + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE;
+        std::vector<TreeNode> tree_nodes_in_level((num_leaves + BRANCHING_FACTOR - 1) /
+                                                  BRANCHING_FACTOR);
 
-                // write leaf_node to leaf node file
-                leaf_node_file.write((char *)&current_leaf, sizeof(current_leaf));
-            }
+        boost::filesystem::ofstream leaf_node_file(leaf_node_filename, std::ios::binary);
+        std::array<std::vector<char>, 2> leaf_buffers;
+        std::future<void> leaf_writing;
+        for (std::uint64_t first_node = 0, batch = 0; first_node < tree_nodes_in_level.size();
+             first_node += LEAF_BATCH_NODES, ++batch)
+        {
+            const std::uint64_t last_node =
+                std::min<std::uint64_t>(first_node + LEAF_BATCH_NODES, tree_nodes_in_level.size());
+            const std::uint64_t first_leaf = first_node * BRANCHING_FACTOR;
+            const std::uint64_t last_leaf = std::min(last_node * BRANCHING_FACTOR, num_leaves);
+
+            // the buffer was written before the previous batch was started
+            auto leaves = ResetLeafBuffer(leaf_buffers[batch % 2], last_leaf - first_leaf);
+            tbb::parallel_for(
+                tbb::blocked_range<std::uint64_t>(first_node, last_node),
+                [&](const tbb::blocked_range<std::uint64_t> &range) {
+                    for (auto node_index = range.begin(); node_index != range.end(); ++node_index)
+                    {
+                        TreeNode &current_node = tree_nodes_in_level[node_index];
+                        const auto node_first_leaf = node_index * BRANCHING_FACTOR;
+                        const auto node_last_leaf =
+                            std::min(node_first_leaf + BRANCHING_FACTOR, num_leaves);
+                        for (auto leaf_index = node_first_leaf; leaf_index < node_last_leaf;
+                             ++leaf_index)
+                        {
+                            const LeafNode &current_leaf =
+                                BuildLeafNode(input_data_vector,
+                                              input_wrapper_vector,
+                                              leaf_index,
+                                              leaves + (leaf_index - first_leaf));
+
+                            // append the leaf node to the current tree node
+                            current_node.children[current_node.child_count] =
+                                TreeIndex{leaf_index, true};
+                            current_node.child_count += 1;
+                            current_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                                current_leaf.minimum_bounding_rectangle);
+                            current_node.bearing_mask |= current_leaf.bearing_mask;
+                        }
+                    }
+                });
 
-            tree_nodes_in_level.emplace_back(current_node);
+            if (leaf_writing.valid())
+                leaf_writing.get();
+            const auto num_bytes = (last_leaf - first_leaf) * sizeof(LeafNode);
+            leaf_writing = std::async(std::launch::async, [&leaf_node_file, leaves, num_bytes] {
+                leaf_node_file.write(reinterpret_cast<const char *>(leaves), num_bytes);
+            });
         }
+        if (leaf_writing.valid())
+            leaf_writing.get();
         leaf_node_file.flush();
         leaf_node_file.close();
 
-        std::uint32_t processing_level = 0;
+        // Every level packs BRANCHING_FACTOR nodes of the level below into a parent node. The
+        // nodes of the level below are appended to the search tree, the root is added last.
         while (1 < tree_nodes_in_level.size())
         {
-            std::vector<TreeNode> tree_nodes_in_next_level;
-            std::uint32_t processed_tree_nodes_in_level = 0;
-            while (processed_tree_nodes_in_level < tree_nodes_in_level.size())
-            {
-                TreeNode parent_node;
-                // pack BRANCHING_FACTOR elements into tree_nodes each
-                for (std::uint32_t current_child_node_index = 0;
-                     current_child_node_index < BRANCHING_FACTOR;
-                     ++current_child_node_index)
-                {
-                    if (processed_tree_nodes_in_level < tree_nodes_in_level.size())
+            const std::uint64_t first_index = m_search_tree.size();
+            m_search_tree.resize(first_index + tree_nodes_in_level.size());
+            std::vector<TreeNode> tree_nodes_in_next_level(
+                (tree_nodes_in_level.size() + BRANCHING_FACTOR - 1) / BRANCHING_FACTOR);
+
+            tbb::parallel_for(
+                tbb::blocked_range<std::uint64_t>(0, tree_nodes_in_next_level.size()),
+                [&](const tbb::blocked_range<std::uint64_t> &range) {
+                    for (auto parent_index = range.begin(); parent_index != range.end();
+                         ++parent_index)
                     {
-                        TreeNode &current_child_node =
-                            tree_nodes_in_level[processed_tree_nodes_in_level];
-                        // add tree node to parent entry
-                        parent_node.children[current_child_node_index] =
-                            TreeIndex{m_search_tree.size(), false};
-                        m_search_tree.emplace_back(current_child_node);
-                        // merge MBRs
-                        parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                            current_child_node.minimum_bounding_rectangle);
-                        // increase counters
-                        ++parent_node.child_count;
-                        ++processed_tree_nodes_in_level;
+                        TreeNode &parent_node = tree_nodes_in_next_level[parent_index];
+                        const auto first_child = parent_index * BRANCHING_FACTOR;
+                        const auto last_child = std::min<std::uint64_t>(
+                            first_child + BRANCHING_FACTOR, tree_nodes_in_level.size());
+                        for (auto child_index = first_child; child_index < last_child;
+                             ++child_index)
+                        {
+                            const TreeNode &current_child_node = tree_nodes_in_level[child_index];
+                            // add tree node to parent entry
+                            parent_node.children[parent_node.child_count] =
+                                TreeIndex{first_index + child_index, false};
+                            m_search_tree[first_index + child_index] = current_child_node;
+                            // merge MBRs
+                            parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                                current_child_node.minimum_bounding_rectangle);
+                            parent_node.bearing_mask |= current_child_node.bearing_mask;
+                            ++parent_node.child_count;
+                        }
                     }
-                }
-                tree_nodes_in_next_level.emplace_back(parent_node);
-            }
+                });
             tree_nodes_in_level.swap(tree_nodes_in_next_level);
-            ++processing_level;
         }
         BOOST_ASSERT_MSG(tree_nodes_in_level.size() == 1, "tree broken, more than one root node");
         // last remaining entry is the root node, store it
@@ -339,6 +487,7 @@ class StaticRTree
         std::uint64_t size_of_tree = m_search_tree.size();
         BOOST_ASSERT_MSG(0 < size_of_tree, "tree empty");
 
+        tree_node_file.WriteOne(MakeFileHeader(num_leaves));
         tree_node_file.WriteOne(size_of_tree);
         tree_node_file.WriteFrom(&m_search_tree[0], size_of_tree);
 
@@ -353,12 +502,14 @@ class StaticRTree
         storage::io::FileReader tree_node_file(node_file,
                                                storage::io::FileReader::VerifyFingerprint);
 
+        const auto header = ReadFileHeader(tree_node_file, node_file);
         const auto tree_size = tree_node_file.ReadElementCount64();
 
         m_search_tree.resize(tree_size);
         tree_node_file.ReadInto(&m_search_tree[0], tree_size);
 
         MapLeafNodesFile(leaf_file);
+        CheckLeafFileSize(header, m_leaves_region.size(), leaf_file);
     }
 
     explicit StaticRTree(TreeNode *tree_node_ptr,
@@ -370,6 +521,78 @@ class StaticRTree
         MapLeafNodesFile(leaf_file);
     }
 
+    // The leaves were loaded into memory by the caller, e.g. as a block of the shared dataset,
+    // so they can't be evicted from the page cache like the pages of a mapped leaf file.
+    explicit StaticRTree(TreeNode *tree_node_ptr,
+                         const uint64_t number_of_nodes,
+                         const LeafNode *leaf_node_ptr,
+                         const uint64_t number_of_leaves,
+                         const Vector<Coordinate> &coordinate_list)
+        : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
+          m_leaves(leaf_node_ptr, number_of_leaves)
+    {
+        BOOST_ASSERT(reinterpret_cast<uintptr_t>(leaf_node_ptr) % alignof(LeafNode) == 0);
+    }
+
+    static detail::RTreeFileHeader MakeFileHeader(const std::uint64_t number_of_leaves)
+    {
+        return detail::RTreeFileHeader{{{'O', 'R', 'T', 'I'}},
+                                       FILE_VERSION,
+                                       static_cast<std::uint32_t>(Layout),
+                                       sizeof(TreeNode),
+                                       sizeof(LeafNode),
+                                       LEAF_NODE_SIZE,
+                                       number_of_leaves};
+    }
+
+    // Reads the header of a tree node file, files of another layout would be misread otherwise
+    static detail::RTreeFileHeader ReadFileHeader(storage::io::FileReader &tree_node_file,
+                                                  const boost::filesystem::path &node_file)
+    {
+        const auto header = tree_node_file.ReadOne<detail::RTreeFileHeader>();
+        const auto expected = MakeFileHeader(header.number_of_leaves);
+        if (header.magic != expected.magic || header.version != expected.version)
+        {
+            throw exception(node_file.string() +
+                            " was written by an incompatible version of osrm-extract, expected "
+                            "rtree file version " +
+                            std::to_string(FILE_VERSION) + ". Please re-run osrm-extract." +
+                            SOURCE_REF);
+        }
+        if (header.leaf_layout != expected.leaf_layout ||
+            header.tree_node_size != expected.tree_node_size ||
+            header.leaf_node_size != expected.leaf_node_size ||
+            header.leaf_capacity != expected.leaf_capacity)
+        {
+            throw exception(
+                boost::str(boost::format("%1% has an rtree layout of %2% byte tree nodes and %3% "
+                                         "byte leaves with %4% segments of layout %5%, expected "
+                                         "%6% byte tree nodes and %7% byte leaves with %8% "
+                                         "segments of layout %9%") %
+                           node_file.string() % header.tree_node_size % header.leaf_node_size %
+                           header.leaf_capacity % header.leaf_layout % expected.tree_node_size %
+                           expected.leaf_node_size % expected.leaf_capacity %
+                           expected.leaf_layout) +
+                SOURCE_REF);
+        }
+        return header;
+    }
+
+    // The leaf file has to hold exactly the leaves the tree nodes were written with
+    static void CheckLeafFileSize(const detail::RTreeFileHeader &header,
+                                  const std::uint64_t leaf_file_size,
+                                  const boost::filesystem::path &leaf_file)
+    {
+        if (leaf_file_size != header.number_of_leaves * sizeof(LeafNode))
+        {
+            throw exception(boost::str(boost::format("Leaf file %1% has %2% bytes, expected %3% "
+                                                     "leaves of %4% bytes") %
+                                       leaf_file % leaf_file_size % header.number_of_leaves %
+                                       sizeof(LeafNode)) +
+                            SOURCE_REF);
+        }
+    }
+
     void MapLeafNodesFile(const boost::filesystem::path &leaf_file)
     {
         // open leaf node file and return a pointer to the mapped leaves data
@@ -393,13 +616,7 @@ class StaticRTree
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
     {
-        const Rectangle projected_rectangle{
-            search_rectangle.min_lon,
-            search_rectangle.max_lon,
-            toFixed(FloatLatitude{
-                web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.min_lat)))}),
-            toFixed(FloatLatitude{
-                web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.max_lat)))})};
+        const auto projected_rectangle = ProjectRectangle(search_rectangle);
         std::vector<EdgeDataT> results;
 
         std::queue<TreeIndex> traversal_queue;
@@ -412,29 +629,11 @@ class StaticRTree
 
             if (current_tree_index.is_leaf)
             {
-                const LeafNode &current_leaf_node = m_leaves[current_tree_index.index];
-
-                for (const auto i : irange(0u, current_leaf_node.object_count))
-                {
-                    const auto &current_edge = current_leaf_node.objects[i];
-
-                    // we don't need to project the coordinates here,
-                    // because we use the unprojected rectangle to test against
-                    const Rectangle bbox{std::min(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::max(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::min(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat),
-                                         std::max(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat)};
-
-                    // use the _unprojected_ input rectangle here
-                    if (bbox.Intersects(search_rectangle))
-                    {
-                        results.push_back(current_edge);
-                    }
-                }
+                SearchLeafNode(m_leaves[current_tree_index.index],
+                               search_rectangle,
+                               projected_rectangle,
+                               results,
+                               HasLeafCoordinates{});
             }
             else
             {
@@ -459,29 +658,135 @@ class StaticRTree
         return results;
     }
 
-    // Override filter and terminator for the desired behaviour.
+    /* Returns the candidates that SearchInBox returns for the rectangle, in their order.
+       If the candidates are the result of a search in a box that contains the rectangle, this
+       gives the same features without visiting the tree. */
+    std::vector<EdgeDataT> FilterInBox(const std::vector<EdgeDataT> &candidates,
+                                       const Rectangle &search_rectangle) const
+    {
+        const auto projected_rectangle = ProjectRectangle(search_rectangle);
+        std::vector<EdgeDataT> results;
+        std::copy_if(candidates.begin(),
+                     candidates.end(),
+                     std::back_inserter(results),
+                     [&](const EdgeDataT &edge) {
+                         return IsInBox(
+                             edge, search_rectangle, projected_rectangle, HasLeafCoordinates{});
+                     });
+        return results;
+    }
+
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const std::size_t max_results) const
     {
-        return Nearest(input_coordinate,
-                       [](const CandidateSegment &) { return std::make_pair(true, true); },
-                       [max_results](const std::size_t num_results, const CandidateSegment &) {
-                           return num_results >= max_results;
-                       });
+        std::vector<EdgeDataT> results;
+        Nearest(input_coordinate,
+                max_results,
+                [](const CandidateSegment &) { return std::make_pair(true, true); },
+                std::back_inserter(results));
+        return results;
     }
 
-    // Override filter and terminator for the desired behaviour.
+    // Writes the max_results nearest segments that pass the filter to the output, ordered by
+    // distance, and returns the end of the written range. A caller provided buffer needs space
+    // for max_results entries.
+    //
+    // The filter is applied as soon as the exact distance of a segment is known. Every tree
+    // node and segment that is farther away than the max_results-th best accepted segment is
+    // pruned. Since the order of the filter calls is not defined, the filter must not depend on
+    // the segments it has seen before. The queues are reused between the queries of a thread,
+    // so the search does not allocate once they are large enough.
+    //
+    // Subtrees and segments without an enabled direction in one of the buckets of bearing_mask
+    // are skipped. A filter that checks a bearing passes the mask of its bearing range here.
+    template <typename FilterT, typename OutputIter>
+    OutputIter Nearest(const Coordinate input_coordinate,
+                       const std::size_t max_results,
+                       const FilterT filter,
+                       OutputIter output,
+                       const bearing::BucketMask bearing_mask = bearing::ALL_BUCKETS) const
+    {
+        if (max_results == 0)
+            return output;
+
+        QueryHeap traversal_queue{GetQueryCandidateStorage()};
+        traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+
+        const auto &best =
+            FindNearest(input_coordinate, max_results, filter, bearing_mask, traversal_queue);
+        return std::transform(best.begin(), best.end(), output, [](const NearestResult &result) {
+            return result.data;
+        });
+    }
+
+    // Like the bounded Nearest, but only the given leaves are searched. Only segments within
+    // max_squared_distance of the projected input coordinate are considered. If fewer than
+    // max_results of them are found nothing is written and none is returned, closer segments
+    // may be in other leaves then.
+    template <typename FilterT, typename LeafIterT, typename OutputIter>
+    boost::optional<OutputIter> NearestInLeaves(const Coordinate input_coordinate,
+                                                const std::size_t max_results,
+                                                const FilterT filter,
+                                                const LeafIterT first_leaf,
+                                                const LeafIterT last_leaf,
+                                                const std::uint64_t max_squared_distance,
+                                                OutputIter output,
+                                                const bearing::BucketMask bearing_mask =
+                                                    bearing::ALL_BUCKETS) const
+    {
+        if (max_results == 0)
+            return output;
+
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
+        QueryHeap traversal_queue{GetQueryCandidateStorage()};
+        traversal_queue.set_bound(max_squared_distance);
+        std::for_each(first_leaf, last_leaf, [&](const std::uint32_t leaf_id) {
+            BOOST_ASSERT(leaf_id < m_leaves.size());
+            if (!MatchesBearing(m_leaves[leaf_id].bearing_mask, bearing_mask))
+                return;
+            const auto &rectangle = m_leaves[leaf_id].minimum_bounding_rectangle;
+            traversal_queue.push(QueryCandidate{
+                rectangle.GetMinSquaredDist(fixed_projected_coordinate), TreeIndex{leaf_id, true}});
+        });
+
+        const auto &best =
+            FindNearest(input_coordinate, max_results, filter, bearing_mask, traversal_queue);
+        if (best.size() < max_results || best.back().squared_distance > max_squared_distance)
+        {
+            return boost::none;
+        }
+        return std::transform(best.begin(), best.end(), output, [](const NearestResult &result) {
+            return result.data;
+        });
+    }
+
+    // Bounding boxes of the leaves in projected coordinates, indexed by leaf id
+    std::vector<Rectangle> GetLeafRectangles() const
+    {
+        std::vector<Rectangle> rectangles;
+        rectangles.reserve(m_leaves.size());
+        for (const auto &leaf : m_leaves)
+        {
+            rectangles.push_back(leaf.minimum_bounding_rectangle);
+        }
+        return rectangles;
+    }
+
+    // Override filter and terminator for the desired behaviour. Segments outside of
+    // bearing_mask are skipped as in the bounded Nearest, they are not passed to the terminator.
     template <typename FilterT, typename TerminationT>
-    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
-                                   const FilterT filter,
-                                   const TerminationT terminate) const
+    std::vector<EdgeDataT>
+    Nearest(const Coordinate input_coordinate,
+            const FilterT filter,
+            const TerminationT terminate,
+            const bearing::BucketMask bearing_mask = bearing::ALL_BUCKETS) const
     {
         std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
         Coordinate fixed_projected_coordinate{projected_coordinate};
 
         // initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
+        QueryHeap traversal_queue{GetQueryCandidateStorage()};
         traversal_queue.push(QueryCandidate{0, TreeIndex{}});
 
         while (!traversal_queue.empty())
@@ -497,14 +802,24 @@ class StaticRTree
                     ExploreLeafNode(current_tree_index,
                                     fixed_projected_coordinate,
                                     projected_coordinate,
+                                    bearing_mask,
                                     traversal_queue);
                 }
                 else
                 {
-                    ExploreTreeNode(
-                        current_tree_index, fixed_projected_coordinate, traversal_queue);
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    bearing_mask,
+                                    traversal_queue);
                 }
             }
+            else if (!current_query_node.is_refined)
+            { // only a lower bound of the distance is known, queue it with the exact one
+                traversal_queue.push(RefineSegment(current_tree_index,
+                                                   current_query_node.segment_index,
+                                                   fixed_projected_coordinate,
+                                                   projected_coordinate));
+            }
             else
             { // current candidate is an actual road segment
                 auto edge_data =
@@ -537,44 +852,425 @@ class StaticRTree
     }
 
   private:
+    // The queues are not shared between threads, a filter or terminator that runs another
+    // query on the same thread would overwrite them.
+    static std::vector<QueryCandidate> &GetQueryCandidateStorage()
+    {
+        static thread_local std::vector<QueryCandidate> storage;
+        return storage;
+    }
+
+    static std::vector<NearestResult> &GetNearestResultStorage()
+    {
+        static thread_local std::vector<NearestResult> storage;
+        return storage;
+    }
+
+    // Bounded best-first search from the candidates in the queue. Returns the best segments
+    // ordered by distance, the storage is reused by the next query of the thread.
+    template <typename FilterT>
+    const std::vector<NearestResult> &FindNearest(const Coordinate input_coordinate,
+                                                  const std::size_t max_results,
+                                                  const FilterT filter,
+                                                  const bearing::BucketMask bearing_mask,
+                                                  QueryHeap &traversal_queue) const
+    {
+        BOOST_ASSERT(max_results > 0);
+        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
+        Coordinate fixed_projected_coordinate{projected_coordinate};
+
+        // max heap of the best segments found so far
+        auto &best = GetNearestResultStorage();
+        best.clear();
+        std::size_t num_accepted = 0;
+
+        while (!traversal_queue.empty())
+        {
+            const QueryCandidate current_query_node = traversal_queue.top();
+            traversal_queue.pop();
+
+            // everything left in the queue is farther away than the found segments
+            if (best.size() == max_results &&
+                current_query_node.squared_min_dist > best.front().squared_distance)
+            {
+                break;
+            }
+
+            const TreeIndex &current_tree_index = current_query_node.tree_index;
+            if (!current_query_node.is_segment())
+            {
+                if (current_tree_index.is_leaf)
+                {
+                    ExploreLeafNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    projected_coordinate,
+                                    bearing_mask,
+                                    traversal_queue);
+                }
+                else
+                {
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    bearing_mask,
+                                    traversal_queue);
+                }
+                continue;
+            }
+
+            const auto current_segment =
+                current_query_node.is_refined
+                    ? current_query_node
+                    : RefineSegment(current_tree_index,
+                                    current_query_node.segment_index,
+                                    fixed_projected_coordinate,
+                                    projected_coordinate);
+            if (best.size() == max_results &&
+                current_segment.squared_min_dist >= best.front().squared_distance)
+            {
+                continue;
+            }
+
+            auto edge_data =
+                m_leaves[current_tree_index.index].objects[current_segment.segment_index];
+            const auto use_segment =
+                filter(CandidateSegment{current_segment.fixed_projected_coordinate, edge_data});
+            if (!use_segment.first && !use_segment.second)
+            {
+                continue;
+            }
+            edge_data.forward_segment_id.enabled &= use_segment.first;
+            edge_data.reverse_segment_id.enabled &= use_segment.second;
+
+            if (best.size() == max_results)
+            {
+                std::pop_heap(best.begin(), best.end());
+                best.pop_back();
+            }
+            best.push_back(
+                NearestResult{current_segment.squared_min_dist, num_accepted++, edge_data});
+            std::push_heap(best.begin(), best.end());
+
+            if (best.size() == max_results)
+            {
+                traversal_queue.set_bound(best.front().squared_distance);
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        return best;
+    }
+
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
+                         const bearing::BucketMask bearing_mask,
                          QueueT &traversal_queue) const
+    {
+        ExploreLeafNode(leaf_id,
+                        projected_input_coordinate_fixed,
+                        projected_input_coordinate,
+                        bearing_mask,
+                        traversal_queue,
+                        HasLeafCoordinates{});
+    }
+
+    template <typename QueueT>
+    void ExploreLeafNode(const TreeIndex &leaf_id,
+                         const Coordinate &projected_input_coordinate_fixed,
+                         const FloatCoordinate &projected_input_coordinate,
+                         const bearing::BucketMask bearing_mask,
+                         QueueT &traversal_queue,
+                         std::false_type) const
     {
         const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
 
         // current object represents a block on disk
         for (const auto i : irange(0u, current_leaf_node.object_count))
         {
-            const auto &current_edge = current_leaf_node.objects[i];
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
-
-            const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
-                projected_input_coordinate_fixed, projected_nearest);
-            // distance must be non-negative
-            BOOST_ASSERT(0. <= squared_distance);
-            traversal_queue.push(
-                QueryCandidate{squared_distance, leaf_id, i, Coordinate{projected_nearest}});
+            if (!MatchesBearing(current_leaf_node.bearing_masks[i], bearing_mask))
+                continue;
+            traversal_queue.push(RefineSegment(
+                leaf_id, i, projected_input_coordinate_fixed, projected_input_coordinate));
         }
     }
 
+    template <typename QueueT>
+    void ExploreLeafNode(const TreeIndex &leaf_id,
+                         const Coordinate &projected_input_coordinate_fixed,
+                         const FloatCoordinate &,
+                         const bearing::BucketMask bearing_mask,
+                         QueueT &traversal_queue,
+                         std::true_type) const
+    {
+        const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
+
+        // The distances to the bounding boxes of all segments are computed at once. Most
+        // segments of a leaf are never extracted from the queue, so the projection onto the
+        // segment is only done for the ones that are.
+        std::array<std::uint64_t, LEAF_NODE_SIZE> squared_lower_bounds;
+        leaf_scan::computeSquaredLowerBounds(GetSegmentColumns(current_leaf_node),
+                                             projected_input_coordinate_fixed,
+                                             squared_lower_bounds.data());
+
+        for (const auto i : irange(0u, current_leaf_node.object_count))
+        {
+            if (!MatchesBearing(current_leaf_node.bearing_masks[i], bearing_mask))
+                continue;
+            traversal_queue.push(QueryCandidate{squared_lower_bounds[i], leaf_id, i});
+        }
+    }
+
+    QueryCandidate RefineSegment(const TreeIndex &leaf_id,
+                                 const std::uint32_t segment_index,
+                                 const Coordinate &projected_input_coordinate_fixed,
+                                 const FloatCoordinate &projected_input_coordinate) const
+    {
+        FloatCoordinate projected_u;
+        FloatCoordinate projected_v;
+        std::tie(projected_u, projected_v) =
+            GetProjectedSegment(m_leaves[leaf_id.index], segment_index, HasLeafCoordinates{});
+
+        FloatCoordinate projected_nearest;
+        std::tie(std::ignore, projected_nearest) = coordinate_calculation::projectPointOnSegment(
+            projected_u, projected_v, projected_input_coordinate);
+
+        const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
+            projected_input_coordinate_fixed, projected_nearest);
+        // distance must be non-negative
+        BOOST_ASSERT(0. <= squared_distance);
+        return QueryCandidate{
+            squared_distance, leaf_id, segment_index, Coordinate{projected_nearest}};
+    }
+
+    void SearchLeafNode(const LeafNode &leaf,
+                        const Rectangle &search_rectangle,
+                        const Rectangle &,
+                        std::vector<EdgeDataT> &results,
+                        std::false_type) const
+    {
+        for (const auto i : irange(0u, leaf.object_count))
+        {
+            const auto &edge = leaf.objects[i];
+            const auto &u = m_coordinate_list[edge.u];
+            const auto &v = m_coordinate_list[edge.v];
+
+            // we don't need to project the coordinates here,
+            // because we use the unprojected rectangle to test against
+            const Rectangle bbox{std::min(u.lon, v.lon),
+                                 std::max(u.lon, v.lon),
+                                 std::min(u.lat, v.lat),
+                                 std::max(u.lat, v.lat)};
+            if (bbox.Intersects(search_rectangle))
+            {
+                results.push_back(edge);
+            }
+        }
+    }
+
+    void SearchLeafNode(const LeafNode &leaf,
+                        const Rectangle &,
+                        const Rectangle &projected_rectangle,
+                        std::vector<EdgeDataT> &results,
+                        std::true_type) const
+    {
+        // the stored coordinates are projected, test against the projected rectangle
+        std::array<std::uint32_t, LEAF_NODE_SIZE> indices;
+        const auto num_found = leaf_scan::findIntersecting(
+            GetSegmentColumns(leaf), projected_rectangle, indices.data());
+
+        for (const auto i : irange(0u, num_found))
+        {
+            results.push_back(leaf.objects[indices[i]]);
+        }
+    }
+
+    static Rectangle ProjectRectangle(const Rectangle &rectangle)
+    {
+        return {rectangle.min_lon,
+                rectangle.max_lon,
+                toFixed(FloatLatitude{
+                    web_mercator::latToY(toFloating(FixedLatitude(rectangle.min_lat)))}),
+                toFixed(FloatLatitude{
+                    web_mercator::latToY(toFloating(FixedLatitude(rectangle.max_lat)))})};
+    }
+
+    // Same tests as SearchLeafNode, on the coordinates the leaves are built from
+    bool IsInBox(const EdgeDataT &edge,
+                 const Rectangle &search_rectangle,
+                 const Rectangle &,
+                 std::false_type) const
+    {
+        const auto &u = m_coordinate_list[edge.u];
+        const auto &v = m_coordinate_list[edge.v];
+        const Rectangle bbox{std::min(u.lon, v.lon),
+                             std::max(u.lon, v.lon),
+                             std::min(u.lat, v.lat),
+                             std::max(u.lat, v.lat)};
+        return bbox.Intersects(search_rectangle);
+    }
+
+    bool IsInBox(const EdgeDataT &edge,
+                 const Rectangle &,
+                 const Rectangle &projected_rectangle,
+                 std::true_type) const
+    {
+        const Coordinate u{web_mercator::fromWGS84(Coordinate{m_coordinate_list[edge.u]})};
+        const Coordinate v{web_mercator::fromWGS84(Coordinate{m_coordinate_list[edge.v]})};
+        const Rectangle bbox{std::min(u.lon, v.lon),
+                             std::max(u.lon, v.lon),
+                             std::min(u.lat, v.lat),
+                             std::max(u.lat, v.lat)};
+        return bbox.Intersects(projected_rectangle);
+    }
+
+    // Without a bearing nothing is pruned, this keeps segments without an enabled direction
+    static bool MatchesBearing(const bearing::BucketMask mask,
+                               const bearing::BucketMask bearing_mask)
+    {
+        return bearing_mask == bearing::ALL_BUCKETS || (mask & bearing_mask) != 0;
+    }
+
+    // Buckets of the bearings of the enabled directions, rounded like the bearing filter does
+    bearing::BucketMask GetBearingMask(const EdgeDataT &edge) const
+    {
+        const auto forward_bearing = coordinate_calculation::bearing(m_coordinate_list[edge.u],
+                                                                     m_coordinate_list[edge.v]);
+        const auto backward_bearing =
+            (forward_bearing + 180) > 360 ? (forward_bearing - 180) : (forward_bearing + 180);
+
+        bearing::BucketMask mask = 0;
+        if (edge.forward_segment_id.enabled)
+            mask |= bearing::toBucketMask(static_cast<int>(std::round(forward_bearing)));
+        if (edge.reverse_segment_id.enabled)
+            mask |= bearing::toBucketMask(static_cast<int>(std::round(backward_bearing)));
+        return mask;
+    }
+
+    static leaf_scan::SegmentColumns GetSegmentColumns(const LeafNode &leaf)
+    {
+        return {leaf.u_lons.data(),
+                leaf.u_lats.data(),
+                leaf.v_lons.data(),
+                leaf.v_lats.data(),
+                leaf.object_count};
+    }
+
+    // Zeroed and page aligned memory for count leaves. Before C++17 new does not respect the
+    // alignment of over-aligned types, so the buffer is aligned by hand.
+    static LeafNode *ResetLeafBuffer(std::vector<char> &buffer, const std::uint64_t count)
+    {
+        buffer.assign((count + 1) * sizeof(LeafNode), 0);
+        const auto address = reinterpret_cast<std::uintptr_t>(buffer.data());
+        const auto aligned_address = (address + alignof(LeafNode) - 1) &
+                                     ~static_cast<std::uintptr_t>(alignof(LeafNode) - 1);
+        return reinterpret_cast<LeafNode *>(aligned_address);
+    }
+
+    // Packs the elements of the leaf in Hilbert order into the leaf memory
+    const LeafNode &BuildLeafNode(const std::vector<EdgeDataT> &input_data_vector,
+                                  const std::vector<WrappedInputElement> &input_wrapper_vector,
+                                  const std::uint64_t leaf_index,
+                                  LeafNode *leaf_memory) const
+    {
+        LeafNode &current_leaf = *new (leaf_memory) LeafNode();
+        Rectangle &rectangle = current_leaf.minimum_bounding_rectangle;
+
+        const std::uint64_t first_element = leaf_index * LEAF_NODE_SIZE;
+        const std::uint64_t last_element =
+            std::min<std::uint64_t>(first_element + LEAF_NODE_SIZE, input_wrapper_vector.size());
+        for (auto wrapped_element_index = first_element; wrapped_element_index < last_element;
+             ++wrapped_element_index)
+        {
+            const std::uint32_t object_index = wrapped_element_index - first_element;
+            const std::uint32_t input_object_index =
+                input_wrapper_vector[wrapped_element_index].m_array_index;
+            const EdgeDataT &object = input_data_vector[input_object_index];
+
+            current_leaf.object_count += 1;
+            current_leaf.objects[object_index] = object;
+
+            const Coordinate projected_u{
+                web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
+            const Coordinate projected_v{
+                web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
+
+            BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
+            BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
+
+            SetSegmentCoordinates(
+                current_leaf, object_index, projected_u, projected_v, HasLeafCoordinates{});
+            current_leaf.bearing_masks[object_index] = GetBearingMask(object);
+            current_leaf.bearing_mask |= current_leaf.bearing_masks[object_index];
+
+            rectangle.min_lon =
+                std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
+            rectangle.max_lon =
+                std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
+
+            rectangle.min_lat =
+                std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
+            rectangle.max_lat =
+                std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
+
+            BOOST_ASSERT(rectangle.IsValid());
+        }
+        return current_leaf;
+    }
+
+    void SetSegmentCoordinates(LeafNode &,
+                               const std::uint32_t,
+                               const Coordinate &,
+                               const Coordinate &,
+                               std::false_type) const
+    {
+    }
+
+    void SetSegmentCoordinates(LeafNode &leaf,
+                               const std::uint32_t index,
+                               const Coordinate &projected_u,
+                               const Coordinate &projected_v,
+                               std::true_type) const
+    {
+        leaf.u_lons[index] = projected_u.lon;
+        leaf.u_lats[index] = projected_u.lat;
+        leaf.v_lons[index] = projected_v.lon;
+        leaf.v_lats[index] = projected_v.lat;
+    }
+
+    std::pair<FloatCoordinate, FloatCoordinate>
+    GetProjectedSegment(const LeafNode &leaf, const std::uint32_t index, std::false_type) const
+    {
+        const auto &edge = leaf.objects[index];
+        return {web_mercator::fromWGS84(m_coordinate_list[edge.u]),
+                web_mercator::fromWGS84(m_coordinate_list[edge.v])};
+    }
+
+    std::pair<FloatCoordinate, FloatCoordinate>
+    GetProjectedSegment(const LeafNode &leaf, const std::uint32_t index, std::true_type) const
+    {
+        return {FloatCoordinate{Coordinate{leaf.u_lons[index], leaf.u_lats[index]}},
+                FloatCoordinate{Coordinate{leaf.v_lons[index], leaf.v_lats[index]}}};
+    }
+
     template <class QueueT>
     void ExploreTreeNode(const TreeIndex &parent_id,
                          const Coordinate &fixed_projected_input_coordinate,
+                         const bearing::BucketMask bearing_mask,
                          QueueT &traversal_queue) const
     {
         const TreeNode &parent = m_search_tree[parent_id.index];
         for (std::uint32_t i = 0; i < parent.child_count; ++i)
         {
             const TreeIndex child_id = parent.children[i];
+            const auto child_bearing_mask = child_id.is_leaf
+                                                ? m_leaves[child_id.index].bearing_mask
+                                                : m_search_tree[child_id.index].bearing_mask;
+            if (!MatchesBearing(child_bearing_mask, bearing_mask))
+                continue;
+
             const auto &child_rectangle =
                 child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
                                  : m_search_tree[child_id.index].minimum_bounding_rectangle;
@@ -0,0 +1,135 @@
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+constexpr std::size_t NUM_COORDINATES = 1000000;
+constexpr int NUM_ROUNDS = 20;
+
+// Coordinates of a random walk, so consecutive ones are at most max_step apart
+std::vector<Coordinate> randomWalk(const std::int32_t max_step, std::mt19937 &generator)
+{
+    std::uniform_int_distribution<std::int32_t> lon_dist(-179000000, 179000000);
+    std::uniform_int_distribution<std::int32_t> lat_dist(-80000000, 80000000);
+    std::uniform_int_distribution<std::int32_t> step_dist(-max_step, max_step);
+
+    std::vector<Coordinate> coordinates;
+    coordinates.reserve(NUM_COORDINATES);
+    std::int32_t lon = lon_dist(generator);
+    std::int32_t lat = lat_dist(generator);
+    for (std::size_t i = 0; i < NUM_COORDINATES; ++i)
+    {
+        coordinates.push_back(Coordinate{FixedLongitude{lon}, FixedLatitude{lat}});
+        // steps that would leave the valid range are reflected
+        const auto lon_step = step_dist(generator);
+        const auto lat_step = step_dist(generator);
+        lon += std::abs(lon + lon_step) > 179000000 ? -lon_step : lon_step;
+        lat += std::abs(lat + lat_step) > 80000000 ? -lat_step : lat_step;
+    }
+    return coordinates;
+}
+
+template <typename DistanceFunction>
+double benchmarkSegmentLengths(const char *name,
+                               const std::vector<Coordinate> &coordinates,
+                               DistanceFunction distance)
+{
+    std::vector<double> lengths(coordinates.size() - 1);
+    double total = 0;
+    TIMER_START(lengths);
+    for (int round = 0; round < NUM_ROUNDS; ++round)
+    {
+        for (std::size_t index = 1; index < coordinates.size(); ++index)
+        {
+            lengths[index - 1] = distance(coordinates[index - 1], coordinates[index]);
+        }
+        total += lengths[round];
+    }
+    TIMER_STOP(lengths);
+    util::Log() << name << ": "
+                << TIMER_NSEC(lengths) / static_cast<double>(NUM_ROUNDS * lengths.size())
+                << " ns/distance";
+    return total;
+}
+
+void benchmarkErrors(const std::int32_t max_step, std::mt19937 &generator)
+{
+    const auto coordinates = randomWalk(max_step, generator);
+
+    std::vector<double> lengths(coordinates.size() - 1);
+    coordinate_calculation::approximateSegmentLengths(
+        coordinates.data(), coordinates.size(), lengths.data());
+
+    double max_length = 0;
+    double max_absolute_error = 0;
+    double max_relative_error = 0;
+    for (std::size_t index = 1; index < coordinates.size(); ++index)
+    {
+        const auto exact = coordinate_calculation::haversineDistance(coordinates[index - 1],
+                                                                     coordinates[index]);
+        const auto error = std::abs(lengths[index - 1] - exact);
+        max_length = std::max(max_length, exact);
+        max_absolute_error = std::max(max_absolute_error, error);
+        if (exact > 0)
+            max_relative_error = std::max(max_relative_error, error / exact);
+    }
+    util::Log() << "distances up to " << max_length / 1000. << " km: max error "
+                << max_absolute_error << " m, " << max_relative_error * 100. << "%";
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+    std::mt19937 generator(1337);
+
+    // about 1km, 10km, 100km and 1000km steps at the equator
+    for (const std::int32_t max_step : {6000, 60000, 600000, 6000000})
+    {
+        benchmarkErrors(max_step, generator);
+    }
+
+    const auto coordinates = randomWalk(60000, generator);
+    double checksum = 0;
+    checksum +=
+        benchmarkSegmentLengths("haversineDistance", coordinates, [](const auto a, const auto b) {
+            return coordinate_calculation::haversineDistance(a, b);
+        });
+    checksum +=
+        benchmarkSegmentLengths("greatCircleDistance", coordinates, [](const auto a, const auto b) {
+            return coordinate_calculation::greatCircleDistance(a, b);
+        });
+    checksum +=
+        benchmarkSegmentLengths("approximateDistance", coordinates, [](const auto a, const auto b) {
+            return coordinate_calculation::approximateDistance(a, b);
+        });
+
+    std::vector<double> lengths(coordinates.size() - 1);
+    TIMER_START(segment_lengths);
+    for (int round = 0; round < NUM_ROUNDS; ++round)
+    {
+        coordinate_calculation::approximateSegmentLengths(
+            coordinates.data(), coordinates.size(), lengths.data());
+        checksum += lengths[round];
+    }
+    TIMER_STOP(segment_lengths);
+    util::Log() << "approximateSegmentLengths: "
+                << TIMER_NSEC(segment_lengths) / static_cast<double>(NUM_ROUNDS * lengths.size())
+                << " ns/distance";
+
+    // keeps the distances from being optimized away
+    util::Log() << "checksum: " << checksum;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include "util/log.hpp"
+#include "util/packed_vector.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// about the number of segments of a continent, so the blocks don't fit into the caches
+constexpr std::size_t NUM_SEGMENTS = 64 * 1024 * 1024;
+constexpr std::size_t NUM_CANDIDATES = 10 * 1000 * 1000;
+
+using PackedWeights = PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS>;
+
+// Reads the forward and reverse weight of random segments, like GeospatialQuery::HasValidEdge
+// does for every snapping candidate
+template <typename WeightsT>
+std::uint64_t benchmarkCandidates(const char *name,
+                                  const WeightsT &fwd_weights,
+                                  const WeightsT &rev_weights,
+                                  const std::vector<std::uint32_t> &candidates)
+{
+    std::uint64_t valid = 0;
+    TIMER_START(candidates);
+    for (const auto segment : candidates)
+    {
+        valid += fwd_weights[segment] != INVALID_SEGMENT_WEIGHT;
+        valid += rev_weights[NUM_SEGMENTS - segment - 1] != INVALID_SEGMENT_WEIGHT;
+    }
+    TIMER_STOP(candidates);
+    util::Log() << name << " random: "
+                << TIMER_NSEC(candidates) / static_cast<double>(candidates.size())
+                << " ns/candidate";
+    return valid;
+}
+
+// Unpacks all weights in order, like the facade does for the geometries of a response
+template <typename WeightsT> std::uint64_t benchmarkScan(const char *name, const WeightsT &weights)
+{
+    std::uint64_t sum = 0;
+    TIMER_START(scan);
+    for (const auto weight : weights)
+    {
+        sum += weight;
+    }
+    TIMER_STOP(scan);
+    util::Log() << name << " sequential: " << TIMER_NSEC(scan) / static_cast<double>(NUM_SEGMENTS)
+                << " ns/value";
+    return sum;
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+    std::mt19937 generator(1337);
+
+    std::uniform_int_distribution<SegmentWeight> weight_dist(0, INVALID_SEGMENT_WEIGHT);
+    std::vector<SegmentWeight> fwd_weights(NUM_SEGMENTS);
+    std::vector<SegmentWeight> rev_weights(NUM_SEGMENTS);
+    for (std::size_t index = 0; index < NUM_SEGMENTS; ++index)
+    {
+        fwd_weights[index] = weight_dist(generator);
+        rev_weights[index] = weight_dist(generator);
+    }
+
+    // packed like osrm-datastore loads the segment data
+    const auto num_blocks = PackedWeights::elements_to_blocks(NUM_SEGMENTS);
+    std::vector<std::uint64_t> fwd_blocks(num_blocks);
+    std::vector<std::uint64_t> rev_blocks(num_blocks);
+    PackedWeights packed_fwd_weights;
+    PackedWeights packed_rev_weights;
+    packed_fwd_weights.reset(fwd_blocks.data(), fwd_blocks.size());
+    packed_rev_weights.reset(rev_blocks.data(), rev_blocks.size());
+    for (std::size_t index = 0; index < NUM_SEGMENTS; ++index)
+    {
+        packed_fwd_weights.push_back(fwd_weights[index]);
+        packed_rev_weights.push_back(rev_weights[index]);
+    }
+
+    std::uniform_int_distribution<std::uint32_t> segment_dist(0, NUM_SEGMENTS - 1);
+    std::vector<std::uint32_t> candidates(NUM_CANDIDATES);
+    for (auto &candidate : candidates)
+    {
+        candidate = segment_dist(generator);
+    }
+
+    std::uint64_t checksum = 0;
+    checksum += benchmarkCandidates("unpacked", fwd_weights, rev_weights, candidates);
+    checksum += benchmarkCandidates("packed", packed_fwd_weights, packed_rev_weights, candidates);
+    checksum += benchmarkScan("unpacked", fwd_weights);
+    checksum += benchmarkScan("packed", packed_fwd_weights);
+
+    // keeps the reads from being optimized away
+    util::Log() << "checksum: " << checksum;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#include "partition/cell_storage.hpp"
+#include "partition/files.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/log.hpp"
+#include "util/relax_kernels.hpp"
+#include "util/timing_util.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Runs the kernel over every row (forward) and column (backward) of all cells of a level
+// and returns the number of valid clique arcs found to keep the work observable.
+std::size_t relaxLevel(const partition::MultiLevelPartition &mlp,
+                       const partition::CellStorage &storage,
+                       LevelID level,
+                       util::simd::FilterValidWeightsFn kernel)
+{
+    std::vector<EdgeWeight> candidates;
+    std::vector<std::uint32_t> indices;
+
+    std::size_t num_valid = 0;
+    for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+    {
+        const auto cell = storage.GetCell(level, id);
+        const auto num_sources = cell.GetSourceNodes().size();
+        const auto num_destinations = cell.GetDestinationNodes().size();
+        candidates.resize(std::max(num_sources, num_destinations));
+        indices.resize(candidates.size());
+
+        for (auto source : cell.GetSourceNodes())
+        {
+            const auto row = cell.GetOutWeight(source);
+            num_valid += kernel(&*row.begin(), row.size(), 1, 0, candidates.data(), indices.data());
+        }
+        for (auto destination : cell.GetDestinationNodes())
+        {
+            const auto column = cell.GetInWeight(destination);
+            if (column.empty())
+                continue;
+            num_valid += kernel(&*column.begin(),
+                                column.size(),
+                                num_destinations,
+                                0,
+                                candidates.data(),
+                                indices.data());
+        }
+    }
+    return num_valid;
+}
+
+void benchmark(const partition::MultiLevelPartition &mlp,
+               const partition::CellStorage &storage,
+               const std::string &name,
+               util::simd::FilterValidWeightsFn kernel)
+{
+    if (kernel == nullptr)
+    {
+        std::cout << name << ": not supported" << std::endl;
+        return;
+    }
+
+    constexpr auto NUM_ROUNDS = 10;
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        std::size_t num_valid = 0;
+        TIMER_START(relax);
+        for (auto round = 0; round < NUM_ROUNDS; ++round)
+        {
+            num_valid += relaxLevel(mlp, storage, level, kernel);
+        }
+        TIMER_STOP(relax);
+
+        std::cout << name << " level " << static_cast<int>(level) << ": "
+                  << TIMER_MSEC(relax) / NUM_ROUNDS << "ms per pass, "
+                  << num_valid / NUM_ROUNDS << " valid clique arcs" << std::endl;
+    }
+}
+}
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cout << "./relax-bench file.osrm.partition file.osrm.cells"
+                  << "\n";
+        return 1;
+    }
+
+    osrm::util::LogPolicy::GetInstance().Unmute();
+
+    osrm::partition::MultiLevelPartition mlp;
+    osrm::partition::files::readPartition(argv[1], mlp);
+    osrm::partition::CellStorage storage;
+    osrm::partition::files::readCells(argv[2], storage);
+
+    using namespace osrm::util::simd;
+    osrm::benchmarks::benchmark(mlp, storage, "scalar", &detail::filterValidWeightsScalar);
+    osrm::benchmarks::benchmark(mlp, storage, "sse2", detail::getFilterValidWeightsSSE2());
+    osrm::benchmarks::benchmark(mlp, storage, "avx2", detail::getFilterValidWeightsAVX2());
+    std::cout << "Runtime dispatch selects " << getKernelName() << std::endl;
+
+    return 0;
+}
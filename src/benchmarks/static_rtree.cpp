@@ -7,9 +7,13 @@
 #include "util/coordinate.hpp"
 #include "util/timing_util.hpp"
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <vector>
 
+#include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
 namespace osrm
@@ -27,7 +31,24 @@ constexpr int32_t WORLD_MIN_LON = -180 * COORDINATE_PRECISION;
 constexpr int32_t WORLD_MAX_LON = 180 * COORDINATE_PRECISION;
 
 using RTreeLeaf = extractor::EdgeBasedNode;
-using BenchStaticRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::Container>;
+// layout written by osrm-extract
+using BenchStaticRTree = util::StaticRTree<RTreeLeaf,
+                                           storage::Ownership::Container,
+                                           128,
+                                           4096,
+                                           util::LeafLayout::ObjectsAndCoordinates>;
+// leaves that only hold the edge data, for comparison
+using BenchObjectsStaticRTree = util::StaticRTree<RTreeLeaf,
+                                                  storage::Ownership::Container,
+                                                  128,
+                                                  4096,
+                                                  util::LeafLayout::Objects>;
+// same tree with the leaves loaded into memory, like osrm-datastore --load-rtree-leaves
+using BenchMemoryStaticRTree = util::StaticRTree<RTreeLeaf,
+                                                 storage::Ownership::View,
+                                                 128,
+                                                 4096,
+                                                 util::LeafLayout::ObjectsAndCoordinates>;
 
 std::vector<util::Coordinate> loadCoordinates(const boost::filesystem::path &nodes_file)
 {
@@ -67,7 +88,53 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")" << std::endl;
 }
 
-void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+std::vector<RTreeLeaf> loadLeafObjects(const boost::filesystem::path &leaves_file)
+{
+    boost::filesystem::ifstream leaves_stream(leaves_file, std::ios::binary);
+
+    std::vector<RTreeLeaf> objects;
+    BenchStaticRTree::LeafNode leaf;
+    while (leaves_stream.read(reinterpret_cast<char *>(&leaf), sizeof(leaf)))
+    {
+        objects.insert(
+            objects.end(), leaf.objects.begin(), leaf.objects.begin() + leaf.object_count);
+    }
+    return objects;
+}
+
+// Tree nodes and leaf pages read into process memory
+struct InMemoryRTree
+{
+    using TreeNode = BenchMemoryStaticRTree::TreeNode;
+    using LeafNode = BenchMemoryStaticRTree::LeafNode;
+
+    InMemoryRTree(const boost::filesystem::path &ram_file, const boost::filesystem::path &leaf_file)
+    {
+        storage::io::FileReader tree_node_file(ram_file,
+                                               storage::io::FileReader::VerifyFingerprint);
+        const auto header = BenchMemoryStaticRTree::ReadFileHeader(tree_node_file, ram_file);
+        nodes.resize(tree_node_file.ReadElementCount64());
+        tree_node_file.ReadInto(nodes);
+
+        storage::io::FileReader leaf_node_file(leaf_file,
+                                               storage::io::FileReader::HasNoFingerprint);
+        BenchMemoryStaticRTree::CheckLeafFileSize(header, leaf_node_file.GetSize(), leaf_file);
+        num_leaves = header.number_of_leaves;
+        // operator new does not respect the page alignment of the leaves
+        memory.reset(new char[(num_leaves + 1) * sizeof(LeafNode)]);
+        const auto address = reinterpret_cast<std::uintptr_t>(memory.get());
+        leaves = reinterpret_cast<LeafNode *>((address + alignof(LeafNode) - 1) &
+                                              ~(std::uintptr_t{alignof(LeafNode)} - 1));
+        leaf_node_file.ReadInto(leaves, num_leaves);
+    }
+
+    std::vector<TreeNode> nodes;
+    std::unique_ptr<char[]> memory;
+    LeafNode *leaves;
+    std::size_t num_leaves;
+};
+
+template <typename RTreeT> void benchmark(RTreeT &rtree, unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -106,7 +173,37 @@ int main(int argc, char **argv)
 
     osrm::benchmarks::BenchStaticRTree rtree(ram_path, file_path, coords);
 
+    std::cout << "Leaves with segment coordinates, memory mapped:" << std::endl;
     osrm::benchmarks::benchmark(rtree, 10000);
 
+    {
+        osrm::benchmarks::InMemoryRTree memory(ram_path, file_path);
+        osrm::util::vector_view<osrm::util::Coordinate> coords_view(coords.data(), coords.size());
+        osrm::benchmarks::BenchMemoryStaticRTree memory_rtree(memory.nodes.data(),
+                                                              memory.nodes.size(),
+                                                              memory.leaves,
+                                                              memory.num_leaves,
+                                                              coords_view);
+
+        std::cout << "Leaves with segment coordinates, loaded into memory:" << std::endl;
+        osrm::benchmarks::benchmark(memory_rtree, 10000);
+    }
+
+    // rebuild the tree from the same segments with leaves that only hold the edge data
+    const auto objects = osrm::benchmarks::loadLeafObjects(file_path);
+    const auto objects_path = boost::filesystem::temp_directory_path() /
+                              boost::filesystem::unique_path("rtree-bench-%%%%%%%%");
+    const auto objects_ram_path = objects_path.string() + ".ramIndex";
+    const auto objects_file_path = objects_path.string() + ".fileIndex";
+    {
+        osrm::benchmarks::BenchObjectsStaticRTree objects_rtree(
+            objects, objects_ram_path, objects_file_path, coords);
+
+        std::cout << "Leaves without segment coordinates:" << std::endl;
+        osrm::benchmarks::benchmark(objects_rtree, 10000);
+    }
+    boost::filesystem::remove(objects_ram_path);
+    boost::filesystem::remove(objects_file_path);
+
     return 0;
 }
@@ -1,6 +1,8 @@
 #include "customizer/customizer.hpp"
 #include "customizer/cell_customizer.hpp"
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
+#include "customizer/overlay_graph.hpp"
 
 #include "partition/cell_storage.hpp"
 #include "partition/edge_based_graph_reader.hpp"
@@ -14,6 +16,8 @@
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 namespace osrm
 {
 namespace customizer
@@ -123,6 +127,22 @@ int Customizer::Run(const CustomizationConfig &config)
     TIMER_STOP(writing_graph);
     util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
 
+    if (config.write_overlay_graph)
+    {
+        TIMER_START(writing_overlay_graph);
+        OverlayGraph overlay_graph(mlp, storage);
+        files::writeOverlayGraph(config.mld_overlay_path, overlay_graph);
+        TIMER_STOP(writing_overlay_graph);
+        util::Log() << "Overlay graph writing took " << TIMER_SEC(writing_overlay_graph)
+                    << " seconds";
+    }
+    else if (boost::filesystem::exists(config.mld_overlay_path))
+    {
+        // an overlay graph from a previous run would not match the new cell weights
+        util::Log(logWARNING) << "Removing outdated overlay graph " << config.mld_overlay_path;
+        boost::filesystem::remove(config.mld_overlay_path);
+    }
+
     CellStorageStatistics(*edge_based_graph, mlp, storage);
 
     return 0;
@@ -0,0 +1,259 @@
+#include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "storage/storage.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include "boost/assert.hpp"
+#include <boost/filesystem/operations.hpp>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace
+{
+// Identity of an input file at the time the image was written. The change time and inode
+// can't be carried over by copying the file, unlike its modification time.
+struct InputStamp
+{
+    std::uint64_t size;
+    std::int64_t modified_seconds;
+    std::int64_t modified_nanoseconds;
+    std::int64_t changed_seconds;
+    std::int64_t changed_nanoseconds;
+    std::uint64_t inode;
+
+    bool operator==(const InputStamp &other) const
+    {
+        return size == other.size && modified_seconds == other.modified_seconds &&
+               modified_nanoseconds == other.modified_nanoseconds &&
+               changed_seconds == other.changed_seconds &&
+               changed_nanoseconds == other.changed_nanoseconds && inode == other.inode;
+    }
+    bool operator!=(const InputStamp &other) const { return !(*this == other); }
+};
+
+constexpr std::size_t NUM_IMAGE_INPUTS = 21;
+
+struct ImageHeader
+{
+    util::FingerPrint fingerprint;
+    storage::DataLayout layout;
+    std::array<InputStamp, NUM_IMAGE_INPUTS> inputs;
+};
+
+// The data starts page aligned, so all blocks have the same alignment as in the mapping that
+// was used to write the image.
+constexpr std::size_t IMAGE_PAGE_SIZE = 4096;
+constexpr std::size_t IMAGE_DATA_OFFSET =
+    (sizeof(ImageHeader) + IMAGE_PAGE_SIZE - 1) / IMAGE_PAGE_SIZE * IMAGE_PAGE_SIZE;
+
+bool isSameLayout(const storage::DataLayout &lhs, const storage::DataLayout &rhs)
+{
+    return lhs.num_entries == rhs.num_entries && lhs.entry_size == rhs.entry_size &&
+           lhs.entry_align == rhs.entry_align;
+}
+
+InputStamp getInputStamp(const boost::filesystem::path &path)
+{
+    // missing optional files get a stamp of their own
+    InputStamp stamp{std::numeric_limits<std::uint64_t>::max(), 0, 0, 0, 0, 0};
+#ifdef _WIN32
+    boost::system::error_code error;
+    const auto size = boost::filesystem::file_size(path, error);
+    if (!error)
+    {
+        stamp.size = size;
+        stamp.modified_seconds = boost::filesystem::last_write_time(path);
+    }
+#else
+    struct stat status;
+    if (::stat(path.string().c_str(), &status) == 0)
+    {
+        stamp.size = status.st_size;
+#ifdef __APPLE__
+        stamp.modified_seconds = status.st_mtimespec.tv_sec;
+        stamp.modified_nanoseconds = status.st_mtimespec.tv_nsec;
+        stamp.changed_seconds = status.st_ctimespec.tv_sec;
+        stamp.changed_nanoseconds = status.st_ctimespec.tv_nsec;
+#else
+        stamp.modified_seconds = status.st_mtim.tv_sec;
+        stamp.modified_nanoseconds = status.st_mtim.tv_nsec;
+        stamp.changed_seconds = status.st_ctim.tv_sec;
+        stamp.changed_nanoseconds = status.st_ctim.tv_nsec;
+#endif
+        stamp.inode = status.st_ino;
+    }
+#endif
+    return stamp;
+}
+
+std::array<InputStamp, NUM_IMAGE_INPUTS> getInputStamps(const storage::StorageConfig &config)
+{
+    const std::array<boost::filesystem::path, NUM_IMAGE_INPUTS> paths = {
+        {config.ram_index_path,
+         config.file_index_path,
+         config.snapping_grid_path,
+         config.hsgr_data_path,
+         config.nodes_data_path,
+         config.edges_data_path,
+         config.core_data_path,
+         config.geometries_path,
+         config.timestamp_path,
+         config.turn_weight_penalties_path,
+         config.turn_duration_penalties_path,
+         config.datasource_names_path,
+         config.names_data_path,
+         config.properties_path,
+         config.intersection_class_path,
+         config.turn_lane_data_path,
+         config.turn_lane_description_path,
+         config.mld_partition_path,
+         config.mld_storage_path,
+         config.mld_graph_path,
+         config.mld_overlay_path}};
+
+    std::array<InputStamp, NUM_IMAGE_INPUTS> stamps;
+    std::transform(paths.begin(), paths.end(), stamps.begin(), getInputStamp);
+    return stamps;
+}
+
+// The image is rebuilt unless every input file is still the one it was written from
+bool isImageValid(const storage::StorageConfig &config, const storage::DataLayout &layout)
+{
+    const auto &path = config.mmap_image_path;
+    if (!boost::filesystem::exists(path) ||
+        boost::filesystem::file_size(path) != IMAGE_DATA_OFFSET + layout.GetSizeOfLayout())
+    {
+        return false;
+    }
+
+    ImageHeader header;
+    std::ifstream image(path.string(), std::ios::binary);
+    if (!image.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+
+    return header.fingerprint.IsValid() &&
+           header.fingerprint.IsDataCompatible(util::FingerPrint::GetValid()) &&
+           isSameLayout(header.layout, layout) && header.inputs == getInputStamps(config);
+}
+
+// Writes the image to a temporary file first and renames it, so concurrently starting
+// processes never map a partially written image.
+void writeImage(const storage::StorageConfig &config,
+                storage::Storage &storage,
+                const storage::DataLayout &layout)
+{
+    const auto &path = config.mmap_image_path;
+    const auto temporary_path =
+        boost::filesystem::unique_path(path.string() + ".%%%%-%%%%-%%%%.tmp");
+
+    util::Log() << "Writing memory mapped image " << path.string();
+    TIMER_START(write_image);
+    // stamped before reading, inputs that change while the image is written invalidate it
+    const auto inputs = getInputStamps(config);
+    try
+    {
+        {
+            std::ofstream{temporary_path.string(), std::ios::binary};
+            boost::filesystem::resize_file(temporary_path,
+                                           IMAGE_DATA_OFFSET + layout.GetSizeOfLayout());
+
+            boost::interprocess::file_mapping file(temporary_path.string().c_str(),
+                                                   boost::interprocess::read_write);
+            boost::interprocess::mapped_region region(file, boost::interprocess::read_write);
+
+            auto base = static_cast<char *>(region.get_address());
+            auto header = reinterpret_cast<ImageHeader *>(base);
+            header->fingerprint = util::FingerPrint::GetValid();
+            header->layout = layout;
+            header->inputs = inputs;
+            storage.PopulateData(layout, base + IMAGE_DATA_OFFSET);
+
+            if (!region.flush())
+            {
+                throw util::exception("Could not write memory mapped image " +
+                                      temporary_path.string() + SOURCE_REF);
+            }
+        }
+        boost::filesystem::rename(temporary_path, path);
+    }
+    catch (...)
+    {
+        // don't leave a partial image behind for every failed start
+        boost::system::error_code error;
+        boost::filesystem::remove(temporary_path, error);
+        throw;
+    }
+    TIMER_STOP(write_image);
+    util::Log() << "Memory mapped image written in " << TIMER_SEC(write_image) << " seconds";
+}
+}
+
+MMapMemoryAllocator::MMapMemoryAllocator(const storage::StorageConfig &config, const bool prefetch)
+{
+    storage::Storage storage(config);
+
+    // The layout only needs the file headers, so it is cheap to compute on every start
+    storage::DataLayout expected_layout;
+    storage.PopulateLayout(expected_layout);
+
+    if (!isImageValid(config, expected_layout))
+    {
+        try
+        {
+            writeImage(config, storage, expected_layout);
+        }
+        catch (const boost::filesystem::filesystem_error &error)
+        {
+            throw util::exception("Could not create memory mapped image " +
+                                  config.mmap_image_path.string() + ": " + error.what() +
+                                  SOURCE_REF);
+        }
+    }
+
+    mapped_file = boost::interprocess::file_mapping(config.mmap_image_path.string().c_str(),
+                                                    boost::interprocess::read_only);
+    // Private mapping: pages are shared through the page cache until written
+    mapped_image =
+        boost::interprocess::mapped_region(mapped_file, boost::interprocess::read_private);
+
+    const auto advice = prefetch ? boost::interprocess::mapped_region::advice_willneed
+                                 : boost::interprocess::mapped_region::advice_random;
+    if (!mapped_image.advise(advice))
+    {
+        util::Log(logWARNING) << "Could not advise the kernel about the memory mapped image";
+    }
+
+    auto base = static_cast<char *>(mapped_image.get_address());
+    layout = &reinterpret_cast<ImageHeader *>(base)->layout;
+    memory = base + IMAGE_DATA_OFFSET;
+    BOOST_ASSERT(isSameLayout(*layout, expected_layout));
+}
+
+MMapMemoryAllocator::~MMapMemoryAllocator() {}
+
+storage::DataLayout &MMapMemoryAllocator::GetLayout() { return *layout; }
+char *MMapMemoryAllocator::GetMemory() { return memory; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -3,6 +3,8 @@
 
 #include "boost/assert.hpp"
 
+#include <utility>
+
 namespace osrm
 {
 namespace engine
@@ -10,9 +12,12 @@ namespace engine
 namespace datafacade
 {
 
-ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config)
+ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                               const bool load_rtree_leaves)
 {
-    storage::Storage storage(config);
+    auto storage_config = config;
+    storage_config.load_rtree_leaves = storage_config.load_rtree_leaves || load_rtree_leaves;
+    storage::Storage storage(std::move(storage_config));
 
     // Calculate the layout/size of the memory block
     internal_layout = std::make_unique<storage::DataLayout>();
@@ -1,4 +1,6 @@
 #include "engine/datafacade/shared_memory_allocator.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/log.hpp"
 
 #include "boost/assert.hpp"
@@ -16,17 +18,56 @@ SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region
 
     BOOST_ASSERT(storage::SharedMemory::RegionExists(data_region));
     m_large_memory = storage::makeSharedMemory(data_region);
+
+    const auto base_region = GetHeader(*m_large_memory).base_region;
+    if (base_region != storage::REGION_NONE)
+    {
+        util::Log(logDEBUG) << "Using unchanged blocks of region " << regionToString(base_region);
+
+        if (!storage::SharedMemory::RegionExists(base_region))
+        {
+            throw util::exception("Base region " + regionToString(base_region) + " of " +
+                                  regionToString(data_region) + " does not exist" + SOURCE_REF);
+        }
+        m_base_memory = storage::makeSharedMemory(base_region);
+    }
 }
 
 SharedMemoryAllocator::~SharedMemoryAllocator() {}
 
+storage::SharedRegionHeader &SharedMemoryAllocator::GetHeader(storage::SharedMemory &memory)
+{
+    return *reinterpret_cast<storage::SharedRegionHeader *>(memory.Ptr());
+}
+
+char *SharedMemoryAllocator::GetData(storage::SharedMemory &memory)
+{
+    return reinterpret_cast<char *>(memory.Ptr()) + sizeof(storage::SharedRegionHeader);
+}
+
 storage::DataLayout &SharedMemoryAllocator::GetLayout()
 {
-    return *reinterpret_cast<storage::DataLayout *>(m_large_memory->Ptr());
+    return GetHeader(*m_large_memory).layout;
 }
-char *SharedMemoryAllocator::GetMemory()
+char *SharedMemoryAllocator::GetMemory() { return GetData(*m_large_memory); }
+
+storage::DataLayout &SharedMemoryAllocator::GetBlockLayout(storage::DataLayout::BlockID bid)
 {
-    return reinterpret_cast<char *>(m_large_memory->Ptr()) + sizeof(storage::DataLayout);
+    auto &header = GetHeader(*m_large_memory);
+    if (header.HasBlock(bid))
+        return header.layout;
+
+    BOOST_ASSERT(m_base_memory);
+    return GetHeader(*m_base_memory).layout;
+}
+
+char *SharedMemoryAllocator::GetBlockMemory(storage::DataLayout::BlockID bid)
+{
+    if (GetHeader(*m_large_memory).HasBlock(bid))
+        return GetData(*m_large_memory);
+
+    BOOST_ASSERT(m_base_memory);
+    return GetData(*m_base_memory);
 }
 
 } // namespace datafacade
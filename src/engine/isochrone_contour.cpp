@@ -0,0 +1,340 @@
+#include "engine/isochrone_contour.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+const constexpr double MAX_CELLS = 256;
+// about 50m, smaller cells would split the blocks between the roads into holes
+const constexpr double MIN_CELL_SIZE = 0.00045 * COORDINATE_PRECISION;
+// one cell for growing the covered cells and one to keep the boundary inside of the grid
+const constexpr int BORDER = 2;
+
+// Directions of the cell boundaries, counter-clockwise
+const constexpr int DX[4] = {1, 0, -1, 0};
+const constexpr int DY[4] = {0, 1, 0, -1};
+
+struct GridPoint
+{
+    std::int64_t x;
+    std::int64_t y;
+};
+using GridRing = std::vector<GridPoint>;
+
+class Grid
+{
+  public:
+    Grid(const std::vector<std::vector<util::Coordinate>> &lines)
+    {
+        std::int32_t min_lon = std::numeric_limits<std::int32_t>::max();
+        std::int32_t min_lat = std::numeric_limits<std::int32_t>::max();
+        std::int32_t max_lon = std::numeric_limits<std::int32_t>::min();
+        std::int32_t max_lat = std::numeric_limits<std::int32_t>::min();
+        for (const auto &line : lines)
+        {
+            for (const auto &coordinate : line)
+            {
+                min_lon = std::min(min_lon, static_cast<std::int32_t>(coordinate.lon));
+                min_lat = std::min(min_lat, static_cast<std::int32_t>(coordinate.lat));
+                max_lon = std::max(max_lon, static_cast<std::int32_t>(coordinate.lon));
+                max_lat = std::max(max_lat, static_cast<std::int32_t>(coordinate.lat));
+            }
+        }
+
+        // cells of equal width and height in meters
+        const double center_lat = (static_cast<double>(min_lat) + max_lat) / 2.;
+        const double lat_scale = std::max(
+            0.01,
+            std::cos(center_lat / COORDINATE_PRECISION *
+                     static_cast<double>(util::coordinate_calculation::detail::DEGREE_TO_RAD)));
+        const double lon_extent = static_cast<double>(max_lon) - min_lon;
+        const double lat_extent = static_cast<double>(max_lat) - min_lat;
+        cell_lat = std::max(
+            {lat_extent / MAX_CELLS, lon_extent * lat_scale / MAX_CELLS, MIN_CELL_SIZE});
+        cell_lon = cell_lat / lat_scale;
+
+        origin_lon = min_lon - BORDER * cell_lon;
+        origin_lat = min_lat - BORDER * cell_lat;
+        width = static_cast<int>(std::ceil(lon_extent / cell_lon)) + 1 + 2 * BORDER;
+        height = static_cast<int>(std::ceil(lat_extent / cell_lat)) + 1 + 2 * BORDER;
+
+        std::vector<bool> covered(static_cast<std::size_t>(width) * height, false);
+        for (const auto &line : lines)
+        {
+            if (line.size() == 1)
+                Rasterize(line.front(), line.front(), covered);
+            for (std::size_t index = 1; index < line.size(); ++index)
+            {
+                Rasterize(line[index - 1], line[index], covered);
+            }
+        }
+
+        cells.resize(covered.size(), false);
+        for (int y = BORDER - 1; y < height - BORDER + 1; ++y)
+        {
+            for (int x = BORDER - 1; x < width - BORDER + 1; ++x)
+            {
+                bool is_set = false;
+                for (int dy = -1; dy <= 1 && !is_set; ++dy)
+                {
+                    for (int dx = -1; dx <= 1 && !is_set; ++dx)
+                    {
+                        is_set = covered[Index(x + dx, y + dy)];
+                    }
+                }
+                cells[Index(x, y)] = is_set;
+            }
+        }
+    }
+
+    bool IsSet(const int x, const int y) const
+    {
+        return x >= 0 && y >= 0 && x < width && y < height && cells[Index(x, y)];
+    }
+
+    util::Coordinate ToCoordinate(const GridPoint point) const
+    {
+        const double max_lon = 180. * COORDINATE_PRECISION;
+        const double max_lat = 90. * COORDINATE_PRECISION;
+        const auto lon = std::round(origin_lon + point.x * cell_lon);
+        const auto lat = std::round(origin_lat + point.y * cell_lat);
+        const auto clamped_lon = std::max(-max_lon, std::min(max_lon, lon));
+        const auto clamped_lat = std::max(-max_lat, std::min(max_lat, lat));
+        return util::Coordinate{util::FixedLongitude{static_cast<std::int32_t>(clamped_lon)},
+                                util::FixedLatitude{static_cast<std::int32_t>(clamped_lat)}};
+    }
+
+    int width;
+    int height;
+
+  private:
+    std::size_t Index(const int x, const int y) const
+    {
+        return static_cast<std::size_t>(y) * width + x;
+    }
+
+    // Marks the cells of points at most half a cell apart along the segment
+    void Rasterize(const util::Coordinate from,
+                   const util::Coordinate to,
+                   std::vector<bool> &covered) const
+    {
+        const double from_x = (static_cast<std::int32_t>(from.lon) - origin_lon) / cell_lon;
+        const double from_y = (static_cast<std::int32_t>(from.lat) - origin_lat) / cell_lat;
+        const double to_x = (static_cast<std::int32_t>(to.lon) - origin_lon) / cell_lon;
+        const double to_y = (static_cast<std::int32_t>(to.lat) - origin_lat) / cell_lat;
+
+        const auto steps = static_cast<int>(
+            std::ceil(2 * std::max(std::abs(to_x - from_x), std::abs(to_y - from_y))));
+        for (int step = 0; step <= steps; ++step)
+        {
+            const double factor = steps == 0 ? 0. : static_cast<double>(step) / steps;
+            const auto x = static_cast<int>(from_x + factor * (to_x - from_x));
+            const auto y = static_cast<int>(from_y + factor * (to_y - from_y));
+            BOOST_ASSERT(x >= 0 && x < width && y >= 0 && y < height);
+            covered[Index(x, y)] = true;
+        }
+    }
+
+    double origin_lon;
+    double origin_lat;
+    double cell_lon;
+    double cell_lat;
+    std::vector<bool> cells;
+};
+
+// Follows the boundaries between set and unset cells, with the set cells on the left. Where
+// two set cells only touch at a corner the boundary turns left, so they get separate rings.
+std::vector<GridRing> traceBoundaries(const Grid &grid)
+{
+    const auto vertex_width = grid.width + 1;
+    const auto index = [vertex_width](const int x, const int y) {
+        return static_cast<std::size_t>(y) * vertex_width + x;
+    };
+
+    // bit mask of the directions of the boundaries that start at a cell corner
+    std::vector<std::uint8_t> outgoing(static_cast<std::size_t>(vertex_width) * (grid.height + 1),
+                                       0);
+    for (int y = 0; y < grid.height; ++y)
+    {
+        for (int x = 0; x < grid.width; ++x)
+        {
+            if (!grid.IsSet(x, y))
+                continue;
+            if (!grid.IsSet(x, y - 1))
+                outgoing[index(x, y)] |= 1 << 0;
+            if (!grid.IsSet(x + 1, y))
+                outgoing[index(x + 1, y)] |= 1 << 1;
+            if (!grid.IsSet(x, y + 1))
+                outgoing[index(x + 1, y + 1)] |= 1 << 2;
+            if (!grid.IsSet(x - 1, y))
+                outgoing[index(x, y + 1)] |= 1 << 3;
+        }
+    }
+
+    std::vector<GridRing> rings;
+    for (int start_y = 0; start_y <= grid.height; ++start_y)
+    {
+        for (int start_x = 0; start_x <= grid.width; ++start_x)
+        {
+            while (outgoing[index(start_x, start_y)] != 0)
+            {
+                // corners and the directions of the boundaries that start there
+                std::vector<std::pair<GridPoint, int>> corners;
+                int x = start_x;
+                int y = start_y;
+                int direction = 0;
+                while ((outgoing[index(x, y)] & (1 << direction)) == 0)
+                    ++direction;
+
+                do
+                {
+                    if (corners.empty() || corners.back().second != direction)
+                        corners.emplace_back(GridPoint{x, y}, direction);
+                    outgoing[index(x, y)] &= ~(1 << direction);
+                    x += DX[direction];
+                    y += DY[direction];
+
+                    // every corner has as many incoming as outgoing boundaries, so the ring can
+                    // only end at its start
+                    if (x == start_x && y == start_y)
+                        break;
+                    for (const auto turn : {1, 0, 3, 2})
+                    {
+                        const auto next = (direction + turn) % 4;
+                        if (outgoing[index(x, y)] & (1 << next))
+                        {
+                            direction = next;
+                            break;
+                        }
+                    }
+                } while (true);
+
+                // the start is no corner if the ring arrives there in its first direction
+                if (corners.size() > 1 && corners.back().second == corners.front().second)
+                    corners.erase(corners.begin());
+
+                GridRing ring;
+                ring.reserve(corners.size() + 1);
+                for (const auto &corner : corners)
+                    ring.push_back(corner.first);
+                ring.push_back(ring.front());
+                rings.push_back(std::move(ring));
+            }
+        }
+    }
+    return rings;
+}
+
+// Twice the signed area, positive for counter-clockwise rings
+std::int64_t signedArea(const GridRing &ring)
+{
+    std::int64_t area = 0;
+    for (std::size_t index = 1; index < ring.size(); ++index)
+    {
+        area += ring[index - 1].x * ring[index].y - ring[index].x * ring[index - 1].y;
+    }
+    return area;
+}
+
+// The point is given in half cells and lies in the center of a cell, so it is never on the ring
+bool contains(const GridRing &ring, const GridPoint half_point)
+{
+    bool inside = false;
+    for (std::size_t index = 1; index < ring.size(); ++index)
+    {
+        const GridPoint from{2 * ring[index - 1].x, 2 * ring[index - 1].y};
+        const GridPoint to{2 * ring[index].x, 2 * ring[index].y};
+        if ((from.y > half_point.y) != (to.y > half_point.y))
+        {
+            // the boundaries are either horizontal or vertical
+            BOOST_ASSERT(from.x == to.x);
+            if (from.x > half_point.x)
+                inside = !inside;
+        }
+    }
+    return inside;
+}
+}
+
+std::vector<ContourPolygon> traceContour(const std::vector<std::vector<util::Coordinate>> &lines)
+{
+    const auto has_coordinates = std::any_of(
+        lines.begin(), lines.end(), [](const auto &line) { return !line.empty(); });
+    if (!has_coordinates)
+        return {};
+
+    const Grid grid(lines);
+    auto rings = traceBoundaries(grid);
+
+    std::vector<std::pair<std::int64_t, std::size_t>> outer_rings;
+    std::vector<std::size_t> holes;
+    for (std::size_t index = 0; index < rings.size(); ++index)
+    {
+        const auto area = signedArea(rings[index]);
+        BOOST_ASSERT(area != 0);
+        if (area > 0)
+            outer_rings.emplace_back(area, index);
+        else
+            holes.push_back(index);
+    }
+    std::sort(outer_rings.begin(), outer_rings.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    std::vector<std::vector<std::size_t>> polygon_holes(outer_rings.size());
+    for (const auto hole : holes)
+    {
+        // center of the unset cell on the right of the first boundary
+        const auto &ring = rings[hole];
+        const auto dx = ring[1].x - ring[0].x;
+        const auto dy = ring[1].y - ring[0].y;
+        const auto direction_x = (dx > 0) - (dx < 0);
+        const auto direction_y = (dy > 0) - (dy < 0);
+        const GridPoint half_point{2 * ring[0].x + direction_x + direction_y,
+                                   2 * ring[0].y + direction_y - direction_x};
+
+        // islands within holes are outer rings as well, so the smallest containing ring is used
+        for (auto outer = outer_rings.size(); outer > 0; --outer)
+        {
+            if (contains(rings[outer_rings[outer - 1].second], half_point))
+            {
+                polygon_holes[outer - 1].push_back(hole);
+                break;
+            }
+        }
+    }
+
+    const auto to_coordinates = [&grid](const GridRing &ring) {
+        ContourRing coordinates;
+        coordinates.reserve(ring.size());
+        for (const auto point : ring)
+            coordinates.push_back(grid.ToCoordinate(point));
+        return coordinates;
+    };
+
+    std::vector<ContourPolygon> polygons;
+    polygons.reserve(outer_rings.size());
+    for (std::size_t outer = 0; outer < outer_rings.size(); ++outer)
+    {
+        ContourPolygon polygon;
+        polygon.push_back(to_coordinates(rings[outer_rings[outer].second]));
+        for (const auto hole : polygon_holes[outer])
+            polygon.push_back(to_coordinates(rings[hole]));
+        polygons.push_back(std::move(polygon));
+    }
+    return polygons;
+}
+}
+}
@@ -0,0 +1,73 @@
+#include "engine/plugins/isochrone.hpp"
+#include "engine/api/isochrone_api.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/phantom_node.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include <boost/assert.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+IsochronePlugin::IsochronePlugin(const int max_duration_) : max_duration{max_duration_} {}
+
+Status
+IsochronePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                               const RoutingAlgorithmsInterface &algorithms,
+                               const api::IsochroneParameters &params,
+                               util::json::Object &json_result) const
+{
+    BOOST_ASSERT(params.IsValid());
+
+    if (!algorithms.HasIsochroneSearch())
+    {
+        return Error("NotImplemented",
+                     "Isochrone is not implemented for the chosen search algorithm.",
+                     json_result);
+    }
+
+    if (!CheckAllCoordinates(params.coordinates))
+        return Error("InvalidOptions", "Coordinates are invalid", json_result);
+
+    if (params.coordinates.size() != 1)
+    {
+        return Error("InvalidOptions", "Only one input coordinate is supported", json_result);
+    }
+
+    const auto max_contour = *std::max_element(params.contours.begin(), params.contours.end());
+    if (max_duration > 0 && max_contour > max_duration)
+    {
+        return Error("TooBig",
+                     "Contour " + std::to_string(max_contour) +
+                         " is higher than current maximum (" + std::to_string(max_duration) +
+                         ")",
+                     json_result);
+    }
+
+    const auto phantom_nodes = SnapPhantomNodes(GetPhantomNodes(facade, params));
+    BOOST_ASSERT(phantom_nodes.size() == 1);
+    if (!phantom_nodes.front().IsValid())
+    {
+        return Error("NoSegment", "Could not find a matching segment for coordinate", json_result);
+    }
+
+    // all contours are answered by a single search bounded by the largest one
+    const auto max_search_duration = static_cast<EdgeWeight>(std::round(max_contour * 10.));
+    const auto reachable_nodes =
+        algorithms.IsochroneSearch(phantom_nodes.front(), max_search_duration);
+
+    api::IsochroneAPI isochrone_api(facade, params);
+    isochrone_api.MakeResponse(phantom_nodes.front(), reachable_nodes, json_result);
+
+    return Status::Ok;
+}
+}
+}
+}
@@ -15,6 +15,7 @@
 #include <protozero/varint.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -230,11 +231,19 @@ FixedPoint coordinatesToTilePoint(const util::Coordinate point, const BBox &tile
     return FixedPoint{px, py};
 }
 
-std::vector<RTreeLeaf> getEdges(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
-                                unsigned x,
-                                unsigned y,
-                                unsigned z)
+TileEdgeCache::Edges getEdges(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                              unsigned x,
+                              unsigned y,
+                              unsigned z,
+                              TileEdgeCache &cache)
 {
+    const TileEdgeCache::Dataset dataset{facade.GetCheckSum(), facade.GetTimestamp()};
+    const auto cached = cache.Find(dataset, x, y, z);
+    if (cached.edges && cached.z == z)
+    {
+        return cached.edges;
+    }
+
     double min_lon, min_lat, max_lon, max_lat;
 
     // Convert the z,x,y mercator tile coordinates into WGS84 lon/lat values
@@ -245,9 +254,14 @@ std::vector<RTreeLeaf> getEdges(const datafacade::ContiguousInternalMemoryDataFa
     util::Coordinate southwest{util::FloatLongitude{min_lon}, util::FloatLatitude{min_lat}};
     util::Coordinate northeast{util::FloatLongitude{max_lon}, util::FloatLatitude{max_lat}};
 
-    // Fetch all the segments that are in our bounding box.
-    // This hits the OSRM StaticRTree
-    return facade.GetEdgesInBox(southwest, northeast);
+    // Fetch all the segments that are in our bounding box. The buffered box of a tile contains
+    // the buffered boxes of its children, so they are found among the edges of a cached parent.
+    // Otherwise this hits the OSRM StaticRTree
+    auto edges = std::make_shared<const std::vector<RTreeLeaf>>(
+        cached.edges ? facade.GetEdgesInBox(southwest, northeast, *cached.edges)
+                     : facade.GetEdgesInBox(southwest, northeast));
+    cache.Insert(dataset, x, y, z, edges);
+    return edges;
 }
 
 std::vector<std::size_t> getEdgeIndex(const std::vector<RTreeLeaf> &edges)
@@ -789,7 +803,9 @@ Status TilePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
 {
     BOOST_ASSERT(parameters.IsValid());
 
-    auto edges = getEdges(facade, parameters.x, parameters.y, parameters.z);
+    const auto cached_edges =
+        getEdges(facade, parameters.x, parameters.y, parameters.z, edge_cache);
+    const auto &edges = *cached_edges;
 
     auto edge_index = getEdgeIndex(edges);
 
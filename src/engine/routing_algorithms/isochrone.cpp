@@ -0,0 +1,300 @@
+#include "engine/routing_algorithms/isochrone.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace
+{
+template <typename Heap> void insertSourceNodes(Heap &heap, const PhantomNode &source)
+{
+    if (source.forward_segment_id.enabled)
+    {
+        heap.Insert(source.forward_segment_id.id,
+                    -source.GetForwardDuration(),
+                    source.forward_segment_id.id);
+    }
+    if (source.reverse_segment_id.enabled)
+    {
+        heap.Insert(source.reverse_segment_id.id,
+                    -source.GetReverseDuration(),
+                    source.reverse_segment_id.id);
+    }
+}
+}
+
+namespace ch
+{
+namespace
+{
+// Nodes ordered such that every node comes after all nodes its stored (upward) edges point to.
+// This is a topological order of the DAG of upward edges and replaces the explicit rank order
+// of PHAST, which is not part of the query graph.
+//
+// The downward edges are stored at their lower end, the sweep needs them at their upper end
+// to only visit the nodes the search reaches. They are kept as edge ids, so the durations
+// are always read from the current facade.
+struct SweepOrder
+{
+    unsigned checksum;
+    unsigned number_of_edges;
+    std::vector<NodeID> nodes;
+    // position of every node in nodes
+    std::vector<std::uint32_t> positions;
+    // downward edges grouped by their upper end, the lower end and the edge id
+    std::vector<std::uint32_t> down_offsets;
+    std::vector<std::pair<NodeID, EdgeID>> down_edges;
+};
+
+std::vector<NodeID>
+computeSweepOrder(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
+{
+    const auto number_of_nodes = facade.GetNumberOfNodes();
+    std::vector<NodeID> order;
+    order.reserve(number_of_nodes);
+    std::vector<bool> visited(number_of_nodes, false);
+
+    // iterative post-order DFS, the stack holds the node and the next edge to visit
+    std::vector<std::pair<NodeID, EdgeID>> stack;
+    for (NodeID root = 0; root < number_of_nodes; ++root)
+    {
+        if (visited[root])
+            continue;
+        visited[root] = true;
+        stack.emplace_back(root, facade.BeginEdges(root));
+        while (!stack.empty())
+        {
+            auto &top = stack.back();
+            const auto node = top.first;
+            if (top.second == facade.EndEdges(node))
+            {
+                order.push_back(node);
+                stack.pop_back();
+                continue;
+            }
+            const auto target = facade.GetTarget(top.second++);
+            if (!visited[target])
+            {
+                visited[target] = true;
+                stack.emplace_back(target, facade.BeginEdges(target));
+            }
+        }
+    }
+    BOOST_ASSERT(order.size() == number_of_nodes);
+    return order;
+}
+
+SweepOrder makeSweepOrder(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
+{
+    const auto number_of_nodes = facade.GetNumberOfNodes();
+    SweepOrder sweep;
+    sweep.checksum = facade.GetCheckSum();
+    sweep.number_of_edges = facade.GetNumberOfEdges();
+    sweep.nodes = computeSweepOrder(facade);
+
+    sweep.positions.resize(number_of_nodes);
+    for (std::uint32_t position = 0; position < number_of_nodes; ++position)
+    {
+        sweep.positions[sweep.nodes[position]] = position;
+    }
+
+    sweep.down_offsets.assign(number_of_nodes + 1, 0);
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            if (facade.GetEdgeData(edge).backward)
+                ++sweep.down_offsets[facade.GetTarget(edge) + 1];
+        }
+    }
+    std::partial_sum(
+        sweep.down_offsets.begin(), sweep.down_offsets.end(), sweep.down_offsets.begin());
+
+    sweep.down_edges.resize(sweep.down_offsets.back());
+    auto insert_positions = sweep.down_offsets;
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            if (facade.GetEdgeData(edge).backward)
+            {
+                sweep.down_edges[insert_positions[facade.GetTarget(edge)]++] = {node, edge};
+            }
+        }
+    }
+    return sweep;
+}
+
+std::shared_ptr<const SweepOrder>
+getSweepOrder(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
+{
+    // The order only depends on the graph, so it is shared by all queries on the same dataset
+    static std::mutex mutex;
+    static std::shared_ptr<const SweepOrder> cached;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!cached || cached->checksum != facade.GetCheckSum() ||
+        cached->nodes.size() != facade.GetNumberOfNodes() ||
+        cached->number_of_edges != facade.GetNumberOfEdges())
+    {
+        cached = std::make_shared<const SweepOrder>(makeSweepOrder(facade));
+    }
+    return cached;
+}
+}
+}
+
+// PHAST: the upward search settles all nodes reachable on upward edges, the sweep then relaxes
+// the downward edges in descending contraction order. Like RPHAST the sweep is restricted to
+// the nodes it reaches within max_duration: they are taken from a queue ordered by their
+// position in the sweep order, so each node is final when it is taken. Both phases only use
+// the thread local heaps, no per query storage depends on the size of the graph.
+// Durations of shortcuts are the durations of the minimum weight path, so for weights other
+// than duration the result is an approximation.
+std::vector<IsochroneNode>
+isochroneSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                const PhantomNode &source,
+                const EdgeWeight max_duration)
+{
+    const auto number_of_nodes = facade.GetNumberOfNodes();
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(number_of_nodes);
+    auto &heap = *engine_working_data.forward_heap_1;
+    // keyed by the sweep position, the data holds the best duration found so far
+    auto &sweep_queue = *engine_working_data.many_to_many_heap;
+
+    const auto sweep = ch::getSweepOrder(facade);
+
+    insertSourceNodes(heap, source);
+    while (!heap.Empty())
+    {
+        const auto node = heap.DeleteMin();
+        const auto duration = heap.GetKey(node);
+        sweep_queue.Insert(node, sweep->positions[node], {node, duration});
+
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (!data.forward)
+                continue;
+
+            const auto to = facade.GetTarget(edge);
+            const auto to_duration = duration + data.duration;
+            if (to_duration > max_duration)
+                continue;
+
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_duration, node);
+            }
+            else if (to_duration < heap.GetKey(to))
+            {
+                heap.GetData(to).parent = node;
+                heap.DecreaseKey(to, to_duration);
+            }
+        }
+    }
+
+    std::vector<IsochroneNode> reachable;
+    while (!sweep_queue.Empty())
+    {
+        // all nodes with downward edges to this one come earlier in the sweep order
+        const auto node = sweep_queue.DeleteMin();
+        const auto duration = sweep_queue.GetData(node).duration;
+        reachable.push_back({node, duration});
+
+        for (auto index = sweep->down_offsets[node]; index < sweep->down_offsets[node + 1];
+             ++index)
+        {
+            const auto to = sweep->down_edges[index].first;
+            const auto to_duration =
+                duration + facade.GetEdgeData(sweep->down_edges[index].second).duration;
+            if (to_duration > max_duration)
+                continue;
+
+            if (!sweep_queue.WasInserted(to))
+            {
+                sweep_queue.Insert(to, sweep->positions[to], {node, to_duration});
+            }
+            else
+            {
+                BOOST_ASSERT(!sweep_queue.WasRemoved(to));
+                auto &data = sweep_queue.GetData(to);
+                if (to_duration < data.duration)
+                {
+                    data.parent = node;
+                    data.duration = to_duration;
+                }
+            }
+        }
+    }
+
+    std::sort(reachable.begin(), reachable.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.node < rhs.node;
+    });
+    return reachable;
+}
+
+// Bounded Dijkstra on the edge-based graph. The clique arcs of the overlay levels only store
+// weights, so they can't bound the search by duration and the base graph is used instead.
+std::vector<IsochroneNode>
+isochroneSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+                const PhantomNode &source,
+                const EdgeWeight max_duration)
+{
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &heap = *engine_working_data.forward_heap_1;
+
+    std::vector<IsochroneNode> reachable;
+
+    insertSourceNodes(heap, source);
+    while (!heap.Empty())
+    {
+        const auto node = heap.DeleteMin();
+        const auto duration = heap.GetKey(node);
+        reachable.push_back({node, duration});
+
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (!data.forward)
+                continue;
+
+            const auto to = facade.GetTarget(edge);
+            const EdgeWeight to_duration = duration + data.duration;
+            if (to_duration > max_duration)
+                continue;
+
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_duration, node);
+            }
+            else if (to_duration < heap.GetKey(to))
+            {
+                heap.GetData(to).parent = node;
+                heap.DecreaseKey(to, to_duration);
+            }
+        }
+    }
+
+    return reachable;
+}
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
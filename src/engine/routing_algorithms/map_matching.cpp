@@ -193,11 +193,16 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
             const auto &current_timestamps_list = candidates_list[t];
             const auto &current_coordinate = trace_coordinates[t];
 
-            const auto haversine_distance = util::coordinate_calculation::haversineDistance(
+            // the distance enters the transition probabilities, so it has to be exact
+            const auto trace_point_distance = util::coordinate_calculation::haversineDistance(
                 prev_coordinate, current_coordinate);
-            // assumes minumum of 4 m/s
+            // assumes minumum of 4 m/s, the bound only limits the search so it is approximated
             const EdgeWeight weight_upper_bound =
-                ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier();
+                ((util::coordinate_calculation::approximateDistance(prev_coordinate,
+                                                                    current_coordinate) +
+                  max_distance_delta) /
+                 4.) *
+                facade.GetWeightMultiplier();
 
             // compute d_t for this timestamp and the next one
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
@@ -226,7 +231,7 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                                            weight_upper_bound);
 
                     // get distance diff between loc1/2 and locs/s_prime
-                    const auto d_t = std::abs(network_distance - haversine_distance);
+                    const auto d_t = std::abs(network_distance - trace_point_distance);
 
                     // very low probability transition -> prune
                     if (d_t >= max_distance_delta)
@@ -7,10 +7,18 @@ namespace engine
 namespace routing_algorithms
 {
 
-std::vector<TurnData>
-getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
-             const std::vector<RTreeLeaf> &edges,
-             const std::vector<std::size_t> &sorted_edge_indexes)
+namespace
+{
+// Extracts the turns between the road segments of a tile. The algorithm specific part is
+// `find_turn_edge(from, to)` which returns a pointer to the data of the edge-based-graph edge
+// (non-shortcut) connecting the edge-based-nodes `from` and `to`, or nullptr if none exists.
+//
+// The facade is only read, so tiles can be generated concurrently.
+template <typename FindTurnEdge>
+std::vector<TurnData> getTileTurns(const datafacade::BaseDataFacade &facade,
+                                   const std::vector<RTreeLeaf> &edges,
+                                   const std::vector<std::size_t> &sorted_edge_indexes,
+                                   FindTurnEdge find_turn_edge)
 {
     std::vector<TurnData> all_turn_data;
 
@@ -21,6 +29,10 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
     {
         bool is_geometry_forward; // Is the geometry forward or reverse?
         unsigned packed_geometry_id;
+        // Sum of the segment weights and durations, computed on first use
+        bool has_node_sums;
+        EdgeWeight sum_node_weight;
+        EdgeWeight sum_node_duration;
     };
     // Lookup table for edge-based-nodes
     std::unordered_map<NodeID, EdgeBasedNodeInfo> edge_based_node_info;
@@ -48,7 +60,8 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
             directed_graph[edge.u].push_back({edge.v, edge.forward_segment_id.id});
             if (edge_based_node_info.count(edge.forward_segment_id.id) == 0)
             {
-                edge_based_node_info[edge.forward_segment_id.id] = {true, edge.packed_geometry_id};
+                edge_based_node_info[edge.forward_segment_id.id] = {
+                    true, edge.packed_geometry_id, false, 0, 0};
             }
             else
             {
@@ -63,7 +76,8 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
             directed_graph[edge.v].push_back({edge.u, edge.reverse_segment_id.id});
             if (edge_based_node_info.count(edge.reverse_segment_id.id) == 0)
             {
-                edge_based_node_info[edge.reverse_segment_id.id] = {false, edge.packed_geometry_id};
+                edge_based_node_info[edge.reverse_segment_id.id] = {
+                    false, edge.packed_geometry_id, false, 0, 0};
             }
             else
             {
@@ -81,9 +95,32 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
     //         w
     //  uv is the "approach"
     //  vw is the "exit"
-    std::vector<contractor::QueryEdge::EdgeData> unpacked_shortcut;
-    std::vector<EdgeWeight> approach_weight_vector;
-    std::vector<EdgeWeight> approach_duration_vector;
+    const auto sum_segments = [](const auto &range) {
+        return std::accumulate(range.begin(), range.end(), EdgeWeight{0});
+    };
+
+    // Only computes the segment sums once per edge-based-node, not once per turn
+    const auto get_node_sums = [&](EdgeBasedNodeInfo &info) {
+        if (!info.has_node_sums)
+        {
+            if (info.is_geometry_forward)
+            {
+                info.sum_node_weight =
+                    sum_segments(facade.GetUncompressedForwardWeights(info.packed_geometry_id));
+                info.sum_node_duration =
+                    sum_segments(facade.GetUncompressedForwardDurations(info.packed_geometry_id));
+            }
+            else
+            {
+                info.sum_node_weight =
+                    sum_segments(facade.GetUncompressedReverseWeights(info.packed_geometry_id));
+                info.sum_node_duration =
+                    sum_segments(facade.GetUncompressedReverseDurations(info.packed_geometry_id));
+            }
+            info.has_node_sums = true;
+        }
+        return std::make_pair(info.sum_node_weight, info.sum_node_duration);
+    };
 
     // Make sure we traverse the startnodes in a consistent order
     // to ensure identical PBF encoding on all platforms.
@@ -117,73 +154,19 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
                 if (startnode == exit_edge.target_node)
                     continue;
 
-                // Find the connection between our source road and the target node
-                // Since we only want to find direct edges, we cannot check shortcut edges here.
-                // Otherwise we might find a forward edge even though a shorter backward edge
-                // exists (due to oneways).
-                //
-                // a > - > - > - b
-                // |             |
-                // |------ c ----|
-                //
-                // would offer a backward edge at `b` to `a` (due to the oneway from a to b)
-                // but could also offer a shortcut (b-c-a) from `b` to `a` which is longer.
-                EdgeID smaller_edge_id =
-                    facade.FindSmallestEdge(approachedge.edge_based_node_id,
-                                            exit_edge.edge_based_node_id,
-                                            [](const contractor::QueryEdge::EdgeData &data) {
-                                                return data.forward && !data.shortcut;
-                                            });
-
-                // Depending on how the graph is constructed, we might have to look for
-                // a backwards edge instead.  They're equivalent, just one is available for
-                // a forward routing search, and one is used for the backwards dijkstra
-                // steps.  Their weight should be the same, we can use either one.
-                // If we didn't find a forward edge, try for a backward one
-                if (SPECIAL_EDGEID == smaller_edge_id)
-                {
-                    smaller_edge_id =
-                        facade.FindSmallestEdge(exit_edge.edge_based_node_id,
-                                                approachedge.edge_based_node_id,
-                                                [](const contractor::QueryEdge::EdgeData &data) {
-                                                    return data.backward && !data.shortcut;
-                                                });
-                }
-
                 // If no edge was found, it means that there's no connection between these
-                // nodes, due to oneways or turn restrictions. Given the edge-based-nodes
-                // that we're examining here, we *should* only find directly-connected
-                // edges, not shortcuts
-                if (smaller_edge_id != SPECIAL_EDGEID)
+                // nodes, due to oneways or turn restrictions.
+                const auto data_ptr =
+                    find_turn_edge(approachedge.edge_based_node_id, exit_edge.edge_based_node_id);
+                if (data_ptr != nullptr)
                 {
-                    const auto &data = facade.GetEdgeData(smaller_edge_id);
-                    BOOST_ASSERT_MSG(!data.shortcut, "Connecting edge must not be a shortcut");
+                    const auto &data = *data_ptr;
 
                     // Now, calculate the sum of the weight of all the segments.
-                    if (edge_based_node_info[approachedge.edge_based_node_id].is_geometry_forward)
-                    {
-                        approach_weight_vector = facade.GetUncompressedForwardWeights(
-                            edge_based_node_info[approachedge.edge_based_node_id]
-                                .packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedForwardDurations(
-                            edge_based_node_info[approachedge.edge_based_node_id]
-                                .packed_geometry_id);
-                    }
-                    else
-                    {
-                        approach_weight_vector = facade.GetUncompressedReverseWeights(
-                            edge_based_node_info[approachedge.edge_based_node_id]
-                                .packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedReverseDurations(
-                            edge_based_node_info[approachedge.edge_based_node_id]
-                                .packed_geometry_id);
-                    }
-                    const auto sum_node_weight = std::accumulate(approach_weight_vector.begin(),
-                                                                 approach_weight_vector.end(),
-                                                                 EdgeWeight{0});
-                    const auto sum_node_duration = std::accumulate(approach_duration_vector.begin(),
-                                                                   approach_duration_vector.end(),
-                                                                   EdgeWeight{0});
+                    const auto node_sums =
+                        get_node_sums(edge_based_node_info[approachedge.edge_based_node_id]);
+                    const auto sum_node_weight = node_sums.first;
+                    const auto sum_node_duration = node_sums.second;
 
                     // The edge.weight is the whole edge weight, which includes the turn
                     // cost.
@@ -234,6 +217,86 @@ getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm>
 
     return all_turn_data;
 }
+}
+
+std::vector<TurnData>
+getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+             const std::vector<RTreeLeaf> &edges,
+             const std::vector<std::size_t> &sorted_edge_indexes)
+{
+    const auto find_turn_edge = [&facade](const NodeID from, const NodeID to) {
+        // Since we only want to find direct edges, we cannot check shortcut edges here.
+        // Otherwise we might find a forward edge even though a shorter backward edge
+        // exists (due to oneways).
+        //
+        // a > - > - > - b
+        // |             |
+        // |------ c ----|
+        //
+        // would offer a backward edge at `b` to `a` (due to the oneway from a to b)
+        // but could also offer a shortcut (b-c-a) from `b` to `a` which is longer.
+        EdgeID smaller_edge_id =
+            facade.FindSmallestEdge(from, to, [](const contractor::QueryEdge::EdgeData &data) {
+                return data.forward && !data.shortcut;
+            });
+
+        // Depending on how the graph is constructed, we might have to look for
+        // a backwards edge instead.  They're equivalent, just one is available for
+        // a forward routing search, and one is used for the backwards dijkstra
+        // steps.  Their weight should be the same, we can use either one.
+        // If we didn't find a forward edge, try for a backward one
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            smaller_edge_id =
+                facade.FindSmallestEdge(to, from, [](const contractor::QueryEdge::EdgeData &data) {
+                    return data.backward && !data.shortcut;
+                });
+        }
+
+        if (SPECIAL_EDGEID == smaller_edge_id)
+            return static_cast<const contractor::QueryEdge::EdgeData *>(nullptr);
+
+        const auto &data = facade.GetEdgeData(smaller_edge_id);
+        BOOST_ASSERT_MSG(!data.shortcut, "Connecting edge must not be a shortcut");
+        return &data;
+    };
+
+    return getTileTurns(facade, edges, sorted_edge_indexes, find_turn_edge);
+}
+
+std::vector<TurnData>
+getTileTurns(const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+             const std::vector<RTreeLeaf> &edges,
+             const std::vector<std::size_t> &sorted_edge_indexes)
+{
+    using EdgeData = datafacade::AlgorithmDataFacade<mld::Algorithm>::EdgeData;
+
+    // The MLD graph is the plain edge-based graph, so every edge is a turn. The forward edge
+    // is stored at `from`, the equivalent backward edge at `to`.
+    const auto find_smallest_edge = [&facade](const NodeID from, const NodeID to, auto filter) {
+        const EdgeData *smallest = nullptr;
+        for (const auto edge : facade.GetAdjacentEdgeRange(from))
+        {
+            if (facade.GetTarget(edge) != to)
+                continue;
+
+            const auto &data = facade.GetEdgeData(edge);
+            if (filter(data) && (smallest == nullptr || data.weight < smallest->weight))
+                smallest = &data;
+        }
+        return smallest;
+    };
+
+    const auto find_turn_edge = [&find_smallest_edge](const NodeID from, const NodeID to) {
+        const auto forward =
+            find_smallest_edge(from, to, [](const EdgeData &data) { return data.forward; });
+        if (forward != nullptr)
+            return forward;
+        return find_smallest_edge(to, from, [](const EdgeData &data) { return data.backward; });
+    };
+
+    return getTileTurns(facade, edges, sorted_edge_indexes, find_turn_edge);
+}
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -19,7 +19,9 @@
 #include "util/log.hpp"
 #include "util/name_table.hpp"
 #include "util/range_table.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/timing_util.hpp"
+#include "util/web_mercator.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/restriction_map.hpp"
@@ -41,6 +43,7 @@
 #include <tbb/concurrent_vector.h>
 #include <tbb/task_scheduler_init.h>
 
+#include <cmath>
 #include <cstdlib>
 
 #include <algorithm>
@@ -570,13 +573,38 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNode> node_based_edge_list,
     node_based_edge_list.resize(new_size);
 
     TIMER_START(construction);
-    util::StaticRTree<EdgeBasedNode> rtree(node_based_edge_list,
-                                           config.rtree_nodes_output_path,
-                                           config.rtree_leafs_output_path,
-                                           coordinates);
+    // the parameters need to match BaseDataFacade::SharedRTree
+    util::StaticRTree<EdgeBasedNode,
+                      storage::Ownership::Container,
+                      128,
+                      4096,
+                      util::LeafLayout::ObjectsAndCoordinates>
+        rtree(node_based_edge_list,
+              config.rtree_nodes_output_path,
+              config.rtree_leafs_output_path,
+              coordinates);
 
     TIMER_STOP(construction);
     util::Log() << "finished r-tree construction in " << TIMER_SEC(construction) << " seconds";
+
+    // An empty grid is written if it is disabled, so no grid of an older run is loaded
+    TIMER_START(grid);
+    // projected degrees are converted to meters at the equator
+    const auto cell_size = static_cast<std::int32_t>(
+        std::round(config.snapping_grid_cell_size / util::web_mercator::DEGREE_TO_PX *
+                   COORDINATE_PRECISION));
+    util::SnappingGrid grid(rtree.GetLeafRectangles(), cell_size);
+    files::writeSnappingGrid(config.snapping_grid_output_path, grid);
+    TIMER_STOP(grid);
+
+    if (!grid.Empty())
+    {
+        const auto grid_size =
+            grid.GetNumberOfCells() * (sizeof(std::uint64_t) + sizeof(std::uint32_t)) +
+            grid.GetNumberOfEntries() * sizeof(std::uint32_t);
+        util::Log() << "finished snapping grid of " << grid.GetNumberOfCells() << " cells ("
+                    << (grid_size >> 20) << " MiB) in " << TIMER_SEC(grid) << " seconds";
+    }
 }
 
 void Extractor::WriteEdgeBasedGraph(
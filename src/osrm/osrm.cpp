@@ -1,5 +1,6 @@
 #include "osrm/osrm.hpp"
 #include "engine/algorithm.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -93,4 +94,15 @@ engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string
     return engine_->Tile(params, result);
 }
 
+engine::Status OSRM::Isochrone(const engine::api::IsochroneParameters &params,
+                               json::Object &result) const
+{
+    return engine_->Isochrone(params, result);
+}
+
+engine::Status OSRM::MemoryUsage(json::Object &result) const
+{
+    return engine_->MemoryUsage(result);
+}
+
 } // ns osrm
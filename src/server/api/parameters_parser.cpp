@@ -1,5 +1,6 @@
 #include "server/api/parameters_parser.hpp"
 
+#include "server/api/isochrone_parameter_grammar.hpp"
 #include "server/api/match_parameter_grammar.hpp"
 #include "server/api/nearest_parameter_grammar.hpp"
 #include "server/api/route_parameters_grammar.hpp"
@@ -26,7 +27,8 @@ using is_grammar_t =
                                std::is_same<NearestParametersGrammar<>, T>::value ||
                                std::is_same<TripParametersGrammar<>, T>::value ||
                                std::is_same<MatchParametersGrammar<>, T>::value ||
-                               std::is_same<TileParametersGrammar<>, T>::value>;
+                               std::is_same<TileParametersGrammar<>, T>::value ||
+                               std::is_same<IsochroneParametersGrammar<>, T>::value>;
 
 template <typename ParameterT,
           typename GrammarT,
@@ -104,6 +106,14 @@ boost::optional<engine::api::MatchParameters> parseParameters(std::string::itera
                                                                                            end);
 }
 
+template <>
+boost::optional<engine::api::IsochroneParameters> parseParameters(std::string::iterator &iter,
+                                                                  const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::IsochroneParameters,
+                                   IsochroneParametersGrammar<>>(iter, end);
+}
+
 template <>
 boost::optional<engine::api::TileParameters> parseParameters(std::string::iterator &iter,
                                                              const std::string::iterator end)
@@ -0,0 +1,30 @@
+#include "server/service/admin_service.hpp"
+
+#include "util/json_container.hpp"
+
+namespace osrm
+{
+namespace server
+{
+namespace service
+{
+
+engine::Status
+AdminService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+{
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+
+    if (query == "memory" || query == "memory.json")
+    {
+        return BaseService::routing_machine.MemoryUsage(json_result);
+    }
+
+    json_result.values["code"] = "InvalidQuery";
+    json_result.values["message"] =
+        "Unknown admin query close to position " + std::to_string(prefix_length);
+    return engine::Status::Error;
+}
+}
+}
+}
@@ -0,0 +1,185 @@
+#include "storage/residency.hpp"
+
+#include "util/log.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+namespace
+{
+std::uint64_t getPageSize()
+{
+#ifdef __linux__
+    return static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+// Page aligned memory range that contains [begin, begin + size)
+std::pair<char *, std::uint64_t> getPageRange(const char *begin, const std::uint64_t size)
+{
+    const auto page_size = getPageSize();
+    const auto address = reinterpret_cast<std::uintptr_t>(begin);
+    const auto first_page = address / page_size * page_size;
+    const auto last_page = (address + size + page_size - 1) / page_size * page_size;
+    return {reinterpret_cast<char *>(first_page), last_page - first_page};
+}
+}
+
+std::vector<DataLayout::BlockID> getHotBlocks()
+{
+    return {DataLayout::CH_GRAPH_NODE_LIST,
+            DataLayout::CH_GRAPH_EDGE_LIST,
+            DataLayout::CH_CORE_MARKER,
+            DataLayout::R_SEARCH_TREE,
+            DataLayout::R_SEARCH_TREE_LEAVES,
+            DataLayout::SNAPPING_GRID_CELLS,
+            DataLayout::SNAPPING_GRID_CELL_OFFSETS,
+            DataLayout::SNAPPING_GRID_LEAF_IDS,
+            DataLayout::COORDINATE_LIST,
+            DataLayout::GEOMETRIES_INDEX,
+            DataLayout::GEOMETRIES_NODE_LIST,
+            DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+            DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+            DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+            DataLayout::GEOMETRIES_REV_DURATION_LIST,
+            DataLayout::TURN_WEIGHT_PENALTIES,
+            DataLayout::TURN_DURATION_PENALTIES,
+            DataLayout::MLD_LEVEL_DATA,
+            DataLayout::MLD_PARTITION,
+            DataLayout::MLD_CELL_TO_CHILDREN,
+            DataLayout::MLD_CELL_WEIGHTS,
+            DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+            DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+            DataLayout::MLD_CELLS,
+            DataLayout::MLD_CELL_LEVEL_OFFSETS,
+            DataLayout::MLD_GRAPH_NODE_LIST,
+            DataLayout::MLD_GRAPH_EDGE_LIST,
+            DataLayout::MLD_GRAPH_NODE_TO_OFFSET,
+            DataLayout::MLD_OVERLAY_LEVEL_OFFSETS,
+            DataLayout::MLD_OVERLAY_CELL_OFFSETS,
+            DataLayout::MLD_OVERLAY_FWD_NODES,
+            DataLayout::MLD_OVERLAY_FWD_ARCS,
+            DataLayout::MLD_OVERLAY_BWD_NODES,
+            DataLayout::MLD_OVERLAY_BWD_ARCS};
+}
+
+std::vector<BlockMemory> getBlockMemory(const DataLayout &layout,
+                                        const char *memory,
+                                        const std::vector<DataLayout::BlockID> &blocks)
+{
+    std::vector<BlockMemory> result;
+    result.reserve(blocks.size());
+    for (const auto bid : blocks)
+    {
+        // only computes the position, the canaries are not touched
+        const auto begin = static_cast<const char *>(
+            layout.GetAlignedBlockPtr(const_cast<char *>(memory), bid));
+        result.push_back({bid, begin, layout.GetBlockSize(bid)});
+    }
+    return result;
+}
+
+bool prewarmBlocks(const std::vector<BlockMemory> &blocks, const bool lock)
+{
+    const auto page_size = getPageSize();
+    std::atomic<bool> locked{true};
+
+    tbb::parallel_for(std::size_t{0}, blocks.size(), [&](const std::size_t index) {
+        const auto &block = blocks[index];
+        if (block.size == 0)
+            return;
+
+        const auto range = getPageRange(block.begin, block.size);
+        const auto num_pages = range.second / page_size;
+        tbb::parallel_for(
+            tbb::blocked_range<std::uint64_t>(0, num_pages),
+            [&](const tbb::blocked_range<std::uint64_t> &pages) {
+                // The checksum keeps the compiler from dropping the reads
+                std::uint64_t checksum = 0;
+                for (auto page = pages.begin(); page != pages.end(); ++page)
+                {
+                    checksum += *static_cast<volatile const char *>(range.first +
+                                                                    page * page_size);
+                }
+                static_cast<void>(checksum);
+            });
+
+#ifdef __linux__
+        if (lock && ::mlock(range.first, range.second) != 0)
+        {
+            locked = false;
+        }
+#else
+        if (lock)
+        {
+            locked = false;
+        }
+#endif
+    });
+
+    return locked;
+}
+
+std::uint64_t getResidentSize(const char *begin, const std::uint64_t size)
+{
+    if (size == 0)
+        return 0;
+
+#ifdef __linux__
+    const auto page_size = getPageSize();
+    const auto range = getPageRange(begin, size);
+    std::vector<unsigned char> pages(range.second / page_size);
+    if (::mincore(range.first, range.second, pages.data()) != 0)
+    {
+        return 0;
+    }
+
+    const auto resident_pages =
+        std::count_if(pages.begin(), pages.end(), [](const unsigned char page) {
+            return (page & 1) != 0;
+        });
+    return std::min<std::uint64_t>(resident_pages * page_size, size);
+#else
+    // residency can't be queried, assume the data is in RAM
+    static_cast<void>(begin);
+    return size;
+#endif
+}
+
+void logResidency(const std::vector<BlockMemory> &blocks)
+{
+    std::uint64_t total_resident = 0;
+    std::uint64_t total_size = 0;
+    for (const auto &block : blocks)
+    {
+        if (block.size == 0)
+            continue;
+
+        const auto resident = getResidentSize(block.begin, block.size);
+        util::Log() << "  " << block_id_to_name[block.id] << ": " << (resident >> 20) << " of "
+                    << (block.size >> 20) << " MiB resident";
+        total_resident += resident;
+        total_size += block.size;
+    }
+    util::Log() << "Resident: " << (total_resident >> 20) << " of " << (total_size >> 20)
+                << " MiB";
+}
+}
+}
@@ -1,6 +1,8 @@
 #include "storage/storage.hpp"
 
+#include "storage/container.hpp"
 #include "storage/io.hpp"
+#include "storage/residency.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_memory_ownership.hpp"
@@ -10,6 +12,8 @@
 #include "contractor/query_graph.hpp"
 
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
+#include "customizer/overlay_graph.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_edge.hpp"
@@ -35,8 +39,10 @@
 #include "util/log.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 
@@ -44,35 +50,46 @@
 #include <sys/mman.h>
 #endif
 
+#include <boost/algorithm/string/join.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <cstdint>
 
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
 namespace storage
 {
 
-using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
-using RTreeNode = util::StaticRTree<RTreeLeaf, storage::Ownership::View>::TreeNode;
+using RTree = engine::datafacade::BaseDataFacade::SharedRTree;
+using RTreeNode = RTree::TreeNode;
+using RTreeLeafNode = RTree::LeafNode;
 using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
 using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+Storage::Storage(StorageConfig config_, SharedMemoryOptions memory_options_)
+    : config(std::move(config_)), memory_options(std::move(memory_options_))
+{
+}
 
-int Storage::Run(int max_wait)
+int Storage::Run(int max_wait, const std::vector<DataLayout::BlockID> &update_blocks)
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
@@ -110,8 +127,83 @@ int Storage::Run(int max_wait)
     Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
     auto in_use_region = monitor.data().region;
     auto next_timestamp = monitor.data().timestamp + 1;
-    auto next_region =
-        in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
+
+    // A region written by an incremental update references the blocks of its base region
+    auto in_use_base_region = REGION_NONE;
+    BlockSet in_use_blocks;
+    if (in_use_region != REGION_NONE && storage::SharedMemory::RegionExists(in_use_region))
+    {
+        auto in_use_memory = makeSharedMemory(in_use_region);
+        const auto &in_use_header = *static_cast<SharedRegionHeader *>(in_use_memory->Ptr());
+        in_use_base_region = in_use_header.base_region;
+        in_use_blocks = in_use_header.blocks;
+    }
+
+    // Populate a memory layout into stack memory
+    SharedRegionHeader header;
+    PopulateLayout(header.layout);
+
+    if (!update_blocks.empty())
+    {
+        if (in_use_region == REGION_NONE || !storage::SharedMemory::RegionExists(in_use_region))
+        {
+            util::Log(logWARNING) << "No dataset loaded that could be updated, loading all data.";
+        }
+        else
+        {
+            // Blocks updated before still have to come from the new region
+            BlockSet requested = in_use_base_region != REGION_NONE ? in_use_blocks : BlockSet{};
+            for (const auto bid : update_blocks)
+                requested.set(bid);
+
+            header.base_region =
+                in_use_base_region != REGION_NONE ? in_use_base_region : in_use_region;
+            header.blocks = GetLoadedBlocks(requested);
+        }
+    }
+
+    if (header.IsIncremental())
+    {
+        auto base_memory = makeSharedMemory(header.base_region);
+        const auto &base_layout = static_cast<SharedRegionHeader *>(base_memory->Ptr())->layout;
+        for (auto index = 0; index < DataLayout::NUM_BLOCKS; ++index)
+        {
+            const auto bid = static_cast<DataLayout::BlockID>(index);
+            if (header.blocks.test(bid))
+                continue;
+
+            // Blocks of the base region are only valid for data of the same extraction
+            if (header.layout.num_entries[bid] != base_layout.num_entries[bid])
+            {
+                throw util::exception("Block " + std::string(block_id_to_name[bid]) +
+                                      " of the loaded dataset does not match the data files, "
+                                      "an update of all blocks is needed." +
+                                      SOURCE_REF);
+            }
+            header.layout.num_entries[bid] = 0;
+        }
+
+        std::vector<std::string> names;
+        for (auto index = 0; index < DataLayout::NUM_BLOCKS; ++index)
+        {
+            if (header.blocks.test(index))
+                names.push_back(block_id_to_name[index]);
+        }
+        util::Log() << "Updating " << boost::algorithm::join(names, ", ")
+                    << ", all other data is shared with " << regionToString(header.base_region);
+    }
+
+    // Three regions are needed: the new one, the one in use and the base of the one in use
+    SharedDataType next_region = REGION_NONE;
+    for (const auto region : {REGION_1, REGION_2, REGION_3})
+    {
+        if (region != in_use_region && region != in_use_base_region)
+        {
+            next_region = region;
+            break;
+        }
+    }
+    BOOST_ASSERT(next_region != REGION_NONE);
 
     // ensure that the shared memory region we want to write to is really removed
     // this is only needef for failure recovery because we actually wait for all clients
@@ -127,19 +219,44 @@ int Storage::Run(int max_wait)
 
     util::Log() << "Loading data into " << regionToString(next_region);
 
-    // Populate a memory layout into stack memory
-    DataLayout layout;
-    PopulateLayout(layout);
-
     // Allocate shared memory block
-    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
+    auto regions_size = sizeof(header) + header.layout.GetSizeOfLayout();
     util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto data_memory = makeSharedMemory(next_region, regions_size);
+    auto data_memory = makeSharedMemory(next_region, regions_size, memory_options);
 
-    // Copy memory layout to shared memory and populate data
+    // Copy region header to shared memory and populate data
     char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
-    memcpy(shared_memory_ptr, &layout, sizeof(layout));
-    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+    memcpy(shared_memory_ptr, &header, sizeof(header));
+    PopulateData(header.layout,
+                 shared_memory_ptr + sizeof(header),
+                 header.IsIncremental() ? header.blocks : BlockSet{}.set());
+
+    if (memory_options.prewarm)
+    {
+        const auto hot_blocks = getHotBlocks();
+        auto blocks = getBlockMemory(header.layout, shared_memory_ptr + sizeof(header), hot_blocks);
+
+        // Blocks that are not part of an incremental update are read from the base region
+        std::unique_ptr<storage::SharedMemory> base_memory;
+        if (header.IsIncremental())
+        {
+            base_memory = makeSharedMemory(header.base_region);
+            auto base_ptr = static_cast<char *>(base_memory->Ptr());
+            const auto &base_layout = reinterpret_cast<SharedRegionHeader *>(base_ptr)->layout;
+            const auto base_blocks =
+                getBlockMemory(base_layout, base_ptr + sizeof(SharedRegionHeader), hot_blocks);
+            for (std::size_t index = 0; index < blocks.size(); ++index)
+            {
+                if (!header.blocks.test(blocks[index].id))
+                    blocks[index] = base_blocks[index];
+            }
+        }
+
+        util::Log() << "Prewarming " << regionToString(next_region);
+        // the pages are already locked by mlockall if possible
+        prewarmBlocks(blocks, false);
+        logResidency(blocks);
+    }
 
     { // Lock for write access shared region mutex
         boost::interprocess::scoped_lock<Monitor::mutex_type> lock(monitor.get_mutex(),
@@ -156,6 +273,7 @@ int Storage::Run(int max_wait)
                        "attached processes will not receive notifications and must be restarted";
                 Monitor::remove();
                 in_use_region = REGION_NONE;
+                in_use_base_region = REGION_NONE;
                 monitor = Monitor(SharedDataTimestamp{REGION_NONE, 0});
             }
         }
@@ -174,25 +292,44 @@ int Storage::Run(int max_wait)
     monitor.notify_all();
 
     // SHMCTL(2): Mark the segment to be destroyed. The segment will actually be destroyed
-    // only after the last process detaches it.
-    if (in_use_region != REGION_NONE && storage::SharedMemory::RegionExists(in_use_region))
+    // only after the last process detaches it. The base of the new region is kept.
+    bool all_clients_switched = true;
+    for (const auto old_region : {in_use_region, in_use_base_region})
     {
+        if (old_region == REGION_NONE || old_region == header.base_region ||
+            !storage::SharedMemory::RegionExists(old_region))
+            continue;
+
         util::UnbufferedLog() << "Marking old shared memory region "
-                              << regionToString(in_use_region) << " for removal... ";
+                              << regionToString(old_region) << " for removal... ";
 
         // aquire a handle for the old shared memory region before we mark it for deletion
         // we will need this to wait for all users to detach
-        auto in_use_shared_memory = makeSharedMemory(in_use_region);
+        auto old_shared_memory = makeSharedMemory(old_region);
 
-        storage::SharedMemory::Remove(in_use_region);
+        storage::SharedMemory::Remove(old_region);
         util::UnbufferedLog() << "ok.";
 
+        // Clients release the old region once their last request using it finished, the
+        // segment is freed then even if we stop waiting for slow clients.
         util::UnbufferedLog() << "Waiting for clients to detach... ";
-        in_use_shared_memory->WaitForDetach();
-        util::UnbufferedLog() << " ok.";
+        if (old_shared_memory->WaitForDetach(max_wait))
+        {
+            util::UnbufferedLog() << " ok.";
+        }
+        else
+        {
+            util::Log(logWARNING) << "Clients are still attached to "
+                                  << regionToString(old_region) << " after " << max_wait
+                                  << " seconds, the region is freed once they detach.";
+            all_clients_switched = false;
+        }
     }
 
-    util::Log() << "All clients switched.";
+    if (all_clients_switched)
+    {
+        util::Log() << "All clients switched.";
+    }
 
     return EXIT_SUCCESS;
 }
@@ -272,11 +409,60 @@ void Storage::PopulateLayout(DataLayout &layout)
     }
 
     // load rsearch tree size
+    std::uint64_t number_of_rtree_leaves = 0;
     {
         io::FileReader tree_node_file(config.ram_index_path, io::FileReader::VerifyFingerprint);
 
+        const auto header = RTree::ReadFileHeader(tree_node_file, config.ram_index_path);
+        number_of_rtree_leaves = header.number_of_leaves;
         const auto tree_size = tree_node_file.ReadElementCount64();
         layout.SetBlockSize<RTreeNode>(DataLayout::R_SEARCH_TREE, tree_size);
+
+        // without the leaves in memory the leaf file is mapped by the datafacade
+        if (config.load_rtree_leaves)
+        {
+            io::FileReader leaf_node_file(config.file_index_path,
+                                          io::FileReader::HasNoFingerprint);
+            RTree::CheckLeafFileSize(header, leaf_node_file.GetSize(), config.file_index_path);
+            layout.SetBlockSize<RTreeLeafNode>(DataLayout::R_SEARCH_TREE_LEAVES,
+                                               header.number_of_leaves);
+        }
+        else
+        {
+            layout.SetBlockSize<RTreeLeafNode>(DataLayout::R_SEARCH_TREE_LEAVES, 0);
+        }
+    }
+
+    // the snapping grid is optional, datasets of older versions don't have one
+    if (boost::filesystem::exists(config.snapping_grid_path))
+    {
+        io::FileReader reader(config.snapping_grid_path, io::FileReader::VerifyFingerprint);
+
+        reader.Skip<std::int32_t>(1); // cell size
+        // the leaf ids of a grid of another extraction would point into the wrong leaves
+        const auto number_of_grid_leaves = reader.ReadOne<std::uint64_t>();
+        if (number_of_grid_leaves != number_of_rtree_leaves)
+        {
+            throw util::exception(config.snapping_grid_path.string() + " was built for " +
+                                  std::to_string(number_of_grid_leaves) + " rtree leaves, but " +
+                                  config.ram_index_path.string() + " has " +
+                                  std::to_string(number_of_rtree_leaves) +
+                                  ". Please re-run osrm-extract." + SOURCE_REF);
+        }
+        layout.SetBlockSize<std::int32_t>(DataLayout::SNAPPING_GRID_CELL_SIZE, 1);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::SNAPPING_GRID_CELLS,
+                                           reader.ReadVectorSize<std::uint64_t>());
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SNAPPING_GRID_CELL_OFFSETS,
+                                           reader.ReadVectorSize<std::uint32_t>());
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SNAPPING_GRID_LEAF_IDS,
+                                           reader.ReadVectorSize<std::uint32_t>());
+    }
+    else
+    {
+        layout.SetBlockSize<std::int32_t>(DataLayout::SNAPPING_GRID_CELL_SIZE, 0);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::SNAPPING_GRID_CELLS, 0);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SNAPPING_GRID_CELL_OFFSETS, 0);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::SNAPPING_GRID_LEAF_IDS, 0);
     }
 
     {
@@ -340,14 +526,21 @@ void Storage::PopulateLayout(DataLayout &layout)
         const auto number_of_compressed_geometries = reader.ReadVectorSize<NodeID>();
         layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_NODE_LIST,
                                     number_of_compressed_geometries);
-        layout.SetBlockSize<SegmentWeight>(DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
-                                           number_of_compressed_geometries);
-        layout.SetBlockSize<SegmentWeight>(DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
-                                           number_of_compressed_geometries);
-        layout.SetBlockSize<SegmentDuration>(DataLayout::GEOMETRIES_FWD_DURATION_LIST,
-                                             number_of_compressed_geometries);
-        layout.SetBlockSize<SegmentDuration>(DataLayout::GEOMETRIES_REV_DURATION_LIST,
-                                             number_of_compressed_geometries);
+        // weights and durations are stored bit packed
+        const auto number_of_weight_blocks =
+            extractor::SegmentDataView::SegmentWeightVector::elements_to_blocks(
+                number_of_compressed_geometries);
+        const auto number_of_duration_blocks =
+            extractor::SegmentDataView::SegmentDurationVector::elements_to_blocks(
+                number_of_compressed_geometries);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+                                           number_of_weight_blocks);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+                                           number_of_weight_blocks);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+                                           number_of_duration_blocks);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::GEOMETRIES_REV_DURATION_LIST,
+                                           number_of_duration_blocks);
         layout.SetBlockSize<DatasourceID>(DataLayout::DATASOURCES_LIST,
                                           number_of_compressed_geometries);
     }
@@ -406,14 +599,15 @@ void Storage::PopulateLayout(DataLayout &layout)
         // Loading MLD Data
         if (boost::filesystem::exists(config.mld_partition_path))
         {
-            io::FileReader reader(config.mld_partition_path, io::FileReader::VerifyFingerprint);
+            container::FileReader reader(config.mld_partition_path);
 
-            reader.Skip<partition::MultiLevelPartition::LevelData>(1);
             layout.SetBlockSize<partition::MultiLevelPartition::LevelData>(
                 DataLayout::MLD_LEVEL_DATA, 1);
-            const auto partition_entries_count = reader.ReadVectorSize<PartitionID>();
+            const auto partition_entries_count =
+                reader.GetElementCount("/mld/multilevelpartition/partition");
             layout.SetBlockSize<PartitionID>(DataLayout::MLD_PARTITION, partition_entries_count);
-            const auto children_entries_count = reader.ReadVectorSize<CellID>();
+            const auto children_entries_count =
+                reader.GetElementCount("/mld/multilevelpartition/cell_to_children");
             layout.SetBlockSize<CellID>(DataLayout::MLD_CELL_TO_CHILDREN, children_entries_count);
         }
         else
@@ -426,19 +620,22 @@ void Storage::PopulateLayout(DataLayout &layout)
 
         if (boost::filesystem::exists(config.mld_storage_path))
         {
-            io::FileReader reader(config.mld_storage_path, io::FileReader::VerifyFingerprint);
+            container::FileReader reader(config.mld_storage_path);
 
-            const auto weights_count = reader.ReadVectorSize<EdgeWeight>();
+            const auto weights_count = reader.GetElementCount("/mld/cellstorage/weights");
             layout.SetBlockSize<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS, weights_count);
-            const auto source_node_count = reader.ReadVectorSize<NodeID>();
+            const auto source_node_count =
+                reader.GetElementCount("/mld/cellstorage/source_boundary");
             layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_SOURCE_BOUNDARY, source_node_count);
-            const auto destination_node_count = reader.ReadVectorSize<NodeID>();
+            const auto destination_node_count =
+                reader.GetElementCount("/mld/cellstorage/destination_boundary");
             layout.SetBlockSize<NodeID>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
                                         destination_node_count);
-            const auto cell_count = reader.ReadVectorSize<partition::CellStorage::CellData>();
+            const auto cell_count = reader.GetElementCount("/mld/cellstorage/cells");
             layout.SetBlockSize<partition::CellStorage::CellData>(DataLayout::MLD_CELLS,
                                                                   cell_count);
-            const auto level_offsets_count = reader.ReadVectorSize<std::uint64_t>();
+            const auto level_offsets_count =
+                reader.GetElementCount("/mld/cellstorage/level_to_cell_offset");
             layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_CELL_LEVEL_OFFSETS,
                                                level_offsets_count);
         }
@@ -453,14 +650,12 @@ void Storage::PopulateLayout(DataLayout &layout)
 
         if (boost::filesystem::exists(config.mld_graph_path))
         {
-            io::FileReader reader(config.mld_graph_path, io::FileReader::VerifyFingerprint);
+            container::FileReader reader(config.mld_graph_path);
 
-            const auto num_nodes =
-                reader.ReadVectorSize<customizer::MultiLevelEdgeBasedGraph::NodeArrayEntry>();
-            const auto num_edges =
-                reader.ReadVectorSize<customizer::MultiLevelEdgeBasedGraph::EdgeArrayEntry>();
+            const auto num_nodes = reader.GetElementCount("/mld/multilevelgraph/node_array");
+            const auto num_edges = reader.GetElementCount("/mld/multilevelgraph/edge_array");
             const auto num_node_offsets =
-                reader.ReadVectorSize<customizer::MultiLevelEdgeBasedGraph::EdgeOffset>();
+                reader.GetElementCount("/mld/multilevelgraph/node_to_edge_offset");
 
             layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::NodeArrayEntry>(
                 DataLayout::MLD_GRAPH_NODE_LIST, num_nodes);
@@ -478,499 +673,825 @@ void Storage::PopulateLayout(DataLayout &layout)
             layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::EdgeOffset>(
                 DataLayout::MLD_GRAPH_NODE_TO_OFFSET, 0);
         }
+
+        // The overlay graph is optional and only written by osrm-customize --overlay-graph
+        using OverlayGraph = customizer::OverlayGraph;
+        if (boost::filesystem::exists(config.mld_overlay_path))
+        {
+            container::FileReader reader(config.mld_overlay_path);
+
+            const auto level_offsets_count =
+                reader.GetElementCount("/mld/overlaygraph/level_to_cell_offset");
+            layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_OVERLAY_LEVEL_OFFSETS,
+                                               level_offsets_count);
+            const auto cell_offsets_count =
+                reader.GetElementCount("/mld/overlaygraph/cell_offsets");
+            layout.SetBlockSize<OverlayGraph::CellOffsets>(DataLayout::MLD_OVERLAY_CELL_OFFSETS,
+                                                           cell_offsets_count);
+            const auto forward_nodes_count =
+                reader.GetElementCount("/mld/overlaygraph/forward_nodes");
+            layout.SetBlockSize<OverlayGraph::OverlayNode>(DataLayout::MLD_OVERLAY_FWD_NODES,
+                                                           forward_nodes_count);
+            const auto forward_arcs_count =
+                reader.GetElementCount("/mld/overlaygraph/forward_arcs");
+            layout.SetBlockSize<OverlayGraph::OverlayArc>(DataLayout::MLD_OVERLAY_FWD_ARCS,
+                                                          forward_arcs_count);
+            const auto backward_nodes_count =
+                reader.GetElementCount("/mld/overlaygraph/backward_nodes");
+            layout.SetBlockSize<OverlayGraph::OverlayNode>(DataLayout::MLD_OVERLAY_BWD_NODES,
+                                                           backward_nodes_count);
+            const auto backward_arcs_count =
+                reader.GetElementCount("/mld/overlaygraph/backward_arcs");
+            layout.SetBlockSize<OverlayGraph::OverlayArc>(DataLayout::MLD_OVERLAY_BWD_ARCS,
+                                                          backward_arcs_count);
+        }
+        else
+        {
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_LEVEL_OFFSETS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_CELL_OFFSETS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_FWD_NODES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_FWD_ARCS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_BWD_NODES, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_OVERLAY_BWD_ARCS, 0);
+        }
     }
 }
 
-void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+namespace
 {
-    BOOST_ASSERT(memory_ptr != nullptr);
+struct LoadStatistics
+{
+    double milliseconds = 0;
+    std::uint64_t bytes = 0;
+};
 
-    // read actual data into shared memory object //
+bool isLoadedBy(const std::vector<DataLayout::BlockID> &task_blocks,
+                const Storage::BlockSet &blocks)
+{
+    return std::any_of(task_blocks.begin(), task_blocks.end(), [&](const auto bid) {
+        return blocks.test(bid);
+    });
+}
+
+// osrm-customize writes the cells, the graph and the overlay graph in one run. The weights of
+// the graph and the overlay graph are derived from the cell weights and MLD queries prefer the
+// overlay graph if it is loaded, so one of them can not be replaced without the others.
+const std::vector<DataLayout::BlockID> customized_blocks = {DataLayout::MLD_CELL_WEIGHTS,
+                                                           DataLayout::MLD_GRAPH_EDGE_LIST,
+                                                           DataLayout::MLD_OVERLAY_FWD_ARCS};
+}
+
+// Tasks capture the layout and the memory pointer by value, they are only executed
+// by PopulateData but can be inspected without touching any memory.
+std::vector<Storage::LoadTask> Storage::MakeLoadTasks(const DataLayout &layout, char *memory_ptr)
+{
+    std::vector<LoadTask> tasks;
 
     // Load the HSGR file
     if (boost::filesystem::exists(config.hsgr_data_path))
     {
-        auto graph_nodes_ptr = layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
-        auto graph_edges_ptr = layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
-        auto checksum = layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
-
-        util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
-            graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
-        util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
-            graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
-
-        contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
-        contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+        tasks.push_back(
+            {"hsgr",
+             {DataLayout::HSGR_CHECKSUM,
+              DataLayout::CH_GRAPH_NODE_LIST,
+              DataLayout::CH_GRAPH_EDGE_LIST},
+             [=] {
+                 auto graph_nodes_ptr =
+                     layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+                         memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
+                 auto graph_edges_ptr =
+                     layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+                         memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
+                 auto checksum =
+                     layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
+
+                 util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
+                     graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
+                 util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
+                     graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+
+                 contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
+                 contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+             }});
     }
     else
     {
-        layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
-        layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
-            memory_ptr, DataLayout::CH_GRAPH_NODE_LIST);
-        layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
-            memory_ptr, DataLayout::CH_GRAPH_EDGE_LIST);
+        tasks.push_back({"hsgr",
+                         {DataLayout::HSGR_CHECKSUM,
+                          DataLayout::CH_GRAPH_NODE_LIST,
+                          DataLayout::CH_GRAPH_EDGE_LIST},
+                         [=] {
+                             layout.GetBlockPtr<unsigned, true>(memory_ptr,
+                                                                DataLayout::HSGR_CHECKSUM);
+                             layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+                                 memory_ptr, DataLayout::CH_GRAPH_NODE_LIST);
+                             layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+                                 memory_ptr, DataLayout::CH_GRAPH_EDGE_LIST);
+                         }});
     }
 
     // store the filename of the on-disk portion of the RTree
-    {
-        const auto file_index_path_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::FILE_INDEX_PATH);
-        // make sure we have 0 ending
-        std::fill(file_index_path_ptr,
-                  file_index_path_ptr + layout.GetBlockSize(DataLayout::FILE_INDEX_PATH),
-                  0);
-        const auto absolute_file_index_path =
-            boost::filesystem::absolute(config.file_index_path).string();
-        BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::FILE_INDEX_PATH)) >=
-                     absolute_file_index_path.size());
-        std::copy(
-            absolute_file_index_path.begin(), absolute_file_index_path.end(), file_index_path_ptr);
-    }
+    tasks.push_back({"file index path", {DataLayout::FILE_INDEX_PATH}, [=] {
+                         const auto file_index_path_ptr = layout.GetBlockPtr<char, true>(
+                             memory_ptr, DataLayout::FILE_INDEX_PATH);
+                         // make sure we have 0 ending
+                         std::fill(file_index_path_ptr,
+                                   file_index_path_ptr +
+                                       layout.GetBlockSize(DataLayout::FILE_INDEX_PATH),
+                                   0);
+                         const auto absolute_file_index_path =
+                             boost::filesystem::absolute(config.file_index_path).string();
+                         BOOST_ASSERT(static_cast<std::size_t>(
+                                          layout.GetBlockSize(DataLayout::FILE_INDEX_PATH)) >=
+                                      absolute_file_index_path.size());
+                         std::copy(absolute_file_index_path.begin(),
+                                   absolute_file_index_path.end(),
+                                   file_index_path_ptr);
+                     }});
 
     // Name data
-    {
-        io::FileReader name_file(config.names_data_path, io::FileReader::VerifyFingerprint);
-        std::size_t name_file_size = name_file.GetSize();
+    tasks.push_back({"names", {DataLayout::NAME_CHAR_DATA}, [=] {
+                         io::FileReader name_file(config.names_data_path,
+                                                  io::FileReader::VerifyFingerprint);
+                         std::size_t name_file_size = name_file.GetSize();
 
-        BOOST_ASSERT(name_file_size == layout.GetBlockSize(DataLayout::NAME_CHAR_DATA));
-        const auto name_char_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_DATA);
+                         BOOST_ASSERT(name_file_size ==
+                                      layout.GetBlockSize(DataLayout::NAME_CHAR_DATA));
+                         const auto name_char_ptr =
+                             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_DATA);
 
-        name_file.ReadInto<char>(name_char_ptr, name_file_size);
-    }
+                         name_file.ReadInto<char>(name_char_ptr, name_file_size);
+                     }});
 
     // Turn lane data
-    {
-        io::FileReader lane_data_file(config.turn_lane_data_path,
-                                      io::FileReader::VerifyFingerprint);
-
-        const auto lane_tuple_count = lane_data_file.ReadElementCount64();
-
-        // Need to call GetBlockPtr -> it write the memory canary, even if no data needs to be
-        // loaded.
-        const auto turn_lane_data_ptr = layout.GetBlockPtr<util::guidance::LaneTupleIdPair, true>(
-            memory_ptr, DataLayout::TURN_LANE_DATA);
-        BOOST_ASSERT(lane_tuple_count * sizeof(util::guidance::LaneTupleIdPair) ==
-                     layout.GetBlockSize(DataLayout::TURN_LANE_DATA));
-        lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
-    }
+    tasks.push_back({"turn lane data", {DataLayout::TURN_LANE_DATA}, [=] {
+                         io::FileReader lane_data_file(config.turn_lane_data_path,
+                                                       io::FileReader::VerifyFingerprint);
+
+                         const auto lane_tuple_count = lane_data_file.ReadElementCount64();
+
+                         // Need to call GetBlockPtr -> it write the memory canary, even if no data
+                         // needs to be loaded.
+                         const auto turn_lane_data_ptr =
+                             layout.GetBlockPtr<util::guidance::LaneTupleIdPair, true>(
+                                 memory_ptr, DataLayout::TURN_LANE_DATA);
+                         BOOST_ASSERT(lane_tuple_count * sizeof(util::guidance::LaneTupleIdPair) ==
+                                      layout.GetBlockSize(DataLayout::TURN_LANE_DATA));
+                         lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
+                     }});
 
     // Turn lane descriptions
-    {
-        auto offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
-            memory_ptr, storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
-        util::vector_view<std::uint32_t> offsets(
-            offsets_ptr, layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_OFFSETS]);
-
-        auto masks_ptr = layout.GetBlockPtr<extractor::guidance::TurnLaneType::Mask, true>(
-            memory_ptr, storage::DataLayout::LANE_DESCRIPTION_MASKS);
-        util::vector_view<extractor::guidance::TurnLaneType::Mask> masks(
-            masks_ptr, layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_MASKS]);
-
-        extractor::files::readTurnLaneDescriptions(
-            config.turn_lane_description_path, offsets, masks);
-    }
+    tasks.push_back(
+        {"turn lane descriptions",
+         {DataLayout::LANE_DESCRIPTION_OFFSETS, DataLayout::LANE_DESCRIPTION_MASKS},
+         [=] {
+             auto offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
+                 memory_ptr, storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
+             util::vector_view<std::uint32_t> offsets(
+                 offsets_ptr, layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_OFFSETS]);
+
+             auto masks_ptr = layout.GetBlockPtr<extractor::guidance::TurnLaneType::Mask, true>(
+                 memory_ptr, storage::DataLayout::LANE_DESCRIPTION_MASKS);
+             util::vector_view<extractor::guidance::TurnLaneType::Mask> masks(
+                 masks_ptr, layout.num_entries[storage::DataLayout::LANE_DESCRIPTION_MASKS]);
+
+             extractor::files::readTurnLaneDescriptions(
+                 config.turn_lane_description_path, offsets, masks);
+         }});
 
     // Load original edge data
-    {
-        auto via_geometry_list_ptr =
-            layout.GetBlockPtr<GeometryID, true>(memory_ptr, storage::DataLayout::VIA_NODE_LIST);
-        util::vector_view<GeometryID> geometry_ids(
-            via_geometry_list_ptr, layout.num_entries[storage::DataLayout::VIA_NODE_LIST]);
-
-        const auto travel_mode_list_ptr = layout.GetBlockPtr<extractor::TravelMode, true>(
-            memory_ptr, storage::DataLayout::TRAVEL_MODE);
-        util::vector_view<extractor::TravelMode> travel_modes(
-            travel_mode_list_ptr, layout.num_entries[storage::DataLayout::TRAVEL_MODE]);
-
-        const auto lane_data_id_ptr =
-            layout.GetBlockPtr<LaneDataID, true>(memory_ptr, storage::DataLayout::LANE_DATA_ID);
-        util::vector_view<LaneDataID> lane_data_ids(
-            lane_data_id_ptr, layout.num_entries[storage::DataLayout::LANE_DATA_ID]);
-
-        const auto turn_instruction_list_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-                memory_ptr, storage::DataLayout::TURN_INSTRUCTION);
-        util::vector_view<extractor::guidance::TurnInstruction> turn_instructions(
-            turn_instruction_list_ptr, layout.num_entries[storage::DataLayout::TURN_INSTRUCTION]);
-
-        const auto name_id_list_ptr =
-            layout.GetBlockPtr<NameID, true>(memory_ptr, storage::DataLayout::NAME_ID_LIST);
-        util::vector_view<NameID> name_ids(name_id_list_ptr,
-                                           layout.num_entries[storage::DataLayout::NAME_ID_LIST]);
-
-        const auto entry_class_id_list_ptr =
-            layout.GetBlockPtr<EntryClassID, true>(memory_ptr, storage::DataLayout::ENTRY_CLASSID);
-        util::vector_view<EntryClassID> entry_class_ids(
-            entry_class_id_list_ptr, layout.num_entries[storage::DataLayout::ENTRY_CLASSID]);
-
-        const auto pre_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, storage::DataLayout::PRE_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> pre_turn_bearings(
-            pre_turn_bearing_ptr, layout.num_entries[storage::DataLayout::PRE_TURN_BEARING]);
-
-        const auto post_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, storage::DataLayout::POST_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> post_turn_bearings(
-            post_turn_bearing_ptr, layout.num_entries[storage::DataLayout::POST_TURN_BEARING]);
-
-        extractor::TurnDataView turn_data(std::move(geometry_ids),
-                                          std::move(name_ids),
-                                          std::move(turn_instructions),
-                                          std::move(lane_data_ids),
-                                          std::move(travel_modes),
-                                          std::move(entry_class_ids),
-                                          std::move(pre_turn_bearings),
-                                          std::move(post_turn_bearings));
-
-        extractor::files::readTurnData(config.edges_data_path, turn_data);
-    }
+    tasks.push_back(
+        {"turn data",
+         {DataLayout::VIA_NODE_LIST,
+          DataLayout::TRAVEL_MODE,
+          DataLayout::LANE_DATA_ID,
+          DataLayout::TURN_INSTRUCTION,
+          DataLayout::NAME_ID_LIST,
+          DataLayout::ENTRY_CLASSID,
+          DataLayout::PRE_TURN_BEARING,
+          DataLayout::POST_TURN_BEARING},
+         [=] {
+             auto via_geometry_list_ptr = layout.GetBlockPtr<GeometryID, true>(
+                 memory_ptr, storage::DataLayout::VIA_NODE_LIST);
+             util::vector_view<GeometryID> geometry_ids(
+                 via_geometry_list_ptr, layout.num_entries[storage::DataLayout::VIA_NODE_LIST]);
+
+             const auto travel_mode_list_ptr = layout.GetBlockPtr<extractor::TravelMode, true>(
+                 memory_ptr, storage::DataLayout::TRAVEL_MODE);
+             util::vector_view<extractor::TravelMode> travel_modes(
+                 travel_mode_list_ptr, layout.num_entries[storage::DataLayout::TRAVEL_MODE]);
+
+             const auto lane_data_id_ptr = layout.GetBlockPtr<LaneDataID, true>(
+                 memory_ptr, storage::DataLayout::LANE_DATA_ID);
+             util::vector_view<LaneDataID> lane_data_ids(
+                 lane_data_id_ptr, layout.num_entries[storage::DataLayout::LANE_DATA_ID]);
+
+             const auto turn_instruction_list_ptr =
+                 layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
+                     memory_ptr, storage::DataLayout::TURN_INSTRUCTION);
+             util::vector_view<extractor::guidance::TurnInstruction> turn_instructions(
+                 turn_instruction_list_ptr,
+                 layout.num_entries[storage::DataLayout::TURN_INSTRUCTION]);
+
+             const auto name_id_list_ptr =
+                 layout.GetBlockPtr<NameID, true>(memory_ptr, storage::DataLayout::NAME_ID_LIST);
+             util::vector_view<NameID> name_ids(
+                 name_id_list_ptr, layout.num_entries[storage::DataLayout::NAME_ID_LIST]);
+
+             const auto entry_class_id_list_ptr = layout.GetBlockPtr<EntryClassID, true>(
+                 memory_ptr, storage::DataLayout::ENTRY_CLASSID);
+             util::vector_view<EntryClassID> entry_class_ids(
+                 entry_class_id_list_ptr, layout.num_entries[storage::DataLayout::ENTRY_CLASSID]);
+
+             const auto pre_turn_bearing_ptr =
+                 layout.GetBlockPtr<util::guidance::TurnBearing, true>(
+                     memory_ptr, storage::DataLayout::PRE_TURN_BEARING);
+             util::vector_view<util::guidance::TurnBearing> pre_turn_bearings(
+                 pre_turn_bearing_ptr, layout.num_entries[storage::DataLayout::PRE_TURN_BEARING]);
+
+             const auto post_turn_bearing_ptr =
+                 layout.GetBlockPtr<util::guidance::TurnBearing, true>(
+                     memory_ptr, storage::DataLayout::POST_TURN_BEARING);
+             util::vector_view<util::guidance::TurnBearing> post_turn_bearings(
+                 post_turn_bearing_ptr, layout.num_entries[storage::DataLayout::POST_TURN_BEARING]);
+
+             extractor::TurnDataView turn_data(std::move(geometry_ids),
+                                               std::move(name_ids),
+                                               std::move(turn_instructions),
+                                               std::move(lane_data_ids),
+                                               std::move(travel_modes),
+                                               std::move(entry_class_ids),
+                                               std::move(pre_turn_bearings),
+                                               std::move(post_turn_bearings));
+
+             extractor::files::readTurnData(config.edges_data_path, turn_data);
+         }});
 
     // load compressed geometry
-    {
-        auto geometries_index_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::GEOMETRIES_INDEX);
-        util::vector_view<unsigned> geometry_begin_indices(
-            geometries_index_ptr, layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
-
-        auto geometries_node_list_ptr =
-            layout.GetBlockPtr<NodeID, true>(memory_ptr, storage::DataLayout::GEOMETRIES_NODE_LIST);
-        util::vector_view<NodeID> geometry_node_list(
-            geometries_node_list_ptr,
-            layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST]);
+    tasks.push_back(
+        {"geometries",
+         {DataLayout::GEOMETRIES_INDEX,
+          DataLayout::GEOMETRIES_NODE_LIST,
+          DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+          DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+          DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+          DataLayout::GEOMETRIES_REV_DURATION_LIST,
+          DataLayout::DATASOURCES_LIST},
+         [=] {
+             auto geometries_index_ptr = layout.GetBlockPtr<unsigned, true>(
+                 memory_ptr, storage::DataLayout::GEOMETRIES_INDEX);
+             util::vector_view<unsigned> geometry_begin_indices(
+                 geometries_index_ptr, layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
+
+             auto geometries_node_list_ptr = layout.GetBlockPtr<NodeID, true>(
+                 memory_ptr, storage::DataLayout::GEOMETRIES_NODE_LIST);
+             util::vector_view<NodeID> geometry_node_list(
+                 geometries_node_list_ptr,
+                 layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST]);
+
+             extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list;
+             geometry_fwd_weight_list.reset(
+                 layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST),
+                 layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
+
+             extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list;
+             geometry_rev_weight_list.reset(
+                 layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST),
+                 layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
+
+             extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list;
+             geometry_fwd_duration_list.reset(
+                 layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST),
+                 layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]);
+
+             extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list;
+             geometry_rev_duration_list.reset(
+                 layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST),
+                 layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]);
+
+             auto datasources_list_ptr = layout.GetBlockPtr<DatasourceID, true>(
+                 memory_ptr, storage::DataLayout::DATASOURCES_LIST);
+             util::vector_view<DatasourceID> datasources_list(
+                 datasources_list_ptr, layout.num_entries[storage::DataLayout::DATASOURCES_LIST]);
+
+             extractor::SegmentDataView segment_data{std::move(geometry_begin_indices),
+                                                     std::move(geometry_node_list),
+                                                     std::move(geometry_fwd_weight_list),
+                                                     std::move(geometry_rev_weight_list),
+                                                     std::move(geometry_fwd_duration_list),
+                                                     std::move(geometry_rev_duration_list),
+                                                     std::move(datasources_list)};
+
+             extractor::files::readSegmentData(config.geometries_path, segment_data);
+         }});
+
+    tasks.push_back({"datasource names", {DataLayout::DATASOURCES_NAMES}, [=] {
+                         const auto datasources_names_ptr =
+                             layout.GetBlockPtr<extractor::Datasources, true>(
+                                 memory_ptr, DataLayout::DATASOURCES_NAMES);
+                         extractor::files::readDatasources(config.datasource_names_path,
+                                                           *datasources_names_ptr);
+                     }});
 
-        auto geometries_fwd_weight_list_ptr = layout.GetBlockPtr<SegmentWeight, true>(
-            memory_ptr, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
-        util::vector_view<SegmentWeight> geometry_fwd_weight_list(
-            geometries_fwd_weight_list_ptr,
-            layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
-
-        auto geometries_rev_weight_list_ptr = layout.GetBlockPtr<SegmentWeight, true>(
-            memory_ptr, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
-        util::vector_view<SegmentWeight> geometry_rev_weight_list(
-            geometries_rev_weight_list_ptr,
-            layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
-
-        auto geometries_fwd_duration_list_ptr = layout.GetBlockPtr<SegmentDuration, true>(
-            memory_ptr, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
-        util::vector_view<SegmentDuration> geometry_fwd_duration_list(
-            geometries_fwd_duration_list_ptr,
-            layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]);
+    // Loading list of coordinates
+    tasks.push_back({"nodes", {DataLayout::COORDINATE_LIST, DataLayout::OSM_NODE_ID_LIST}, [=] {
+                         const auto coordinates_ptr = layout.GetBlockPtr<util::Coordinate, true>(
+                             memory_ptr, DataLayout::COORDINATE_LIST);
+                         const auto osmnodeid_ptr = layout.GetBlockPtr<std::uint64_t, true>(
+                             memory_ptr, DataLayout::OSM_NODE_ID_LIST);
+                         util::vector_view<util::Coordinate> coordinates(
+                             coordinates_ptr, layout.num_entries[DataLayout::COORDINATE_LIST]);
+                         extractor::PackedOSMIDsView osm_node_ids;
+                         osm_node_ids.reset(osmnodeid_ptr,
+                                            layout.num_entries[DataLayout::OSM_NODE_ID_LIST]);
+
+                         extractor::files::readNodes(
+                             config.nodes_data_path, coordinates, osm_node_ids);
+                     }});
 
-        auto geometries_rev_duration_list_ptr = layout.GetBlockPtr<SegmentDuration, true>(
-            memory_ptr, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
-        util::vector_view<SegmentDuration> geometry_rev_duration_list(
-            geometries_rev_duration_list_ptr,
-            layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]);
+    // load turn weight penalties
+    tasks.push_back({"turn weight penalties", {DataLayout::TURN_WEIGHT_PENALTIES}, [=] {
+                         io::FileReader turn_weight_penalties_file(
+                             config.turn_weight_penalties_path, io::FileReader::VerifyFingerprint);
+                         const auto number_of_penalties =
+                             turn_weight_penalties_file.ReadElementCount64();
+                         const auto turn_weight_penalties_ptr =
+                             layout.GetBlockPtr<TurnPenalty, true>(
+                                 memory_ptr, DataLayout::TURN_WEIGHT_PENALTIES);
+                         turn_weight_penalties_file.ReadInto(turn_weight_penalties_ptr,
+                                                             number_of_penalties);
+                     }});
 
-        auto datasources_list_ptr = layout.GetBlockPtr<DatasourceID, true>(
-            memory_ptr, storage::DataLayout::DATASOURCES_LIST);
-        util::vector_view<DatasourceID> datasources_list(
-            datasources_list_ptr, layout.num_entries[storage::DataLayout::DATASOURCES_LIST]);
+    // load turn duration penalties
+    tasks.push_back({"turn duration penalties", {DataLayout::TURN_DURATION_PENALTIES}, [=] {
+                         io::FileReader turn_duration_penalties_file(
+                             config.turn_duration_penalties_path,
+                             io::FileReader::VerifyFingerprint);
+                         const auto number_of_penalties =
+                             turn_duration_penalties_file.ReadElementCount64();
+                         const auto turn_duration_penalties_ptr =
+                             layout.GetBlockPtr<TurnPenalty, true>(
+                                 memory_ptr, DataLayout::TURN_DURATION_PENALTIES);
+                         turn_duration_penalties_file.ReadInto(turn_duration_penalties_ptr,
+                                                               number_of_penalties);
+                     }});
 
-        extractor::SegmentDataView segment_data{std::move(geometry_begin_indices),
-                                                std::move(geometry_node_list),
-                                                std::move(geometry_fwd_weight_list),
-                                                std::move(geometry_rev_weight_list),
-                                                std::move(geometry_fwd_duration_list),
-                                                std::move(geometry_rev_duration_list),
-                                                std::move(datasources_list)};
+    // store timestamp
+    tasks.push_back({"timestamp", {DataLayout::TIMESTAMP}, [=] {
+                         io::FileReader timestamp_file(config.timestamp_path,
+                                                       io::FileReader::VerifyFingerprint);
+                         const auto timestamp_size = timestamp_file.GetSize();
 
-        extractor::files::readSegmentData(config.geometries_path, segment_data);
-    }
+                         const auto timestamp_ptr =
+                             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
+                         BOOST_ASSERT(timestamp_size == layout.num_entries[DataLayout::TIMESTAMP]);
+                         timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
+                     }});
 
+    // store search tree portion of rtree
+    tasks.push_back({"rtree", {DataLayout::R_SEARCH_TREE}, [=] {
+                         io::FileReader tree_node_file(config.ram_index_path,
+                                                       io::FileReader::VerifyFingerprint);
+                         // the header and size were checked by PopulateLayout, skip them so
+                         // that we're at the right stream position for the next read.
+                         tree_node_file.Skip<util::detail::RTreeFileHeader>(1);
+                         tree_node_file.Skip<std::uint64_t>(1);
+                         const auto rtree_ptr = layout.GetBlockPtr<RTreeNode, true>(
+                             memory_ptr, DataLayout::R_SEARCH_TREE);
+
+                         tree_node_file.ReadInto(rtree_ptr,
+                                                 layout.num_entries[DataLayout::R_SEARCH_TREE]);
+                     }});
+
+    if (config.load_rtree_leaves)
     {
-        const auto datasources_names_ptr = layout.GetBlockPtr<extractor::Datasources, true>(
-            memory_ptr, DataLayout::DATASOURCES_NAMES);
-        extractor::files::readDatasources(config.datasource_names_path, *datasources_names_ptr);
+        tasks.push_back({"rtree leaves", {DataLayout::R_SEARCH_TREE_LEAVES}, [=] {
+                             io::FileReader leaf_node_file(config.file_index_path,
+                                                           io::FileReader::HasNoFingerprint);
+                             const auto leaves_ptr = layout.GetBlockPtr<RTreeLeafNode, true>(
+                                 memory_ptr, DataLayout::R_SEARCH_TREE_LEAVES);
+
+                             leaf_node_file.ReadInto(
+                                 leaves_ptr, layout.num_entries[DataLayout::R_SEARCH_TREE_LEAVES]);
+                         }});
     }
 
-    // Loading list of coordinates
+    if (boost::filesystem::exists(config.snapping_grid_path))
     {
-        const auto coordinates_ptr =
-            layout.GetBlockPtr<util::Coordinate, true>(memory_ptr, DataLayout::COORDINATE_LIST);
-        const auto osmnodeid_ptr =
-            layout.GetBlockPtr<std::uint64_t, true>(memory_ptr, DataLayout::OSM_NODE_ID_LIST);
-        util::vector_view<util::Coordinate> coordinates(
-            coordinates_ptr, layout.num_entries[DataLayout::COORDINATE_LIST]);
-        extractor::PackedOSMIDsView osm_node_ids;
-        osm_node_ids.reset(osmnodeid_ptr, layout.num_entries[DataLayout::OSM_NODE_ID_LIST]);
-
-        extractor::files::readNodes(config.nodes_data_path, coordinates, osm_node_ids);
+        tasks.push_back({"snapping grid",
+                         {DataLayout::SNAPPING_GRID_CELL_SIZE,
+                          DataLayout::SNAPPING_GRID_CELLS,
+                          DataLayout::SNAPPING_GRID_CELL_OFFSETS,
+                          DataLayout::SNAPPING_GRID_LEAF_IDS},
+                         [=] {
+                             const auto cell_size_ptr = layout.GetBlockPtr<std::int32_t, true>(
+                                 memory_ptr, DataLayout::SNAPPING_GRID_CELL_SIZE);
+                             util::vector_view<std::uint64_t> cells(
+                                 layout.GetBlockPtr<std::uint64_t, true>(
+                                     memory_ptr, DataLayout::SNAPPING_GRID_CELLS),
+                                 layout.num_entries[DataLayout::SNAPPING_GRID_CELLS]);
+                             util::vector_view<std::uint32_t> cell_offsets(
+                                 layout.GetBlockPtr<std::uint32_t, true>(
+                                     memory_ptr, DataLayout::SNAPPING_GRID_CELL_OFFSETS),
+                                 layout.num_entries[DataLayout::SNAPPING_GRID_CELL_OFFSETS]);
+                             util::vector_view<std::uint32_t> leaf_ids(
+                                 layout.GetBlockPtr<std::uint32_t, true>(
+                                     memory_ptr, DataLayout::SNAPPING_GRID_LEAF_IDS),
+                                 layout.num_entries[DataLayout::SNAPPING_GRID_LEAF_IDS]);
+
+                             util::SnappingGridView grid{0,
+                                                         std::move(cells),
+                                                         std::move(cell_offsets),
+                                                         std::move(leaf_ids)};
+                             extractor::files::readSnappingGrid(config.snapping_grid_path, grid);
+                             *cell_size_ptr = grid.GetCellSize();
+                         }});
     }
 
-    // load turn weight penalties
+    if (boost::filesystem::exists(config.core_data_path))
     {
-        io::FileReader turn_weight_penalties_file(config.turn_weight_penalties_path,
-                                                  io::FileReader::VerifyFingerprint);
-        const auto number_of_penalties = turn_weight_penalties_file.ReadElementCount64();
-        const auto turn_weight_penalties_ptr =
-            layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_WEIGHT_PENALTIES);
-        turn_weight_penalties_file.ReadInto(turn_weight_penalties_ptr, number_of_penalties);
+        tasks.push_back({"core markers", {DataLayout::CH_CORE_MARKER}, [=] {
+                             io::FileReader core_marker_file(config.core_data_path,
+                                                             io::FileReader::VerifyFingerprint);
+                             const auto number_of_core_markers =
+                                 core_marker_file.ReadElementCount64();
+
+                             // load core markers
+                             std::vector<char> unpacked_core_markers(number_of_core_markers);
+                             core_marker_file.ReadInto(unpacked_core_markers.data(),
+                                                       number_of_core_markers);
+
+                             const auto core_marker_ptr = layout.GetBlockPtr<unsigned, true>(
+                                 memory_ptr, DataLayout::CH_CORE_MARKER);
+
+                             for (auto i = 0u; i < number_of_core_markers; ++i)
+                             {
+                                 BOOST_ASSERT(unpacked_core_markers[i] == 0 ||
+                                              unpacked_core_markers[i] == 1);
+
+                                 if (unpacked_core_markers[i] == 1)
+                                 {
+                                     const unsigned bucket = i / 32;
+                                     const unsigned offset = i % 32;
+                                     const unsigned value = [&] {
+                                         unsigned return_value = 0;
+                                         if (0 != offset)
+                                         {
+                                             return_value = core_marker_ptr[bucket];
+                                         }
+                                         return return_value;
+                                     }();
+
+                                     core_marker_ptr[bucket] = (value | (1u << offset));
+                                 }
+                             }
+                         }});
     }
 
-    // load turn duration penalties
+    // load profile properties
+    tasks.push_back({"profile properties", {DataLayout::PROPERTIES}, [=] {
+                         io::FileReader profile_properties_file(config.properties_path,
+                                                                io::FileReader::VerifyFingerprint);
+                         const auto profile_properties_ptr =
+                             layout.GetBlockPtr<extractor::ProfileProperties, true>(
+                                 memory_ptr, DataLayout::PROPERTIES);
+                         profile_properties_file.ReadInto(
+                             profile_properties_ptr, layout.num_entries[DataLayout::PROPERTIES]);
+                     }});
+
+    // Load intersection data
+    tasks.push_back(
+        {"intersection classes",
+         {DataLayout::BEARING_CLASSID,
+          DataLayout::BEARING_OFFSETS,
+          DataLayout::BEARING_BLOCKS,
+          DataLayout::BEARING_VALUES,
+          DataLayout::ENTRY_CLASS},
+         [=] {
+             io::FileReader intersection_file(config.intersection_class_path,
+                                              io::FileReader::VerifyFingerprint);
+
+             std::vector<BearingClassID> bearing_class_id_table;
+             serialization::read(intersection_file, bearing_class_id_table);
+
+             const auto bearing_blocks = intersection_file.ReadElementCount64();
+             intersection_file.Skip<std::uint32_t>(1); // sum_lengths
+
+             std::vector<unsigned> bearing_offsets_data(bearing_blocks);
+             std::vector<typename util::RangeTable<16, storage::Ownership::View>::BlockT>
+                 bearing_blocks_data(bearing_blocks);
+
+             intersection_file.ReadInto(bearing_offsets_data.data(), bearing_blocks);
+             intersection_file.ReadInto(bearing_blocks_data.data(), bearing_blocks);
+
+             const auto num_bearings = intersection_file.ReadElementCount64();
+
+             std::vector<DiscreteBearing> bearing_class_table(num_bearings);
+             intersection_file.ReadInto(bearing_class_table.data(), num_bearings);
+
+             std::vector<util::guidance::EntryClass> entry_class_table;
+             serialization::read(intersection_file, entry_class_table);
+
+             // load intersection classes, the canaries are written even for empty tables
+             const auto bearing_id_ptr =
+                 layout.GetBlockPtr<BearingClassID, true>(memory_ptr, DataLayout::BEARING_CLASSID);
+             BOOST_ASSERT(
+                 static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_CLASSID)) >=
+                 bearing_class_id_table.size() *
+                     sizeof(decltype(bearing_class_id_table)::value_type));
+             std::copy(
+                 bearing_class_id_table.begin(), bearing_class_id_table.end(), bearing_id_ptr);
+
+             const auto bearing_offsets_ptr =
+                 layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::BEARING_OFFSETS);
+             BOOST_ASSERT(
+                 static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_OFFSETS)) >=
+                 bearing_offsets_data.size() * sizeof(decltype(bearing_offsets_data)::value_type));
+             std::copy(
+                 bearing_offsets_data.begin(), bearing_offsets_data.end(), bearing_offsets_ptr);
+
+             const auto bearing_blocks_ptr =
+                 layout.GetBlockPtr<typename util::RangeTable<16, storage::Ownership::View>::BlockT,
+                                    true>(memory_ptr, DataLayout::BEARING_BLOCKS);
+             BOOST_ASSERT(
+                 static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_BLOCKS)) >=
+                 bearing_blocks_data.size() * sizeof(decltype(bearing_blocks_data)::value_type));
+             std::copy(bearing_blocks_data.begin(), bearing_blocks_data.end(), bearing_blocks_ptr);
+
+             const auto bearing_class_ptr =
+                 layout.GetBlockPtr<DiscreteBearing, true>(memory_ptr, DataLayout::BEARING_VALUES);
+             BOOST_ASSERT(
+                 static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_VALUES)) >=
+                 bearing_class_table.size() * sizeof(decltype(bearing_class_table)::value_type));
+             std::copy(bearing_class_table.begin(), bearing_class_table.end(), bearing_class_ptr);
+
+             const auto entry_class_ptr = layout.GetBlockPtr<util::guidance::EntryClass, true>(
+                 memory_ptr, DataLayout::ENTRY_CLASS);
+             BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::ENTRY_CLASS)) >=
+                          entry_class_table.size() *
+                              sizeof(decltype(entry_class_table)::value_type));
+             std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
+         }});
+
+    // Loading MLD Data
+    if (boost::filesystem::exists(config.mld_partition_path))
     {
-        io::FileReader turn_duration_penalties_file(config.turn_duration_penalties_path,
-                                                    io::FileReader::VerifyFingerprint);
-        const auto number_of_penalties = turn_duration_penalties_file.ReadElementCount64();
-        const auto turn_duration_penalties_ptr =
-            layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_DURATION_PENALTIES);
-        turn_duration_penalties_file.ReadInto(turn_duration_penalties_ptr, number_of_penalties);
+        tasks.push_back(
+            {"mld partition",
+             {DataLayout::MLD_LEVEL_DATA,
+              DataLayout::MLD_PARTITION,
+              DataLayout::MLD_CELL_TO_CHILDREN},
+             [=] {
+                 BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
+                 BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
+                 BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0);
+
+                 auto level_data =
+                     layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData, true>(
+                         memory_ptr, storage::DataLayout::MLD_LEVEL_DATA);
+
+                 auto mld_partition_ptr = layout.GetBlockPtr<PartitionID, true>(
+                     memory_ptr, storage::DataLayout::MLD_PARTITION);
+                 auto partition_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_PARTITION);
+                 util::vector_view<PartitionID> partition(mld_partition_ptr,
+                                                          partition_entries_count);
+
+                 auto mld_chilren_ptr = layout.GetBlockPtr<CellID, true>(
+                     memory_ptr, storage::DataLayout::MLD_CELL_TO_CHILDREN);
+                 auto children_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_CELL_TO_CHILDREN);
+                 util::vector_view<CellID> cell_to_children(mld_chilren_ptr,
+                                                            children_entries_count);
+
+                 partition::MultiLevelPartitionView mlp{
+                     std::move(level_data), std::move(partition), std::move(cell_to_children)};
+                 partition::files::readPartition(config.mld_partition_path, mlp);
+             }});
     }
 
-    // store timestamp
+    if (boost::filesystem::exists(config.mld_storage_path))
     {
-        io::FileReader timestamp_file(config.timestamp_path, io::FileReader::VerifyFingerprint);
-        const auto timestamp_size = timestamp_file.GetSize();
-
-        const auto timestamp_ptr =
-            layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
-        BOOST_ASSERT(timestamp_size == layout.num_entries[DataLayout::TIMESTAMP]);
-        timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
+        tasks.push_back(
+            {"mld cells",
+             {DataLayout::MLD_CELL_WEIGHTS,
+              DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+              DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+              DataLayout::MLD_CELLS,
+              DataLayout::MLD_CELL_LEVEL_OFFSETS},
+             [=] {
+                 BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
+                 BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
+
+                 auto mld_cell_weights_ptr = layout.GetBlockPtr<EdgeWeight, true>(
+                     memory_ptr, storage::DataLayout::MLD_CELL_WEIGHTS);
+                 auto mld_source_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
+                     memory_ptr, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+                 auto mld_destination_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
+                     memory_ptr, storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+                 auto mld_cells_ptr =
+                     layout.GetBlockPtr<partition::CellStorageView::CellData, true>(
+                         memory_ptr, storage::DataLayout::MLD_CELLS);
+                 auto mld_cell_level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+
+                 auto weight_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
+                 auto source_boundary_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+                 auto destination_boundary_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+                 auto cells_entries_counts = layout.GetBlockEntries(storage::DataLayout::MLD_CELLS);
+                 auto cell_level_offsets_entries_count =
+                     layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+
+                 util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
+                 util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
+                                                           source_boundary_entries_count);
+                 util::vector_view<NodeID> destination_boundary(
+                     mld_destination_boundary_ptr, destination_boundary_entries_count);
+                 util::vector_view<partition::CellStorageView::CellData> cells(
+                     mld_cells_ptr, cells_entries_counts);
+                 util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
+                                                                cell_level_offsets_entries_count);
+
+                 partition::CellStorageView storage{std::move(weights),
+                                                    std::move(source_boundary),
+                                                    std::move(destination_boundary),
+                                                    std::move(cells),
+                                                    std::move(level_offsets)};
+                 partition::files::readCells(config.mld_storage_path, storage);
+             }});
     }
 
-    // store search tree portion of rtree
+    if (boost::filesystem::exists(config.mld_graph_path))
     {
-        io::FileReader tree_node_file(config.ram_index_path, io::FileReader::VerifyFingerprint);
-        // perform this read so that we're at the right stream position for the next
-        // read.
-        tree_node_file.Skip<std::uint64_t>(1);
-        const auto rtree_ptr =
-            layout.GetBlockPtr<RTreeNode, true>(memory_ptr, DataLayout::R_SEARCH_TREE);
-
-        tree_node_file.ReadInto(rtree_ptr, layout.num_entries[DataLayout::R_SEARCH_TREE]);
+        tasks.push_back(
+            {"mld graph",
+             {DataLayout::MLD_GRAPH_NODE_LIST,
+              DataLayout::MLD_GRAPH_EDGE_LIST,
+              DataLayout::MLD_GRAPH_NODE_TO_OFFSET},
+             [=] {
+                 using GraphView = customizer::MultiLevelEdgeBasedGraphView;
+
+                 auto graph_nodes_ptr = layout.GetBlockPtr<GraphView::NodeArrayEntry, true>(
+                     memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_LIST);
+                 auto graph_edges_ptr = layout.GetBlockPtr<GraphView::EdgeArrayEntry, true>(
+                     memory_ptr, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
+                 auto graph_node_to_offset_ptr = layout.GetBlockPtr<GraphView::EdgeOffset, true>(
+                     memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
+
+                 util::vector_view<GraphView::NodeArrayEntry> node_list(
+                     graph_nodes_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
+                 util::vector_view<GraphView::EdgeArrayEntry> edge_list(
+                     graph_edges_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
+                 util::vector_view<GraphView::EdgeOffset> node_to_offset(
+                     graph_node_to_offset_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
+
+                 GraphView graph_view(
+                     std::move(node_list), std::move(edge_list), std::move(node_to_offset));
+                 partition::files::readGraph(config.mld_graph_path, graph_view);
+             }});
     }
 
-    if (boost::filesystem::exists(config.core_data_path))
+    if (boost::filesystem::exists(config.mld_overlay_path))
     {
-        io::FileReader core_marker_file(config.core_data_path, io::FileReader::VerifyFingerprint);
-        const auto number_of_core_markers = core_marker_file.ReadElementCount64();
-
-        // load core markers
-        std::vector<char> unpacked_core_markers(number_of_core_markers);
-        core_marker_file.ReadInto(unpacked_core_markers.data(), number_of_core_markers);
-
-        const auto core_marker_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::CH_CORE_MARKER);
-
-        for (auto i = 0u; i < number_of_core_markers; ++i)
-        {
-            BOOST_ASSERT(unpacked_core_markers[i] == 0 || unpacked_core_markers[i] == 1);
-
-            if (unpacked_core_markers[i] == 1)
-            {
-                const unsigned bucket = i / 32;
-                const unsigned offset = i % 32;
-                const unsigned value = [&] {
-                    unsigned return_value = 0;
-                    if (0 != offset)
-                    {
-                        return_value = core_marker_ptr[bucket];
-                    }
-                    return return_value;
-                }();
-
-                core_marker_ptr[bucket] = (value | (1u << offset));
-            }
-        }
+        tasks.push_back(
+            {"mld overlay",
+             {DataLayout::MLD_OVERLAY_LEVEL_OFFSETS,
+              DataLayout::MLD_OVERLAY_CELL_OFFSETS,
+              DataLayout::MLD_OVERLAY_FWD_NODES,
+              DataLayout::MLD_OVERLAY_FWD_ARCS,
+              DataLayout::MLD_OVERLAY_BWD_NODES,
+              DataLayout::MLD_OVERLAY_BWD_ARCS},
+             [=] {
+                 using OverlayGraphView = customizer::OverlayGraphView;
+
+                 auto level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_LEVEL_OFFSETS);
+                 auto cell_offsets_ptr = layout.GetBlockPtr<OverlayGraphView::CellOffsets, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_CELL_OFFSETS);
+                 auto forward_nodes_ptr = layout.GetBlockPtr<OverlayGraphView::OverlayNode, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_FWD_NODES);
+                 auto forward_arcs_ptr = layout.GetBlockPtr<OverlayGraphView::OverlayArc, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_FWD_ARCS);
+                 auto backward_nodes_ptr = layout.GetBlockPtr<OverlayGraphView::OverlayNode, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_BWD_NODES);
+                 auto backward_arcs_ptr = layout.GetBlockPtr<OverlayGraphView::OverlayArc, true>(
+                     memory_ptr, storage::DataLayout::MLD_OVERLAY_BWD_ARCS);
+
+                 util::vector_view<std::uint64_t> level_offsets(
+                     level_offsets_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_LEVEL_OFFSETS]);
+                 util::vector_view<OverlayGraphView::CellOffsets> cell_offsets(
+                     cell_offsets_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_CELL_OFFSETS]);
+                 util::vector_view<OverlayGraphView::OverlayNode> forward_nodes(
+                     forward_nodes_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_FWD_NODES]);
+                 util::vector_view<OverlayGraphView::OverlayArc> forward_arcs(
+                     forward_arcs_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_FWD_ARCS]);
+                 util::vector_view<OverlayGraphView::OverlayNode> backward_nodes(
+                     backward_nodes_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_BWD_NODES]);
+                 util::vector_view<OverlayGraphView::OverlayArc> backward_arcs(
+                     backward_arcs_ptr,
+                     layout.num_entries[storage::DataLayout::MLD_OVERLAY_BWD_ARCS]);
+
+                 OverlayGraphView overlay_graph(std::move(level_offsets),
+                                                std::move(cell_offsets),
+                                                std::move(forward_nodes),
+                                                std::move(forward_arcs),
+                                                std::move(backward_nodes),
+                                                std::move(backward_arcs));
+                 customizer::files::readOverlayGraph(config.mld_overlay_path, overlay_graph);
+             }});
     }
 
-    // load profile properties
+    return tasks;
+}
+
+Storage::BlockSet Storage::GetLoadedBlocks(const BlockSet &requested)
+{
+    auto extended = requested;
+    if (isLoadedBy(customized_blocks, requested))
     {
-        io::FileReader profile_properties_file(config.properties_path,
-                                               io::FileReader::VerifyFingerprint);
-        const auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
-            memory_ptr, DataLayout::PROPERTIES);
-        profile_properties_file.ReadInto(profile_properties_ptr,
-                                         layout.num_entries[DataLayout::PROPERTIES]);
+        for (const auto bid : customized_blocks)
+            extended.set(bid);
     }
 
-    // Load intersection data
+    BlockSet loaded;
+    for (const auto &task : MakeLoadTasks(DataLayout{}, nullptr))
     {
-        io::FileReader intersection_file(config.intersection_class_path,
-                                         io::FileReader::VerifyFingerprint);
-
-        std::vector<BearingClassID> bearing_class_id_table;
-        serialization::read(intersection_file, bearing_class_id_table);
-
-        const auto bearing_blocks = intersection_file.ReadElementCount64();
-        intersection_file.Skip<std::uint32_t>(1); // sum_lengths
-
-        std::vector<unsigned> bearing_offsets_data(bearing_blocks);
-        std::vector<typename util::RangeTable<16, storage::Ownership::View>::BlockT>
-            bearing_blocks_data(bearing_blocks);
-
-        intersection_file.ReadInto(bearing_offsets_data.data(), bearing_blocks);
-        intersection_file.ReadInto(bearing_blocks_data.data(), bearing_blocks);
-
-        const auto num_bearings = intersection_file.ReadElementCount64();
-
-        std::vector<DiscreteBearing> bearing_class_table(num_bearings);
-        intersection_file.ReadInto(bearing_class_table.data(), num_bearings);
-
-        std::vector<util::guidance::EntryClass> entry_class_table;
-        serialization::read(intersection_file, entry_class_table);
-
-        // load intersection classes
-        if (!bearing_class_id_table.empty())
+        if (isLoadedBy(task.blocks, extended))
         {
-            const auto bearing_id_ptr =
-                layout.GetBlockPtr<BearingClassID, true>(memory_ptr, DataLayout::BEARING_CLASSID);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_CLASSID)) >=
-                std::distance(bearing_class_id_table.begin(), bearing_class_id_table.end()) *
-                    sizeof(decltype(bearing_class_id_table)::value_type));
-            std::copy(bearing_class_id_table.begin(), bearing_class_id_table.end(), bearing_id_ptr);
-        }
-
-        if (layout.GetBlockSize(DataLayout::BEARING_OFFSETS) > 0)
-        {
-            const auto bearing_offsets_ptr =
-                layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::BEARING_OFFSETS);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_OFFSETS)) >=
-                std::distance(bearing_offsets_data.begin(), bearing_offsets_data.end()) *
-                    sizeof(decltype(bearing_offsets_data)::value_type));
-            std::copy(
-                bearing_offsets_data.begin(), bearing_offsets_data.end(), bearing_offsets_ptr);
-        }
-
-        if (layout.GetBlockSize(DataLayout::BEARING_BLOCKS) > 0)
-        {
-            const auto bearing_blocks_ptr =
-                layout.GetBlockPtr<typename util::RangeTable<16, storage::Ownership::View>::BlockT,
-                                   true>(memory_ptr, DataLayout::BEARING_BLOCKS);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_BLOCKS)) >=
-                std::distance(bearing_blocks_data.begin(), bearing_blocks_data.end()) *
-                    sizeof(decltype(bearing_blocks_data)::value_type));
-            std::copy(bearing_blocks_data.begin(), bearing_blocks_data.end(), bearing_blocks_ptr);
-        }
-
-        if (!bearing_class_table.empty())
-        {
-            const auto bearing_class_ptr =
-                layout.GetBlockPtr<DiscreteBearing, true>(memory_ptr, DataLayout::BEARING_VALUES);
-            BOOST_ASSERT(
-                static_cast<std::size_t>(layout.GetBlockSize(DataLayout::BEARING_VALUES)) >=
-                std::distance(bearing_class_table.begin(), bearing_class_table.end()) *
-                    sizeof(decltype(bearing_class_table)::value_type));
-            std::copy(bearing_class_table.begin(), bearing_class_table.end(), bearing_class_ptr);
-        }
-
-        if (!entry_class_table.empty())
-        {
-            const auto entry_class_ptr = layout.GetBlockPtr<util::guidance::EntryClass, true>(
-                memory_ptr, DataLayout::ENTRY_CLASS);
-            BOOST_ASSERT(static_cast<std::size_t>(layout.GetBlockSize(DataLayout::ENTRY_CLASS)) >=
-                         std::distance(entry_class_table.begin(), entry_class_table.end()) *
-                             sizeof(decltype(entry_class_table)::value_type));
-            std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
+            for (const auto bid : task.blocks)
+                loaded.set(bid);
         }
     }
+    return loaded;
+}
 
-    {
-        // Loading MLD Data
-        if (boost::filesystem::exists(config.mld_partition_path))
-        {
-            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
-            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
-            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0);
-
-            auto level_data =
-                layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData, true>(
-                    memory_ptr, storage::DataLayout::MLD_LEVEL_DATA);
-
-            auto mld_partition_ptr = layout.GetBlockPtr<PartitionID, true>(
-                memory_ptr, storage::DataLayout::MLD_PARTITION);
-            auto partition_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_PARTITION);
-            util::vector_view<PartitionID> partition(mld_partition_ptr, partition_entries_count);
-
-            auto mld_chilren_ptr = layout.GetBlockPtr<CellID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_TO_CHILDREN);
-            auto children_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_TO_CHILDREN);
-            util::vector_view<CellID> cell_to_children(mld_chilren_ptr, children_entries_count);
-
-            partition::MultiLevelPartitionView mlp{
-                std::move(level_data), std::move(partition), std::move(cell_to_children)};
-            partition::files::readPartition(config.mld_partition_path, mlp);
-        }
+void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+{
+    PopulateData(layout, memory_ptr, BlockSet{}.set());
+}
 
-        if (boost::filesystem::exists(config.mld_storage_path))
-        {
-            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
-            BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
-
-            auto mld_cell_weights_ptr = layout.GetBlockPtr<EdgeWeight, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto mld_source_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
-            auto mld_destination_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto mld_cells_ptr = layout.GetBlockPtr<partition::CellStorageView::CellData, true>(
-                memory_ptr, storage::DataLayout::MLD_CELLS);
-            auto mld_cell_level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
-
-            auto weight_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto source_boundary_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
-            auto destination_boundary_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto cells_entries_counts = layout.GetBlockEntries(storage::DataLayout::MLD_CELLS);
-            auto cell_level_offsets_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
-
-            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
-            util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
-                                                      source_boundary_entries_count);
-            util::vector_view<NodeID> destination_boundary(mld_destination_boundary_ptr,
-                                                           destination_boundary_entries_count);
-            util::vector_view<partition::CellStorageView::CellData> cells(mld_cells_ptr,
-                                                                          cells_entries_counts);
-            util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
-                                                           cell_level_offsets_entries_count);
-
-            partition::CellStorageView storage{std::move(weights),
-                                               std::move(source_boundary),
-                                               std::move(destination_boundary),
-                                               std::move(cells),
-                                               std::move(level_offsets)};
-            partition::files::readCells(config.mld_storage_path, storage);
-        }
+void Storage::PopulateData(const DataLayout &layout, char *memory_ptr, const BlockSet &blocks)
+{
+    BOOST_ASSERT(memory_ptr != nullptr);
 
-        if (boost::filesystem::exists(config.mld_graph_path))
-        {
+    // read actual data into shared memory object //
+    auto tasks = MakeLoadTasks(layout, memory_ptr);
+    tasks.erase(std::remove_if(tasks.begin(),
+                               tasks.end(),
+                               [&](const LoadTask &task) {
+                                   return !isLoadedBy(task.blocks, blocks);
+                               }),
+                tasks.end());
+
+    // All tasks read from different files into disjoint blocks. The canaries of a block are
+    // verified as soon as its task is done, which overlaps with the I/O of the other tasks.
+    std::vector<LoadStatistics> statistics(tasks.size());
+    TIMER_START(populate);
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, tasks.size(), 1),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                const auto &task = tasks[index];
+                TIMER_START(task);
+                task.load();
+                for (const auto bid : task.blocks)
+                {
+                    layout.GetBlockPtr<char>(memory_ptr, bid);
+                    statistics[index].bytes += layout.GetBlockSize(bid);
+                }
+                TIMER_STOP(task);
+                statistics[index].milliseconds = TIMER_MSEC(task);
+            }
+        });
+    TIMER_STOP(populate);
 
-            auto graph_nodes_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::NodeArrayEntry, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_LIST);
-            auto graph_edges_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::EdgeArrayEntry, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
-            auto graph_node_to_offset_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::EdgeOffset, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
-
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::NodeArrayEntry> node_list(
-                graph_nodes_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::EdgeArrayEntry> edge_list(
-                graph_edges_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::EdgeOffset> node_to_offset(
-                graph_node_to_offset_ptr,
-                layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
-
-            customizer::MultiLevelEdgeBasedGraphView graph_view(
-                std::move(node_list), std::move(edge_list), std::move(node_to_offset));
-            partition::files::readGraph(config.mld_graph_path, graph_view);
-        }
+    const auto megabytes = [](const std::uint64_t bytes) { return bytes / (1024. * 1024.); };
+    std::uint64_t total_bytes = 0;
+    for (std::size_t index = 0; index < tasks.size(); ++index)
+    {
+        const auto &stats = statistics[index];
+        total_bytes += stats.bytes;
+        util::Log(logDEBUG) << "Loaded " << tasks[index].name << ": " << megabytes(stats.bytes)
+                            << " MB in " << stats.milliseconds << " ms ("
+                            << megabytes(stats.bytes) / std::max(stats.milliseconds, 1.) * 1000.
+                            << " MB/s)";
     }
+    util::Log() << "Loaded " << megabytes(total_bytes) << " MB of data in " << TIMER_SEC(populate)
+                << " seconds (" << tasks.size() << " parallel tasks)";
 }
 }
 }
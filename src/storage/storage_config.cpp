@@ -26,6 +26,7 @@ bool CheckFileList(const std::vector<boost::filesystem::path> &files)
 
 StorageConfig::StorageConfig(const boost::filesystem::path &base)
     : ram_index_path{base.string() + ".ramIndex"}, file_index_path{base.string() + ".fileIndex"},
+      snapping_grid_path{base.string() + ".grid"},
       hsgr_data_path{base.string() + ".hsgr"}, nodes_data_path{base.string() + ".nodes"},
       edges_data_path{base.string() + ".edges"}, core_data_path{base.string() + ".core"},
       geometries_path{base.string() + ".geometry"}, timestamp_path{base.string() + ".timestamp"},
@@ -36,7 +37,8 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       intersection_class_path{base.string() + ".icd"}, turn_lane_data_path{base.string() + ".tld"},
       turn_lane_description_path{base.string() + ".tls"},
       mld_partition_path{base.string() + ".partition"}, mld_storage_path{base.string() + ".cells"},
-      mld_graph_path{base.string() + ".mldgr"}
+      mld_graph_path{base.string() + ".mldgr"}, mld_overlay_path{base.string() + ".overlay"},
+      mmap_image_path{base.string() + ".mmap"}
 {
 }
 
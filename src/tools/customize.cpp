@@ -51,7 +51,12 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                            ->default_value(0.0),
                        "Use with `--segment-speed-file`. Provide an `x` factor, by which Extractor "
                        "will log edge "
-                       "weights updated by more than this factor");
+                       "weights updated by more than this factor")(
+            "overlay-graph",
+            boost::program_options::bool_switch(&customization_config.write_overlay_graph)
+                ->default_value(false),
+            "Write a query optimized overlay graph (.osrm.overlay) that stores the clique arcs "
+            "of all levels in contiguous memory");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
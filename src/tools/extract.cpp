@@ -46,6 +46,11 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
         "(affects nearest neighbor snapping)")(
+        "snapping-grid-cell-size",
+        boost::program_options::value<double>(&extractor_config.snapping_grid_cell_size)
+            ->default_value(0),
+        "Cell size in meters of the grid that speeds up snapping in dense areas, smaller cells "
+        "use more memory. 0 disables the grid.")(
         "with-osm-metadata",
         boost::program_options::bool_switch(&extractor_config.use_metadata)
             ->implicit_value(true)
@@ -1,3 +1,6 @@
+#include "storage/shared_datatype.hpp"
+#include "storage/storage.hpp"
+#include "storage/storage_config.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
@@ -6,6 +9,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <tbb/task_scheduler_init.h>
+
 #include <cmath>
 #include <cstdio>
 #include <fcntl.h>
@@ -16,6 +21,7 @@
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
+#include <memory>
 #include <numeric>
 #include <random>
 #include <vector>
@@ -45,6 +51,38 @@ void runStatistics(std::vector<double> &timings_vector, Statistics &stats)
         timings_vector.begin(), timings_vector.end(), timings_vector.begin(), 0.0);
     stats.dev = std::sqrt(primary_sq_sum / timings_vector.size() - (stats.mean * stats.mean));
 }
+
+// Loads a whole dataset the same way osrm-datastore does, but into process memory.
+// Flush the disk cache before running to measure cold loading.
+void runDatasetBenchmark(const boost::filesystem::path &base_path, const unsigned num_threads)
+{
+    storage::StorageConfig config(base_path);
+    if (!config.IsValid())
+    {
+        throw util::exception("Invalid file paths given for " + base_path.string() + SOURCE_REF);
+    }
+
+    tbb::task_scheduler_init init(num_threads);
+    storage::Storage storage(config);
+
+    storage::DataLayout layout;
+    TIMER_START(layout);
+    storage.PopulateLayout(layout);
+    TIMER_STOP(layout);
+
+    const auto size = layout.GetSizeOfLayout();
+    std::unique_ptr<char[]> memory(new char[size]);
+
+    TIMER_START(data);
+    storage.PopulateData(layout, memory.get());
+    TIMER_STOP(data);
+
+    const auto megabytes = size / (1024. * 1024.);
+    util::Log() << "reading layout took " << TIMER_MSEC(layout) << "ms";
+    util::Log() << "loading " << std::setprecision(5) << std::fixed << megabytes << "MB with "
+                << num_threads << " threads took " << TIMER_SEC(data) << "s";
+    util::Log() << "dataset load performance: " << megabytes / TIMER_SEC(data) << "MB/sec";
+}
 }
 }
 
@@ -66,9 +104,19 @@ int main(int argc, char *argv[])
     if (1 == argc)
     {
         osrm::util::Log(logWARNING) << "usage: " << argv[0] << " /path/on/device";
+        osrm::util::Log(logWARNING) << "       " << argv[0] << " data.osrm [threads]";
         return -1;
     }
 
+    // benchmark loading a dataset into memory
+    if (boost::filesystem::path(argv[1]).extension() == ".osrm")
+    {
+        const unsigned num_threads = argc > 2 ? std::stoul(argv[2])
+                                              : tbb::task_scheduler_init::default_num_threads();
+        osrm::tools::runDatasetBenchmark(argv[1], num_threads);
+        return EXIT_SUCCESS;
+    }
+
     test_path = boost::filesystem::path(argv[1]);
     test_path /= "osrm.tst";
     osrm::util::Log(logDEBUG) << "temporary file: " << test_path.string();
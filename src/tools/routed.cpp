@@ -1,6 +1,11 @@
+#include "server/api/url_parser.hpp"
 #include "server/server.hpp"
+#include "server/service_handler.hpp"
 #include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/json_container.hpp"
 #include "util/log.hpp"
+#include "util/string_util.hpp"
 #include "util/version.hpp"
 
 #include "osrm/engine_config.hpp"
@@ -17,6 +22,7 @@
 
 #include <chrono>
 #include <exception>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <memory>
@@ -60,6 +66,50 @@ EngineConfig::Algorithm stringToAlgorithm(const std::string &algorithm)
     throw util::exception("Invalid algorithm name: " + algorithm);
 }
 
+// Runs the recorded queries, one URL path per line, to warm up the dataset and the
+// query heaps before the server reports to be ready
+void replayQueries(server::ServiceHandler &service_handler, const boost::filesystem::path &path)
+{
+    std::ifstream queries(path.string());
+    if (!queries)
+    {
+        throw util::exception("Could not open " + path.string() + SOURCE_REF);
+    }
+
+    util::Log() << "Replaying queries from " << path;
+    const auto replay_start = std::chrono::steady_clock::now();
+
+    std::size_t num_succeeded = 0;
+    std::size_t num_failed = 0;
+    std::string line;
+    while (std::getline(queries, line))
+    {
+        if (line.empty())
+            continue;
+
+        std::string query;
+        util::URIDecode(line, query);
+        auto iter = query.begin();
+        auto parsed_url = server::api::parseURL(iter, query.end());
+
+        server::ServiceHandler::ResultT result;
+        if (parsed_url && iter == query.end() &&
+            service_handler.RunQuery(*std::move(parsed_url), result) == engine::Status::Ok)
+        {
+            ++num_succeeded;
+        }
+        else
+        {
+            ++num_failed;
+        }
+    }
+
+    const auto replay_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - replay_start);
+    util::Log() << "Replayed " << num_succeeded << " queries in " << replay_duration.count()
+                << "ms, " << num_failed << " failed";
+}
+
 // generate boost::program_options object for the routing part
 inline unsigned generateServerProgramOptions(const int argc,
                                              const char *argv[],
@@ -68,13 +118,22 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              int &requested_num_threads,
                                              bool &use_shared_memory,
+                                             bool &use_mmap,
+                                             bool &mmap_prefetch,
+                                             bool &prewarm,
+                                             bool &prewarm_lock,
+                                             bool &load_rtree_leaves,
+                                             bool &record_block_accesses,
+                                             bool &enable_admin,
+                                             boost::filesystem::path &prewarm_queries,
                                              std::string &algorithm,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             int &max_isochrone_duration)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -100,6 +159,32 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("mmap,m",
+         value<bool>(&use_mmap)->implicit_value(true)->default_value(false),
+         "Map data from a memory mapped image of the dataset instead of loading it") //
+        ("mmap-prefetch",
+         value<bool>(&mmap_prefetch)->implicit_value(true)->default_value(false),
+         "Prefetch the whole memory mapped image instead of paging it in on demand") //
+        ("prewarm",
+         value<bool>(&prewarm)->implicit_value(true)->default_value(false),
+         "Fault in the search graph, rtree and geometries before accepting requests") //
+        ("prewarm-lock",
+         value<bool>(&prewarm_lock)->implicit_value(true)->default_value(false),
+         "Prewarm and lock the search graph, rtree and geometries in RAM") //
+        ("load-rtree-leaves",
+         value<bool>(&load_rtree_leaves)->implicit_value(true)->default_value(false),
+         "Load the rtree leaves into memory with the dataset instead of memory mapping the "
+         ".fileIndex file. Data in shared memory uses the setting of osrm-datastore.") //
+        ("record-block-accesses",
+         value<bool>(&record_block_accesses)->implicit_value(true)->default_value(false),
+         "Sample the accesses to the blocks of the dataset for the memory usage report") //
+        ("enable-admin",
+         value<bool>(&enable_admin)->implicit_value(true)->default_value(false),
+         "Serve the admin service with the memory usage of the dataset. Don't expose the "
+         "port of an instance with this option publicly.") //
+        ("prewarm-queries",
+         value<boost::filesystem::path>(&prewarm_queries),
+         "Replay the queries of this file, one URL per line, before accepting requests") //
         ("algorithm,a",
          value<std::string>(&algorithm)->default_value("CH"),
          "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
@@ -117,7 +202,10 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("max-isochrone-duration",
+         value<int>(&max_isochrone_duration)->default_value(3600),
+         "Max. contour duration in seconds supported in isochrone query");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -167,6 +255,13 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (use_shared_memory && use_mmap)
+    {
+        util::Log(logWARNING) << "Shared memory settings conflict with memory mapping settings.";
+        std::cout << visible_options;
+        return INIT_OK_DO_NOT_START_ENGINE;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -189,11 +284,13 @@ int main(int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     bool trial_run = false;
+    bool enable_admin = false;
     std::string ip_address;
     int ip_port, requested_thread_num;
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    boost::filesystem::path prewarm_queries;
     std::string algorithm;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
@@ -202,13 +299,22 @@ int main(int argc, const char *argv[]) try
                                                               ip_port,
                                                               requested_thread_num,
                                                               config.use_shared_memory,
+                                                              config.use_mmap,
+                                                              config.mmap_prefetch,
+                                                              config.prewarm,
+                                                              config.prewarm_lock,
+                                                              config.load_rtree_leaves,
+                                                              config.record_block_accesses,
+                                                              enable_admin,
+                                                              prewarm_queries,
                                                               algorithm,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+                                                              config.max_results_nearest,
+                                                              config.max_isochrone_duration);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -304,7 +410,12 @@ int main(int argc, const char *argv[]) try
 #endif
 
     auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
-    auto service_handler = std::make_unique<server::ServiceHandler>(config);
+    auto service_handler = std::make_unique<server::ServiceHandler>(config, enable_admin);
+
+    if (!prewarm_queries.empty())
+    {
+        replayQueries(*service_handler, prewarm_queries);
+    }
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
@@ -1,3 +1,4 @@
+#include "storage/residency.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_monitor.hpp"
 #include "storage/storage.hpp"
@@ -6,14 +7,54 @@
 #include "util/typedefs.hpp"
 #include "util/version.hpp"
 
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <csignal>
+#include <cstdint>
 #include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace osrm;
 
+storage::HugePages stringToHugePages(const std::string &huge_pages)
+{
+    if (huge_pages == "none")
+        return storage::HugePages::None;
+    if (huge_pages == "2MB")
+        return storage::HugePages::Huge2MB;
+    if (huge_pages == "1GB")
+        return storage::HugePages::Huge1GB;
+    throw util::exception("Invalid huge page size: " + huge_pages);
+}
+
+std::vector<storage::DataLayout::BlockID> stringToBlocks(const std::string &blocks)
+{
+    std::vector<std::string> names;
+    boost::algorithm::split(names, blocks, boost::algorithm::is_any_of(","));
+
+    std::vector<storage::DataLayout::BlockID> block_ids;
+    for (const auto &name : names)
+    {
+        if (name.empty())
+            continue;
+
+        const auto begin = std::begin(storage::block_id_to_name);
+        const auto end = std::end(storage::block_id_to_name);
+        const auto iter = std::find(begin, end, name);
+        if (iter == end)
+            throw util::exception("Invalid block name: " + name);
+        block_ids.push_back(static_cast<storage::DataLayout::BlockID>(iter - begin));
+    }
+    return block_ids;
+}
+
 void removeLocks() { storage::SharedMonitor<storage::SharedDataTimestamp>::remove(); }
 
 void deleteRegion(const storage::SharedDataType region)
@@ -44,21 +85,76 @@ void springClean()
     {
         deleteRegion(storage::REGION_1);
         deleteRegion(storage::REGION_2);
+        deleteRegion(storage::REGION_3);
         removeLocks();
     }
 }
 
+// Size and resident size of every block of the dataset that is currently in use
+void reportMemory()
+{
+    storage::SharedMonitor<storage::SharedDataTimestamp> monitor(
+        storage::SharedDataTimestamp{storage::REGION_NONE, 0});
+    const auto region = monitor.data().region;
+    if (region == storage::REGION_NONE || !storage::SharedMemory::RegionExists(region))
+    {
+        util::Log(logWARNING) << "No dataset loaded";
+        return;
+    }
+
+    auto memory = storage::makeSharedMemory(region);
+    const auto &header = *static_cast<storage::SharedRegionHeader *>(memory->Ptr());
+    // blocks that are not part of an incremental update are stored in the base region
+    std::unique_ptr<storage::SharedMemory> base_memory;
+    if (header.IsIncremental())
+    {
+        base_memory = storage::makeSharedMemory(header.base_region);
+    }
+
+    util::Log() << "Blocks of " << storage::regionToString(region) << ":";
+    std::uint64_t total_size = 0;
+    std::uint64_t total_resident = 0;
+    for (auto index = 0; index < storage::DataLayout::NUM_BLOCKS; ++index)
+    {
+        const auto bid = static_cast<storage::DataLayout::BlockID>(index);
+        const auto &block_memory = header.HasBlock(bid) ? *memory : *base_memory;
+        const auto data = static_cast<const char *>(block_memory.Ptr());
+        const auto &layout = reinterpret_cast<const storage::SharedRegionHeader *>(data)->layout;
+
+        const auto block =
+            storage::getBlockMemory(layout, data + sizeof(storage::SharedRegionHeader), {bid})
+                .front();
+        const auto resident = storage::getResidentSize(block.begin, block.size);
+        util::Log() << "  " << storage::block_id_to_name[bid] << ": "
+                    << layout.num_entries[bid] << " entries, " << block.size << " bytes, "
+                    << resident << " bytes resident";
+
+        total_size += block.size;
+        total_resident += resident;
+    }
+    util::Log() << "Total: " << total_size << " bytes, " << total_resident << " bytes resident";
+}
+
 // generate boost::program_options object for the routing part
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              storage::SharedMemoryOptions &memory_options,
+                              bool &load_rtree_leaves,
+                              std::vector<storage::DataLayout::BlockID> &update_blocks)
 {
+    std::string huge_pages;
+    std::string blocks;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
         "remove-locks,r", "Remove locks")("spring-clean,s",
-                                          "Spring-cleaning all shared memory regions");
+                                          "Spring-cleaning all shared memory regions")(
+        "memory-report",
+        "Report the size and resident size of every block of the loaded dataset. Access "
+        "counts are reported by osrm-routed at /admin/v1/{profile}/memory");
 
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
@@ -66,7 +162,37 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()("max-wait",
                                  boost::program_options::value<int>(&max_wait)->default_value(-1),
                                  "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+                                 "before aquiring the lock by force and on clients that still "
+                                 "use the previous data. The waits are only bounded if this is "
+                                 "set, the default of -1 waits without a limit.")(
+        "huge-pages",
+        boost::program_options::value<std::string>(&huge_pages)->default_value("none"),
+        "Back the shared memory with huge pages of the given size: none, 2MB or 1GB. "
+        "The pages need to be reserved in advance (see vm.nr_hugepages).")(
+        "numa-interleave",
+        boost::program_options::value<bool>(&memory_options.numa_interleave)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Interleave the shared memory pages over all NUMA nodes")(
+        "prewarm",
+        boost::program_options::value<bool>(&memory_options.prewarm)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Touch the search graph, rtree and geometries before notifying clients and report "
+        "how much of each block is resident")(
+        "load-rtree-leaves",
+        boost::program_options::value<bool>(&load_rtree_leaves)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Load the rtree leaves into shared memory instead of memory mapping the .fileIndex "
+        "file in every client. With --huge-pages and --prewarm they are backed by huge pages "
+        "and touched before clients are notified.")(
+        "update-blocks",
+        boost::program_options::value<std::string>(&blocks),
+        "Comma separated list of blocks (e.g. MLD_CELL_WEIGHTS) to replace in the loaded "
+        "dataset. All other blocks are shared with the loaded dataset, so the data files "
+        "need to belong to the same extraction. The blocks written by osrm-customize are "
+        "always replaced together.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -135,8 +261,25 @@ bool generateDataStoreOptions(const int argc,
         return false;
     }
 
+    if (option_variables.count("memory-report"))
+    {
+        reportMemory();
+        return false;
+    }
+
     boost::program_options::notify(option_variables);
 
+    try
+    {
+        memory_options.huge_pages = stringToHugePages(huge_pages);
+        update_blocks = stringToBlocks(blocks);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return false;
+    }
+
     return true;
 }
 
@@ -158,7 +301,11 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    storage::SharedMemoryOptions memory_options;
+    bool load_rtree_leaves = false;
+    std::vector<storage::DataLayout::BlockID> update_blocks;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, max_wait, memory_options, load_rtree_leaves, update_blocks))
     {
         return EXIT_SUCCESS;
     }
@@ -168,9 +315,10 @@ int main(const int argc, const char *argv[]) try
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
-    storage::Storage storage(std::move(config));
+    config.load_rtree_leaves = load_rtree_leaves;
+    storage::Storage storage(std::move(config), memory_options);
 
-    return storage.Run(max_wait);
+    return storage.Run(max_wait, update_blocks);
 }
 catch (const std::bad_alloc &e)
 {
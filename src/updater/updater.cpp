@@ -164,6 +164,31 @@ updateSegmentData(const UpdaterConfig &config,
         return std::max(1, boost::numeric_cast<EdgeWeight>(std::round(weight * weight_multiplier)));
     };
 
+    // Segment values are bit packed in memory. Closed segments are marked with the invalid
+    // value, all other values are clipped below it like the extractor does.
+    std::atomic<std::uint32_t> clipped_weights{0};
+    std::atomic<std::uint32_t> clipped_durations{0};
+    auto toSegmentWeight = [&clipped_weights](const EdgeWeight weight) -> SegmentWeight {
+        if (weight == INVALID_EDGE_WEIGHT)
+            return INVALID_SEGMENT_WEIGHT;
+        if (weight >= static_cast<EdgeWeight>(INVALID_SEGMENT_WEIGHT))
+        {
+            ++clipped_weights;
+            return INVALID_SEGMENT_WEIGHT - 1;
+        }
+        return weight;
+    };
+    auto toSegmentDuration = [&clipped_durations](const EdgeWeight duration) -> SegmentDuration {
+        if (duration == MAXIMAL_EDGE_DURATION)
+            return INVALID_SEGMENT_DURATION;
+        if (duration >= static_cast<EdgeWeight>(INVALID_SEGMENT_DURATION))
+        {
+            ++clipped_durations;
+            return INVALID_SEGMENT_DURATION - 1;
+        }
+        return duration;
+    };
+
     // The check here is enabled by the `--edge-weight-updates-over-factor` flag it logs a
     // warning if the new duration exceeds a heuristic of what a reasonable duration update is
     std::unique_ptr<extractor::SegmentDataContainer> segment_data_backup;
@@ -206,8 +231,8 @@ updateSegmentData(const UpdaterConfig &config,
                     auto new_weight = convertToWeight(*value, segment_length);
                     fwd_was_updated = true;
 
-                    fwd_weights_range[segment_offset] = new_weight;
-                    fwd_durations_range[segment_offset] = new_duration;
+                    fwd_weights_range[segment_offset] = toSegmentWeight(new_weight);
+                    fwd_durations_range[segment_offset] = toSegmentDuration(new_duration);
                     fwd_datasources_range[segment_offset] = value->source;
                     counters[value->source] += 1;
                 }
@@ -239,8 +264,8 @@ updateSegmentData(const UpdaterConfig &config,
                     auto new_weight = convertToWeight(*value, segment_length);
                     rev_was_updated = true;
 
-                    rev_weights_range[segment_offset] = new_weight;
-                    rev_durations_range[segment_offset] = new_duration;
+                    rev_weights_range[segment_offset] = toSegmentWeight(new_weight);
+                    rev_durations_range[segment_offset] = toSegmentDuration(new_duration);
                     rev_datasources_range[segment_offset] = value->source;
                     counters[value->source] += 1;
                 }
@@ -286,6 +311,17 @@ updateSegmentData(const UpdaterConfig &config,
                               << "' profile";
     }
 
+    if (clipped_weights > 0)
+    {
+        util::Log(logWARNING) << "Clipped " << clipped_weights << " segment weights to "
+                              << (INVALID_SEGMENT_WEIGHT - 1);
+    }
+    if (clipped_durations > 0)
+    {
+        util::Log(logWARNING) << "Clipped " << clipped_durations << " segment durations to "
+                              << (INVALID_SEGMENT_DURATION - 1);
+    }
+
     if (config.log_edge_updates_factor > 0)
     {
         BOOST_ASSERT(segment_data_backup);
@@ -547,7 +583,7 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
             const auto weights = segment_data.GetForwardWeights(geometry_id.id);
             for (const auto weight : weights)
             {
-                if (weight == INVALID_EDGE_WEIGHT)
+                if (weight == INVALID_SEGMENT_WEIGHT)
                 {
                     new_weight = INVALID_EDGE_WEIGHT;
                     break;
@@ -562,7 +598,7 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
             const auto weights = segment_data.GetReverseWeights(geometry_id.id);
             for (const auto weight : weights)
             {
-                if (weight == INVALID_EDGE_WEIGHT)
+                if (weight == INVALID_SEGMENT_WEIGHT)
                 {
                     new_weight = INVALID_EDGE_WEIGHT;
                     break;
@@ -82,6 +82,33 @@ double greatCircleDistance(const Coordinate coordinate_1, const Coordinate coord
     return std::hypot(x_value, y_value) * detail::EARTH_RADIUS;
 }
 
+namespace
+{
+// Two passes, so at least the first one can be vectorized
+void squaredAnglesToDistances(const std::size_t count, double *distances)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        distances[index] = std::sqrt(distances[index]) * detail::EARTH_RADIUS;
+    }
+}
+}
+
+void approximateSegmentLengths(const Coordinate *coordinates,
+                               const std::size_t count,
+                               double *distances)
+{
+    if (count < 2)
+        return;
+
+    for (std::size_t index = 1; index < count; ++index)
+    {
+        distances[index - 1] =
+            detail::approximateSquaredAngle(coordinates[index - 1], coordinates[index]);
+    }
+    squaredAnglesToDistances(count - 1, distances);
+}
+
 double perpendicularDistance(const Coordinate segment_source,
                              const Coordinate segment_target,
                              const Coordinate query_location,
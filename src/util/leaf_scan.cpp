@@ -0,0 +1,368 @@
+#include "util/leaf_scan.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OSRM_LEAF_SCAN_X86
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace leaf_scan
+{
+
+static_assert(sizeof(FixedLongitude) == sizeof(std::int32_t), "FixedLongitude is not packed");
+static_assert(sizeof(FixedLatitude) == sizeof(std::int32_t), "FixedLatitude is not packed");
+
+namespace
+{
+// The fixed point components are read as plain integers by the kernels
+struct RawColumns
+{
+    explicit RawColumns(const SegmentColumns &segments)
+        : u_lons(reinterpret_cast<const std::int32_t *>(segments.u_lons)),
+          u_lats(reinterpret_cast<const std::int32_t *>(segments.u_lats)),
+          v_lons(reinterpret_cast<const std::int32_t *>(segments.v_lons)),
+          v_lats(reinterpret_cast<const std::int32_t *>(segments.v_lats)), count(segments.count)
+    {
+    }
+
+    const std::int32_t *u_lons;
+    const std::int32_t *u_lats;
+    const std::int32_t *v_lons;
+    const std::int32_t *v_lats;
+    std::uint32_t count;
+};
+
+struct RawRectangle
+{
+    explicit RawRectangle(const RectangleInt2D &rectangle)
+        : min_lon(static_cast<std::int32_t>(rectangle.min_lon)),
+          max_lon(static_cast<std::int32_t>(rectangle.max_lon)),
+          min_lat(static_cast<std::int32_t>(rectangle.min_lat)),
+          max_lat(static_cast<std::int32_t>(rectangle.max_lat))
+    {
+    }
+
+    std::int32_t min_lon;
+    std::int32_t max_lon;
+    std::int32_t min_lat;
+    std::int32_t max_lat;
+};
+
+// The vectorized kernels process the remaining segments with the scalar ones, so both start
+// at an arbitrary segment and append to the indices found so far.
+std::uint32_t findIntersectingScalar(const RawColumns &segments,
+                                     const RawRectangle &rectangle,
+                                     std::uint32_t first,
+                                     std::uint32_t num_found,
+                                     std::uint32_t *indices)
+{
+    for (auto i = first; i < segments.count; ++i)
+    {
+        const auto min_lon = std::min(segments.u_lons[i], segments.v_lons[i]);
+        const auto max_lon = std::max(segments.u_lons[i], segments.v_lons[i]);
+        const auto min_lat = std::min(segments.u_lats[i], segments.v_lats[i]);
+        const auto max_lat = std::max(segments.u_lats[i], segments.v_lats[i]);
+
+        // same test as RectangleInt2D::Intersects
+        const bool intersects = !(max_lon < rectangle.min_lon || min_lon > rectangle.max_lon ||
+                                  max_lat < rectangle.min_lat || min_lat > rectangle.max_lat);
+        indices[num_found] = i;
+        num_found += intersects;
+    }
+    return num_found;
+}
+
+void computeSquaredLowerBoundsScalar(const RawColumns &segments,
+                                     const std::int32_t lon,
+                                     const std::int32_t lat,
+                                     std::uint32_t first,
+                                     std::uint64_t *bounds)
+{
+    for (auto i = first; i < segments.count; ++i)
+    {
+        const auto min_lon = std::min(segments.u_lons[i], segments.v_lons[i]);
+        const auto max_lon = std::max(segments.u_lons[i], segments.v_lons[i]);
+        const auto min_lat = std::min(segments.u_lats[i], segments.v_lats[i]);
+        const auto max_lat = std::max(segments.u_lats[i], segments.v_lats[i]);
+
+        // projected coordinates are within [-180, 180] degrees, the differences fit into 32 bit
+        const auto d_lon = std::max(std::max(min_lon - lon, lon - max_lon), 0);
+        const auto d_lat = std::max(std::max(min_lat - lat, lat - max_lat), 0);
+
+        bounds[i] = static_cast<std::uint64_t>(d_lon) * static_cast<std::uint64_t>(d_lon) +
+                    static_cast<std::uint64_t>(d_lat) * static_cast<std::uint64_t>(d_lat);
+    }
+}
+
+#ifdef OSRM_LEAF_SCAN_X86
+// Appends the indices of the set bits of mask, offset by first
+inline std::uint32_t appendIndices(unsigned mask,
+                                   const std::uint32_t first,
+                                   std::uint32_t num_found,
+                                   std::uint32_t *indices)
+{
+    while (mask != 0)
+    {
+        indices[num_found++] = first + __builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+    return num_found;
+}
+
+__attribute__((target("sse4.1"))) std::uint32_t findIntersectingSSE41(
+    const RawColumns &segments, const RawRectangle &rectangle, std::uint32_t *indices)
+{
+    const auto rectangle_min_lon = _mm_set1_epi32(rectangle.min_lon);
+    const auto rectangle_max_lon = _mm_set1_epi32(rectangle.max_lon);
+    const auto rectangle_min_lat = _mm_set1_epi32(rectangle.min_lat);
+    const auto rectangle_max_lat = _mm_set1_epi32(rectangle.max_lat);
+
+    std::uint32_t num_found = 0;
+    std::uint32_t i = 0;
+    for (; i + 4 <= segments.count; i += 4)
+    {
+        const auto u_lons = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.u_lons + i));
+        const auto v_lons = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.v_lons + i));
+        const auto u_lats = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.u_lats + i));
+        const auto v_lats = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.v_lats + i));
+
+        const auto outside = _mm_or_si128(
+            _mm_or_si128(_mm_cmpgt_epi32(rectangle_min_lon, _mm_max_epi32(u_lons, v_lons)),
+                         _mm_cmpgt_epi32(_mm_min_epi32(u_lons, v_lons), rectangle_max_lon)),
+            _mm_or_si128(_mm_cmpgt_epi32(rectangle_min_lat, _mm_max_epi32(u_lats, v_lats)),
+                         _mm_cmpgt_epi32(_mm_min_epi32(u_lats, v_lats), rectangle_max_lat)));
+
+        const unsigned inside = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xFu;
+        num_found = appendIndices(inside, i, num_found, indices);
+    }
+
+    return findIntersectingScalar(segments, rectangle, i, num_found, indices);
+}
+
+__attribute__((target("sse4.1"))) void computeSquaredLowerBoundsSSE41(const RawColumns &segments,
+                                                                      const std::int32_t lon,
+                                                                      const std::int32_t lat,
+                                                                      std::uint64_t *bounds)
+{
+    const auto point_lon = _mm_set1_epi32(lon);
+    const auto point_lat = _mm_set1_epi32(lat);
+    const auto zero = _mm_setzero_si128();
+
+    std::uint32_t i = 0;
+    for (; i + 4 <= segments.count; i += 4)
+    {
+        const auto u_lons = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.u_lons + i));
+        const auto v_lons = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.v_lons + i));
+        const auto u_lats = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.u_lats + i));
+        const auto v_lats = _mm_loadu_si128(reinterpret_cast<const __m128i *>(segments.v_lats + i));
+
+        const auto d_lon =
+            _mm_max_epi32(_mm_max_epi32(_mm_sub_epi32(_mm_min_epi32(u_lons, v_lons), point_lon),
+                                        _mm_sub_epi32(point_lon, _mm_max_epi32(u_lons, v_lons))),
+                          zero);
+        const auto d_lat =
+            _mm_max_epi32(_mm_max_epi32(_mm_sub_epi32(_mm_min_epi32(u_lats, v_lats), point_lat),
+                                        _mm_sub_epi32(point_lat, _mm_max_epi32(u_lats, v_lats))),
+                          zero);
+
+        // the differences are non-negative, so the unsigned 32 x 32 -> 64 bit multiplication of
+        // the even lanes is exact. The odd lanes are shifted into the even ones.
+        const auto even = _mm_add_epi64(_mm_mul_epu32(d_lon, d_lon), _mm_mul_epu32(d_lat, d_lat));
+        const auto odd_lon = _mm_srli_epi64(d_lon, 32);
+        const auto odd_lat = _mm_srli_epi64(d_lat, 32);
+        const auto odd =
+            _mm_add_epi64(_mm_mul_epu32(odd_lon, odd_lon), _mm_mul_epu32(odd_lat, odd_lat));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bounds + i), _mm_unpacklo_epi64(even, odd));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bounds + i + 2),
+                         _mm_unpackhi_epi64(even, odd));
+    }
+
+    computeSquaredLowerBoundsScalar(segments, lon, lat, i, bounds);
+}
+
+__attribute__((target("avx2"))) std::uint32_t findIntersectingAVX2(
+    const RawColumns &segments, const RawRectangle &rectangle, std::uint32_t *indices)
+{
+    const auto rectangle_min_lon = _mm256_set1_epi32(rectangle.min_lon);
+    const auto rectangle_max_lon = _mm256_set1_epi32(rectangle.max_lon);
+    const auto rectangle_min_lat = _mm256_set1_epi32(rectangle.min_lat);
+    const auto rectangle_max_lat = _mm256_set1_epi32(rectangle.max_lat);
+
+    std::uint32_t num_found = 0;
+    std::uint32_t i = 0;
+    for (; i + 8 <= segments.count; i += 8)
+    {
+        const auto u_lons =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.u_lons + i));
+        const auto v_lons =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.v_lons + i));
+        const auto u_lats =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.u_lats + i));
+        const auto v_lats =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.v_lats + i));
+
+        const auto outside = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpgt_epi32(rectangle_min_lon, _mm256_max_epi32(u_lons, v_lons)),
+                _mm256_cmpgt_epi32(_mm256_min_epi32(u_lons, v_lons), rectangle_max_lon)),
+            _mm256_or_si256(
+                _mm256_cmpgt_epi32(rectangle_min_lat, _mm256_max_epi32(u_lats, v_lats)),
+                _mm256_cmpgt_epi32(_mm256_min_epi32(u_lats, v_lats), rectangle_max_lat)));
+
+        const unsigned inside = ~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xFFu;
+        num_found = appendIndices(inside, i, num_found, indices);
+    }
+
+    // the scalar code is not VEX encoded, avoid the transition penalty
+    _mm256_zeroupper();
+    return findIntersectingScalar(segments, rectangle, i, num_found, indices);
+}
+
+__attribute__((target("avx2"))) void computeSquaredLowerBoundsAVX2(const RawColumns &segments,
+                                                                   const std::int32_t lon,
+                                                                   const std::int32_t lat,
+                                                                   std::uint64_t *bounds)
+{
+    const auto point_lon = _mm256_set1_epi32(lon);
+    const auto point_lat = _mm256_set1_epi32(lat);
+    const auto zero = _mm256_setzero_si256();
+
+    std::uint32_t i = 0;
+    for (; i + 8 <= segments.count; i += 8)
+    {
+        const auto u_lons =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.u_lons + i));
+        const auto v_lons =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.v_lons + i));
+        const auto u_lats =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.u_lats + i));
+        const auto v_lats =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(segments.v_lats + i));
+
+        const auto d_lon = _mm256_max_epi32(
+            _mm256_max_epi32(_mm256_sub_epi32(_mm256_min_epi32(u_lons, v_lons), point_lon),
+                             _mm256_sub_epi32(point_lon, _mm256_max_epi32(u_lons, v_lons))),
+            zero);
+        const auto d_lat = _mm256_max_epi32(
+            _mm256_max_epi32(_mm256_sub_epi32(_mm256_min_epi32(u_lats, v_lats), point_lat),
+                             _mm256_sub_epi32(point_lat, _mm256_max_epi32(u_lats, v_lats))),
+            zero);
+
+        const auto even =
+            _mm256_add_epi64(_mm256_mul_epu32(d_lon, d_lon), _mm256_mul_epu32(d_lat, d_lat));
+        const auto odd_lon = _mm256_srli_epi64(d_lon, 32);
+        const auto odd_lat = _mm256_srli_epi64(d_lat, 32);
+        const auto odd = _mm256_add_epi64(_mm256_mul_epu32(odd_lon, odd_lon),
+                                          _mm256_mul_epu32(odd_lat, odd_lat));
+
+        // unpack interleaves within the 128 bit lanes: [0 1 | 4 5] and [2 3 | 6 7]
+        const auto low = _mm256_unpacklo_epi64(even, odd);
+        const auto high = _mm256_unpackhi_epi64(even, odd);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bounds + i),
+                            _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bounds + i + 4),
+                            _mm256_permute2x128_si256(low, high, 0x31));
+    }
+
+    _mm256_zeroupper();
+    computeSquaredLowerBoundsScalar(segments, lon, lat, i, bounds);
+}
+#endif
+
+Implementation detectImplementation()
+{
+#ifdef OSRM_LEAF_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return Implementation::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return Implementation::SSE41;
+#endif
+    return Implementation::Scalar;
+}
+}
+
+Implementation getImplementation()
+{
+    static const auto implementation = detectImplementation();
+    return implementation;
+}
+
+bool isSupported(const Implementation implementation)
+{
+    return static_cast<int>(implementation) <= static_cast<int>(getImplementation());
+}
+
+const char *toString(const Implementation implementation)
+{
+    switch (implementation)
+    {
+    case Implementation::AVX2:
+        return "avx2";
+    case Implementation::SSE41:
+        return "sse4.1";
+    case Implementation::Scalar:
+    default:
+        return "scalar";
+    }
+}
+
+std::uint32_t findIntersecting(const Implementation implementation,
+                               const SegmentColumns &segments,
+                               const RectangleInt2D &rectangle,
+                               std::uint32_t *indices)
+{
+    BOOST_ASSERT(isSupported(implementation));
+    const RawColumns columns{segments};
+    const RawRectangle raw_rectangle{rectangle};
+
+    switch (implementation)
+    {
+#ifdef OSRM_LEAF_SCAN_X86
+    case Implementation::AVX2:
+        return findIntersectingAVX2(columns, raw_rectangle, indices);
+    case Implementation::SSE41:
+        return findIntersectingSSE41(columns, raw_rectangle, indices);
+#endif
+    default:
+        return findIntersectingScalar(columns, raw_rectangle, 0, 0, indices);
+    }
+}
+
+void computeSquaredLowerBounds(const Implementation implementation,
+                               const SegmentColumns &segments,
+                               const Coordinate point,
+                               std::uint64_t *bounds)
+{
+    BOOST_ASSERT(isSupported(implementation));
+    const RawColumns columns{segments};
+    const auto lon = static_cast<std::int32_t>(point.lon);
+    const auto lat = static_cast<std::int32_t>(point.lat);
+
+    switch (implementation)
+    {
+#ifdef OSRM_LEAF_SCAN_X86
+    case Implementation::AVX2:
+        computeSquaredLowerBoundsAVX2(columns, lon, lat, bounds);
+        break;
+    case Implementation::SSE41:
+        computeSquaredLowerBoundsSSE41(columns, lon, lat, bounds);
+        break;
+#endif
+    default:
+        computeSquaredLowerBoundsScalar(columns, lon, lat, 0, bounds);
+        break;
+    }
+}
+}
+}
+}
@@ -0,0 +1,203 @@
+#include "util/relax_kernels.hpp"
+
+#include <limits>
+
+#if (defined(__clang__) || defined(__GNUC__)) && (defined(__x86_64__) || defined(__i386__))
+#define OSRM_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace simd
+{
+namespace detail
+{
+
+std::size_t filterValidWeightsScalar(const EdgeWeight *weights,
+                                     std::size_t count,
+                                     std::size_t stride,
+                                     EdgeWeight base,
+                                     EdgeWeight *candidates,
+                                     std::uint32_t *indices)
+{
+    std::size_t num_valid = 0;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const auto weight = weights[index * stride];
+        if (weight != INVALID_EDGE_WEIGHT)
+        {
+            candidates[num_valid] = base + weight;
+            indices[num_valid] = static_cast<std::uint32_t>(index);
+            ++num_valid;
+        }
+    }
+    return num_valid;
+}
+
+#ifdef OSRM_HAS_X86_KERNELS
+namespace
+{
+// Appends the lanes set in the valid mask to the compacted output
+inline std::size_t appendValidLanes(unsigned valid_mask,
+                                    const std::int32_t *sums,
+                                    std::size_t offset,
+                                    std::size_t num_valid,
+                                    EdgeWeight *candidates,
+                                    std::uint32_t *indices)
+{
+    while (valid_mask != 0)
+    {
+        const auto lane = __builtin_ctz(valid_mask);
+        candidates[num_valid] = sums[lane];
+        indices[num_valid] = static_cast<std::uint32_t>(offset + lane);
+        ++num_valid;
+        valid_mask &= valid_mask - 1;
+    }
+    return num_valid;
+}
+
+// Processes the remaining elements that do not fill a whole vector register
+inline std::size_t filterTail(const EdgeWeight *weights,
+                              std::size_t offset,
+                              std::size_t count,
+                              std::size_t stride,
+                              EdgeWeight base,
+                              std::size_t num_valid,
+                              EdgeWeight *candidates,
+                              std::uint32_t *indices)
+{
+    const auto num_tail = filterValidWeightsScalar(weights + offset * stride,
+                                                   count - offset,
+                                                   stride,
+                                                   base,
+                                                   candidates + num_valid,
+                                                   indices + num_valid);
+    for (std::size_t index = num_valid; index < num_valid + num_tail; ++index)
+    {
+        indices[index] += static_cast<std::uint32_t>(offset);
+    }
+    return num_valid + num_tail;
+}
+
+// Only rows are supported since SSE2 has no gather instruction. SSE2 is part of the
+// x86-64 baseline so this needs no runtime check.
+std::size_t filterValidWeightsSSE2(const EdgeWeight *weights,
+                                   std::size_t count,
+                                   std::size_t stride,
+                                   EdgeWeight base,
+                                   EdgeWeight *candidates,
+                                   std::uint32_t *indices)
+{
+    if (stride != 1)
+        return filterValidWeightsScalar(weights, count, stride, base, candidates, indices);
+
+    const __m128i invalid = _mm_set1_epi32(INVALID_EDGE_WEIGHT);
+    const __m128i base_vector = _mm_set1_epi32(base);
+    alignas(16) std::int32_t sums[4];
+
+    std::size_t num_valid = 0;
+    std::size_t offset = 0;
+    for (; offset + 4 <= count; offset += 4)
+    {
+        const __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + offset));
+        const __m128i is_invalid = _mm_cmpeq_epi32(row, invalid);
+        const unsigned valid_mask = ~_mm_movemask_ps(_mm_castsi128_ps(is_invalid)) & 0xFu;
+        if (valid_mask == 0)
+            continue;
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums), _mm_add_epi32(row, base_vector));
+        num_valid = appendValidLanes(valid_mask, sums, offset, num_valid, candidates, indices);
+    }
+
+    return filterTail(weights, offset, count, stride, base, num_valid, candidates, indices);
+}
+
+// Rows are loaded directly, columns of the weight matrix are fetched with a gather
+__attribute__((target("avx2"))) std::size_t filterValidWeightsAVX2(const EdgeWeight *weights,
+                                                                    std::size_t count,
+                                                                    std::size_t stride,
+                                                                    EdgeWeight base,
+                                                                    EdgeWeight *candidates,
+                                                                    std::uint32_t *indices)
+{
+    BOOST_ASSERT(stride * 8 < static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()));
+
+    const __m256i invalid = _mm256_set1_epi32(INVALID_EDGE_WEIGHT);
+    const __m256i base_vector = _mm256_set1_epi32(base);
+    const __m256i column_offsets =
+        _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                           _mm256_set1_epi32(static_cast<std::int32_t>(stride)));
+    alignas(32) std::int32_t sums[8];
+
+    std::size_t num_valid = 0;
+    std::size_t offset = 0;
+    for (; offset + 8 <= count; offset += 8)
+    {
+        const __m256i row =
+            stride == 1
+                ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + offset))
+                : _mm256_i32gather_epi32(weights + offset * stride, column_offsets, 4);
+        const __m256i is_invalid = _mm256_cmpeq_epi32(row, invalid);
+        const unsigned valid_mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(is_invalid)) & 0xFFu;
+        if (valid_mask == 0)
+            continue;
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(sums), _mm256_add_epi32(row, base_vector));
+        num_valid = appendValidLanes(valid_mask, sums, offset, num_valid, candidates, indices);
+    }
+
+    return filterTail(weights, offset, count, stride, base, num_valid, candidates, indices);
+}
+}
+
+FilterValidWeightsFn getFilterValidWeightsSSE2() { return &filterValidWeightsSSE2; }
+
+FilterValidWeightsFn getFilterValidWeightsAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? &filterValidWeightsAVX2 : nullptr;
+}
+#else
+FilterValidWeightsFn getFilterValidWeightsSSE2() { return nullptr; }
+FilterValidWeightsFn getFilterValidWeightsAVX2() { return nullptr; }
+#endif
+
+namespace
+{
+struct Kernel
+{
+    FilterValidWeightsFn filter;
+    const char *name;
+};
+
+const Kernel &getKernel()
+{
+    static const Kernel kernel = []() -> Kernel {
+        if (auto avx2 = getFilterValidWeightsAVX2())
+            return {avx2, "avx2"};
+        if (auto sse2 = getFilterValidWeightsSSE2())
+            return {sse2, "sse2"};
+        return {&filterValidWeightsScalar, "scalar"};
+    }();
+    return kernel;
+}
+}
+}
+
+std::size_t filterValidWeights(const EdgeWeight *weights,
+                               std::size_t count,
+                               std::size_t stride,
+                               EdgeWeight base,
+                               EdgeWeight *candidates,
+                               std::uint32_t *indices)
+{
+    return detail::getKernel().filter(weights, count, stride, base, candidates, indices);
+}
+
+std::string getKernelName() { return detail::getKernel().name; }
+}
+}
+}
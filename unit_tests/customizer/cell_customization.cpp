@@ -263,4 +263,52 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(2, 1).GetInWeight(12));
 }
 
+BOOST_AUTO_TEST_CASE(parallel_sources_test)
+{
+    // Two cells with 150 boundary nodes each, enough to customize the sources in parallel
+    const NodeID cell_size = 200;
+    const NodeID boundary_size = 150;
+
+    std::vector<CellID> l1(2 * cell_size);
+    std::fill(l1.begin() + cell_size, l1.end(), 1);
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges;
+    for (NodeID node = 0; node + 1 < cell_size; ++node)
+    {
+        // a ring inside each cell
+        edges.push_back({node, node + 1, 1});
+        edges.push_back({cell_size + node + 1, cell_size + node, 2});
+    }
+    edges.push_back({cell_size - 1, 0, 1});
+    edges.push_back({cell_size, 2 * cell_size - 1, 2});
+    for (NodeID node = 0; node < boundary_size; ++node)
+    {
+        edges.push_back({node, cell_size + node, 1});
+        edges.push_back({cell_size + node, node, 1});
+    }
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    CellCustomizer::Heap heap(graph.GetNumberOfNodes());
+    customizer.Customize(graph, heap, storage, 1, 0);
+    customizer.Customize(graph, heap, storage, 1, 1);
+
+    CellStorage storage_rec(mlp, graph);
+    customizer.Customize(graph, storage_rec);
+
+    for (CellID id = 0; id < 2; ++id)
+    {
+        const auto cell = storage.GetCell(1, id);
+        const auto cell_rec = storage_rec.GetCell(1, id);
+        REQUIRE_SIZE_RANGE(cell.GetSourceNodes(), boundary_size);
+        for (const auto source : cell.GetSourceNodes())
+        {
+            CHECK_EQUAL_COLLECTIONS(cell.GetOutWeight(source), cell_rec.GetOutWeight(source));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
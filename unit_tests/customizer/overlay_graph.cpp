@@ -0,0 +1,179 @@
+#include "common/range_tools.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include "customizer/cell_customizer.hpp"
+#include "customizer/overlay_graph.hpp"
+#include "partition/multi_level_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/static_graph.hpp"
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+using namespace osrm::util;
+
+namespace
+{
+struct MockEdge
+{
+    NodeID start;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+auto makeGraph(const MultiLevelPartition &mlp, const std::vector<MockEdge> &mock_edges)
+{
+    struct EdgeData
+    {
+        EdgeWeight weight;
+        bool forward;
+        bool backward;
+    };
+    using Edge = static_graph_details::SortableEdgeWithData<EdgeData>;
+    std::vector<Edge> edges;
+    std::size_t max_id = 0;
+    for (const auto &m : mock_edges)
+    {
+        max_id = std::max<std::size_t>(max_id, std::max(m.start, m.target));
+        edges.push_back(Edge{m.start, m.target, m.weight, true, false});
+        edges.push_back(Edge{m.target, m.start, m.weight, false, true});
+    }
+    std::sort(edges.begin(), edges.end());
+    return partition::MultiLevelGraph<EdgeData, osrm::storage::Ownership::Container>(
+        mlp, max_id + 1, edges);
+}
+
+struct Arc
+{
+    NodeID node;
+    EdgeWeight weight;
+
+    bool operator==(const Arc &other) const
+    {
+        return node == other.node && weight == other.weight;
+    }
+    bool operator!=(const Arc &other) const { return !(*this == other); }
+};
+
+std::ostream &operator<<(std::ostream &out, const Arc &arc)
+{
+    return out << "(" << arc.node << ", " << arc.weight << ")";
+}
+
+using Arcs = std::vector<Arc>;
+
+template <typename Range> Arcs toArcs(const Range &range)
+{
+    Arcs arcs;
+    for (const auto &arc : range)
+        arcs.push_back({arc.node, arc.weight});
+    return arcs;
+}
+
+template <typename Weights, typename Nodes>
+Arcs validArcs(const Weights &weights, const Nodes &nodes, NodeID node)
+{
+    Arcs arcs;
+    auto iter = nodes.begin();
+    for (const auto weight : weights)
+    {
+        const auto to = *iter++;
+        if (weight != INVALID_EDGE_WEIGHT && to != node)
+            arcs.push_back({to, weight});
+    }
+    return arcs;
+}
+
+// The overlay graph must contain exactly the valid non-loop entries of every cell row and column
+void checkOverlay(const MultiLevelPartition &mlp,
+                  const CellStorage &storage,
+                  const OverlayGraph &overlay)
+{
+    BOOST_REQUIRE(!overlay.Empty());
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = storage.GetCell(level, id);
+            const auto sources = cell.GetSourceNodes();
+            const auto destinations = cell.GetDestinationNodes();
+            for (const auto source : sources)
+            {
+                const auto expected = validArcs(cell.GetOutWeight(source), destinations, source);
+                const auto arcs = toArcs(overlay.GetOutArcs(level, id, source));
+                BOOST_CHECK_EQUAL_COLLECTIONS(
+                    arcs.begin(), arcs.end(), expected.begin(), expected.end());
+            }
+            for (const auto destination : destinations)
+            {
+                const auto expected =
+                    validArcs(cell.GetInWeight(destination), sources, destination);
+                const auto arcs = toArcs(overlay.GetInArcs(level, id, destination));
+                BOOST_CHECK_EQUAL_COLLECTIONS(
+                    arcs.begin(), arcs.end(), expected.begin(), expected.end());
+            }
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(overlay_graph_tests)
+
+BOOST_AUTO_TEST_CASE(two_level_test)
+{
+    // node:                0  1  2  3
+    std::vector<CellID> l1{{0, 0, 1, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {{0, 1, 1}, {0, 2, 1}, {2, 3, 1}, {3, 1, 1}, {3, 2, 1}};
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(graph, storage);
+
+    OverlayGraph overlay(mlp, storage);
+    checkOverlay(mlp, storage, overlay);
+
+    // self-loops on the diagonal of cell 1 are removed
+    const auto out_arcs = toArcs(overlay.GetOutArcs(1, 1, 2));
+    BOOST_REQUIRE_EQUAL(out_arcs.size(), 1);
+    BOOST_CHECK_EQUAL(out_arcs.front(), (Arc{3, 1}));
+    const auto in_arcs = toArcs(overlay.GetInArcs(1, 1, 2));
+    BOOST_REQUIRE_EQUAL(in_arcs.size(), 1);
+    BOOST_CHECK_EQUAL(in_arcs.front(), (Arc{3, 1}));
+    // not a boundary node of the cell
+    BOOST_CHECK(overlay.GetOutArcs(1, 0, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(three_level_test)
+{
+    // node:                0  1  2  3  4  5  6  7
+    std::vector<CellID> l1{{0, 0, 1, 1, 2, 2, 3, 3}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 1, 1, 1, 1}};
+    MultiLevelPartition mlp{{l1, l2}, {4, 2}};
+
+    BOOST_REQUIRE_EQUAL(mlp.GetNumberOfLevels(), 3);
+
+    // one directed edge 3 -> 4 leaves the left half, so some clique arcs stay invalid
+    std::vector<MockEdge> edges = {{0, 1, 1},
+                                   {1, 0, 1},
+                                   {1, 2, 2},
+                                   {2, 3, 1},
+                                   {3, 0, 5},
+                                   {3, 4, 3},
+                                   {4, 5, 1},
+                                   {5, 6, 2},
+                                   {6, 7, 1},
+                                   {7, 4, 4}};
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(graph, storage);
+
+    OverlayGraph overlay(mlp, storage);
+    checkOverlay(mlp, storage, overlay);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
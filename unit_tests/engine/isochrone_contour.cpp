@@ -0,0 +1,137 @@
+#include "engine/isochrone_contour.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <osrm/coordinate.hpp>
+
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(isochrone_contour_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+util::Coordinate makeCoordinate(const double lon, const double lat)
+{
+    return util::Coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}};
+}
+
+// Twice the signed area in fixed coordinates, positive for counter-clockwise rings
+double signedArea(const ContourRing &ring)
+{
+    double area = 0;
+    for (std::size_t index = 1; index < ring.size(); ++index)
+    {
+        area += static_cast<double>(static_cast<std::int32_t>(ring[index - 1].lon)) *
+                    static_cast<std::int32_t>(ring[index].lat) -
+                static_cast<double>(static_cast<std::int32_t>(ring[index].lon)) *
+                    static_cast<std::int32_t>(ring[index - 1].lat);
+    }
+    return area;
+}
+
+bool contains(const ContourRing &ring, const util::Coordinate coordinate)
+{
+    bool inside = false;
+    for (std::size_t index = 1; index < ring.size(); ++index)
+    {
+        const auto &from = ring[index - 1];
+        const auto &to = ring[index];
+        if ((from.lat > coordinate.lat) != (to.lat > coordinate.lat))
+        {
+            const auto factor = static_cast<double>(static_cast<std::int32_t>(coordinate.lat) -
+                                                    static_cast<std::int32_t>(from.lat)) /
+                                (static_cast<std::int32_t>(to.lat) -
+                                 static_cast<std::int32_t>(from.lat));
+            const auto lon = static_cast<std::int32_t>(from.lon) +
+                             factor * (static_cast<std::int32_t>(to.lon) -
+                                       static_cast<std::int32_t>(from.lon));
+            if (lon > static_cast<std::int32_t>(coordinate.lon))
+                inside = !inside;
+        }
+    }
+    return inside;
+}
+}
+
+BOOST_AUTO_TEST_CASE(empty_lines)
+{
+    BOOST_CHECK(traceContour({}).empty());
+    BOOST_CHECK(traceContour({{}}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(single_point)
+{
+    const auto polygons = traceContour({{makeCoordinate(7.42, 43.73)}});
+    BOOST_REQUIRE_EQUAL(polygons.size(), 1);
+    BOOST_REQUIRE_EQUAL(polygons[0].size(), 1);
+
+    // the grown cell is a square
+    const auto &ring = polygons[0][0];
+    BOOST_CHECK_EQUAL(ring.size(), 5);
+    BOOST_CHECK(ring.front() == ring.back());
+    BOOST_CHECK_GT(signedArea(ring), 0);
+    BOOST_CHECK(contains(ring, makeCoordinate(7.42, 43.73)));
+}
+
+BOOST_AUTO_TEST_CASE(line_is_covered)
+{
+    const std::vector<util::Coordinate> line = {
+        makeCoordinate(7.40, 43.72), makeCoordinate(7.43, 43.74), makeCoordinate(7.41, 43.75)};
+    const auto polygons = traceContour({line});
+    BOOST_REQUIRE_EQUAL(polygons.size(), 1);
+    BOOST_REQUIRE_EQUAL(polygons[0].size(), 1);
+
+    const auto &ring = polygons[0][0];
+    BOOST_CHECK(ring.front() == ring.back());
+    BOOST_CHECK_GT(signedArea(ring), 0);
+    for (const auto coordinate : line)
+        BOOST_CHECK(contains(ring, coordinate));
+    BOOST_CHECK(contains(ring, makeCoordinate(7.415, 43.73)));
+
+    // unlike a convex hull the area between the segments is not covered
+    BOOST_CHECK(!contains(ring, makeCoordinate(7.413, 43.737)));
+}
+
+BOOST_AUTO_TEST_CASE(loop_has_hole)
+{
+    const std::vector<util::Coordinate> loop = {makeCoordinate(7.40, 43.70),
+                                                makeCoordinate(7.45, 43.70),
+                                                makeCoordinate(7.45, 43.75),
+                                                makeCoordinate(7.40, 43.75),
+                                                makeCoordinate(7.40, 43.70)};
+    const auto polygons = traceContour({loop});
+    BOOST_REQUIRE_EQUAL(polygons.size(), 1);
+    BOOST_REQUIRE_EQUAL(polygons[0].size(), 2);
+
+    const auto &outer = polygons[0][0];
+    const auto &hole = polygons[0][1];
+    BOOST_CHECK_GT(signedArea(outer), 0);
+    BOOST_CHECK_LT(signedArea(hole), 0);
+    BOOST_CHECK(hole.front() == hole.back());
+
+    const auto center = makeCoordinate(7.425, 43.725);
+    BOOST_CHECK(contains(outer, center));
+    BOOST_CHECK(contains(hole, center));
+    BOOST_CHECK(!contains(hole, makeCoordinate(7.40, 43.725)));
+}
+
+BOOST_AUTO_TEST_CASE(separate_areas)
+{
+    const std::vector<util::Coordinate> small = {makeCoordinate(7.40, 43.70),
+                                                 makeCoordinate(7.40, 43.71)};
+    const std::vector<util::Coordinate> large = {makeCoordinate(7.45, 43.70),
+                                                 makeCoordinate(7.45, 43.75)};
+    const auto polygons = traceContour({small, large});
+    BOOST_REQUIRE_EQUAL(polygons.size(), 2);
+
+    // the largest area comes first
+    BOOST_CHECK(contains(polygons[0][0], makeCoordinate(7.45, 43.74)));
+    BOOST_CHECK(contains(polygons[1][0], makeCoordinate(7.40, 43.705)));
+    BOOST_CHECK(!contains(polygons[0][0], makeCoordinate(7.40, 43.705)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#include "engine/tile_edge_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(tile_edge_cache_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+TileEdgeCache::Edges makeEdges(const std::size_t count)
+{
+    return std::make_shared<const std::vector<TileEdgeCache::RTreeLeaf>>(count);
+}
+}
+
+BOOST_AUTO_TEST_CASE(finds_tile_and_parents)
+{
+    TileEdgeCache cache;
+    const TileEdgeCache::Dataset dataset{1, "2017-01-01"};
+
+    BOOST_CHECK(!cache.Find(dataset, 100, 200, 14).edges);
+
+    const auto edges = makeEdges(10);
+    cache.Insert(dataset, 100, 200, 14, edges);
+
+    const auto tile = cache.Find(dataset, 100, 200, 14);
+    BOOST_CHECK(tile.edges == edges);
+    BOOST_CHECK_EQUAL(tile.z, 14);
+
+    // the neighbour is not cached, but the children and grand children are
+    BOOST_CHECK(!cache.Find(dataset, 101, 200, 14).edges);
+    const auto child = cache.Find(dataset, 201, 400, 15);
+    BOOST_CHECK(child.edges == edges);
+    BOOST_CHECK_EQUAL(child.z, 14);
+    const auto grand_child = cache.Find(dataset, 403, 803, 16);
+    BOOST_CHECK(grand_child.edges == edges);
+    BOOST_CHECK_EQUAL(grand_child.z, 14);
+    BOOST_CHECK(!cache.Find(dataset, 807, 1607, 17).edges);
+
+    // the closest ancestor is used
+    const auto child_edges = makeEdges(3);
+    cache.Insert(dataset, 201, 400, 15, child_edges);
+    const auto from_child = cache.Find(dataset, 403, 801, 16);
+    BOOST_CHECK(from_child.edges == child_edges);
+    BOOST_CHECK_EQUAL(from_child.z, 15);
+}
+
+BOOST_AUTO_TEST_CASE(invalidated_by_dataset)
+{
+    TileEdgeCache cache;
+    const TileEdgeCache::Dataset dataset{1, "2017-01-01"};
+    cache.Insert(dataset, 100, 200, 14, makeEdges(10));
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 1);
+
+    const TileEdgeCache::Dataset updated{1, "2017-02-01"};
+    BOOST_CHECK(!cache.Find(updated, 100, 200, 14).edges);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 0);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfEdges(), 0);
+
+    cache.Insert(updated, 100, 200, 14, makeEdges(10));
+    const TileEdgeCache::Dataset other{2, "2017-02-01"};
+    BOOST_CHECK(!cache.Find(other, 100, 200, 14).edges);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    TileEdgeCache cache(25);
+    const TileEdgeCache::Dataset dataset{1, "2017-01-01"};
+
+    cache.Insert(dataset, 0, 0, 14, makeEdges(10));
+    cache.Insert(dataset, 1, 0, 14, makeEdges(10));
+    // the first tile is used again, so the second one is evicted
+    BOOST_CHECK(cache.Find(dataset, 0, 0, 14).edges);
+    cache.Insert(dataset, 2, 0, 14, makeEdges(10));
+
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 2);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfEdges(), 20);
+    BOOST_CHECK(cache.Find(dataset, 0, 0, 14).edges);
+    BOOST_CHECK(!cache.Find(dataset, 1, 0, 14).edges);
+    BOOST_CHECK(cache.Find(dataset, 2, 0, 14).edges);
+
+    // tiles with more edges than the cache holds are not stored
+    cache.Insert(dataset, 3, 0, 14, makeEdges(30));
+    BOOST_CHECK(!cache.Find(dataset, 3, 0, 14).edges);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfTiles(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+#include "extractor/serialization.hpp"
+
+#include "storage/io.hpp"
+#include "util/exception.hpp"
+#include "util/packed_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(serialization)
+
+using namespace osrm;
+
+const static std::string SEGMENT_VALUES_FILE = "segment_values_test.tmp";
+
+namespace
+{
+void writeValues(const std::vector<SegmentWeight> &values)
+{
+    storage::io::FileWriter writer(SEGMENT_VALUES_FILE,
+                                   storage::io::FileWriter::GenerateFingerprint);
+    extractor::serialization::writeSegmentValues(writer, values);
+}
+}
+
+BOOST_AUTO_TEST_CASE(read_packed_segment_values)
+{
+    const std::vector<SegmentWeight> values = {
+        0, 1, INVALID_SEGMENT_WEIGHT - 1, INVALID_SEGMENT_WEIGHT};
+    writeValues(values);
+
+    std::vector<std::uint64_t> blocks(
+        util::PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS>::elements_to_blocks(
+            values.size()));
+    util::PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS> packed;
+    packed.reset(blocks.data(), blocks.size());
+
+    storage::io::FileReader reader(SEGMENT_VALUES_FILE,
+                                   storage::io::FileReader::VerifyFingerprint);
+    extractor::serialization::readSegmentValues(reader, packed);
+    BOOST_CHECK_EQUAL_COLLECTIONS(packed.begin(), packed.end(), values.begin(), values.end());
+}
+
+BOOST_AUTO_TEST_CASE(reject_truncated_segment_values)
+{
+    writeValues({1, 1u << SEGMENT_WEIGHT_BITS});
+
+    std::vector<std::uint64_t> blocks(
+        util::PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS>::elements_to_blocks(2));
+    util::PackedVectorView<SegmentWeight, SEGMENT_WEIGHT_BITS> packed;
+    packed.reset(blocks.data(), blocks.size());
+
+    storage::io::FileReader reader(SEGMENT_VALUES_FILE,
+                                   storage::io::FileReader::VerifyFingerprint);
+    BOOST_CHECK_THROW(extractor::serialization::readSegmentValues(reader, packed),
+                      util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/isochrone_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(isochrone)
+
+void test_isochrone_response(const osrm::OSRM &osrm)
+{
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {60, 300};
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &waypoints = result.values.at("waypoints").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(waypoints.size(), 1);
+
+    const auto &isochrones = result.values.at("isochrones").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(isochrones.size(), params.contours.size());
+
+    std::size_t last_number_of_lines = 0;
+    for (std::size_t index = 0; index < isochrones.size(); ++index)
+    {
+        const auto &isochrone = isochrones[index].get<json::Object>();
+        const auto duration = isochrone.values.at("duration").get<json::Number>().value;
+        BOOST_CHECK_EQUAL(duration, params.contours[index]);
+
+        const auto &geometry = isochrone.values.at("geometry").get<json::Object>();
+        const auto type = geometry.values.at("type").get<json::String>().value;
+        BOOST_CHECK_EQUAL(type, "MultiLineString");
+
+        // larger contours contain all segments of smaller contours
+        const auto &lines = geometry.values.at("coordinates").get<json::Array>().values;
+        BOOST_CHECK(!lines.empty());
+        BOOST_CHECK(lines.size() >= last_number_of_lines);
+        last_number_of_lines = lines.size();
+
+        for (const auto &line : lines)
+            BOOST_CHECK(line.get<json::Array>().values.size() >= 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_response_ch)
+{
+    const auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    test_isochrone_response(osrm);
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_response_mld)
+{
+    const auto osrm =
+        getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+    test_isochrone_response(osrm);
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_polygon_response)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {300};
+    params.polygons = true;
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto &isochrones = result.values.at("isochrones").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(isochrones.size(), 1);
+
+    const auto &geometry =
+        isochrones.front().get<json::Object>().values.at("geometry").get<json::Object>();
+    const auto type = geometry.values.at("type").get<json::String>().value;
+    BOOST_CHECK_EQUAL(type, "MultiPolygon");
+
+    const auto &polygons = geometry.values.at("coordinates").get<json::Array>().values;
+    BOOST_REQUIRE(!polygons.empty());
+    for (const auto &polygon : polygons)
+    {
+        const auto &rings = polygon.get<json::Array>().values;
+        BOOST_REQUIRE(!rings.empty());
+        for (const auto &ring_value : rings)
+        {
+            const auto &ring = ring_value.get<json::Array>().values;
+            BOOST_REQUIRE(ring.size() >= 4);
+
+            // rings are closed
+            const auto &first = ring.front().get<json::Array>().values;
+            const auto &last = ring.back().get<json::Array>().values;
+            BOOST_CHECK_EQUAL(first[0].get<json::Number>().value,
+                              last[0].get<json::Number>().value);
+            BOOST_CHECK_EQUAL(first[1].get<json::Number>().value,
+                              last[1].get<json::Number>().value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_response_multiple_coordinates)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {300};
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Error);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "InvalidOptions");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
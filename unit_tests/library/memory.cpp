@@ -0,0 +1,79 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/nearest_parameters.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_AUTO_TEST_CASE(test_memory_usage_response)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.record_block_accesses = true;
+    OSRM osrm{config};
+
+    // queries increase the sampled access counts
+    for (auto query = 0; query < 1000; ++query)
+    {
+        NearestParameters params;
+        params.coordinates.push_back(get_dummy_location());
+        json::Object result;
+        BOOST_REQUIRE(osrm.Nearest(params, result) == Status::Ok);
+    }
+
+    json::Object result;
+    const auto rc = osrm.MemoryUsage(result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &blocks = result.values.at("blocks").get<json::Array>().values;
+    BOOST_REQUIRE(!blocks.empty());
+
+    double total_size = 0;
+    double total_accesses = 0;
+    for (const auto &block : blocks)
+    {
+        const auto &entry = block.get<json::Object>();
+        const auto size = entry.values.at("size").get<json::Number>().value;
+        const auto resident = entry.values.at("resident").get<json::Number>().value;
+        BOOST_CHECK(resident <= size);
+        total_size += size;
+        total_accesses += entry.values.at("accesses").get<json::Number>().value;
+    }
+    BOOST_CHECK_EQUAL(total_size, result.values.at("size").get<json::Number>().value);
+    BOOST_CHECK(total_accesses > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_usage_without_access_counts)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    json::Object result;
+    const auto rc = osrm.MemoryUsage(result);
+    BOOST_REQUIRE(rc == Status::Ok);
+    BOOST_CHECK(result.values.count("access_sample_rate") == 0);
+
+    const auto &blocks = result.values.at("blocks").get<json::Array>().values;
+    BOOST_REQUIRE(!blocks.empty());
+    for (const auto &block : blocks)
+    {
+        BOOST_CHECK(block.get<json::Object>().values.count("accesses") == 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,8 @@
 
 #include "osrm/osrm.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 BOOST_AUTO_TEST_SUITE(options)
 
 BOOST_AUTO_TEST_CASE(test_ch)
@@ -39,4 +41,52 @@ BOOST_AUTO_TEST_CASE(test_mld)
     OSRM osrm{config};
 }
 
+BOOST_AUTO_TEST_CASE(test_mmap)
+{
+    using namespace osrm;
+    EngineConfig config;
+    config.use_shared_memory = false;
+    config.use_mmap = true;
+    config.storage_config = storage::StorageConfig(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    config.algorithm = EngineConfig::Algorithm::CH;
+    // the first instance writes the image, the second one maps the existing image
+    OSRM first{config};
+    OSRM second{config};
+    BOOST_CHECK(boost::filesystem::exists(config.storage_config.mmap_image_path));
+}
+
+BOOST_AUTO_TEST_CASE(test_mmap_replaced_input)
+{
+    using namespace osrm;
+    EngineConfig config;
+    config.use_shared_memory = false;
+    config.use_mmap = true;
+    config.storage_config = storage::StorageConfig(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    config.algorithm = EngineConfig::Algorithm::CH;
+    {
+        OSRM osrm{config};
+    }
+
+    // keeps the current image alive, the new one is renamed over the image path
+    const auto &image_path = config.storage_config.mmap_image_path;
+    const boost::filesystem::path previous_image_path = image_path.string() + ".previous";
+    boost::filesystem::remove(previous_image_path);
+    boost::filesystem::create_hard_link(image_path, previous_image_path);
+
+    // replace an input like `cp -p` does, with the same content and modification time
+    const auto &input_path = config.storage_config.timestamp_path;
+    const boost::filesystem::path copy_path = input_path.string() + ".copy";
+    const auto modified = boost::filesystem::last_write_time(input_path);
+    boost::filesystem::copy_file(
+        input_path, copy_path, boost::filesystem::copy_option::overwrite_if_exists);
+    boost::filesystem::last_write_time(copy_path, modified);
+    boost::filesystem::rename(copy_path, input_path);
+
+    {
+        OSRM osrm{config};
+    }
+    BOOST_CHECK(!boost::filesystem::equivalent(image_path, previous_image_path));
+    boost::filesystem::remove(previous_image_path);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
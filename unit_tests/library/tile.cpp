@@ -211,11 +211,10 @@ BOOST_AUTO_TEST_CASE(test_tile)
     BOOST_CHECK(number_of_turns_found > 700);
 }
 
-BOOST_AUTO_TEST_CASE(test_tile_turns)
+void test_tile_turns(const osrm::OSRM &osrm)
 {
     using namespace osrm;
 
-    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
     // Small tile where we can test all the values
     TileParameters params{272953, 191177, 19};
 
@@ -359,6 +358,22 @@ BOOST_AUTO_TEST_CASE(test_tile_turns)
     CHECK_EQUAL_RANGE(actual_turn_bearings, expected_turn_bearings);
 }
 
+BOOST_AUTO_TEST_CASE(test_tile_turns_ch)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+    test_tile_turns(osrm);
+}
+
+BOOST_AUTO_TEST_CASE(test_tile_turns_mld)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD);
+    test_tile_turns(osrm);
+}
+
 BOOST_AUTO_TEST_CASE(test_tile_speeds)
 {
     using namespace osrm;
@@ -42,40 +42,45 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return 0;
     }
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override
     {
-        return {};
+        return NodeReverseRange(GetUncompressedForwardGeometry(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID /* id */) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        // a single segment with weight 1
+        static std::uint64_t data[] = {std::uint64_t{1} << (64 - SEGMENT_WEIGHT_BITS)};
+        static const auto weights = [] {
+            extractor::SegmentDataView::SegmentWeightVector weights;
+            weights.reset(data, 1);
+            weights.set_number_of_entries(1);
+            return weights;
+        }();
+        return WeightForwardRange(weights.begin(), weights.end());
     }
-    std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const override
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return WeightReverseRange(GetUncompressedForwardWeights(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardDurations(const EdgeID id) const override
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override
     {
         return GetUncompressedForwardWeights(id);
     }
-    std::vector<EdgeWeight> GetUncompressedReverseDurations(const EdgeID id) const override
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return DurationReverseRange(GetUncompressedForwardDurations(id));
     }
-    std::vector<DatasourceID> GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
     {
         return {};
     }
-    std::vector<DatasourceID> GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override
     {
-        return {};
+        return DatasourceReverseRange(GetUncompressedForwardDatasources(id));
     }
 
     StringView GetDatasourceName(const DatasourceID) const override final { return {}; }
@@ -94,6 +99,13 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return {};
     }
+    std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate /* south_west */,
+                                         const util::Coordinate /*north_east */,
+                                         const std::vector<RTreeLeaf> & /* candidates */) const
+        override
+    {
+        return {};
+    }
 
     std::vector<engine::PhantomNodeWithDistance>
     NearestPhantomNodesInRange(const util::Coordinate /*input_coordinate*/,
@@ -176,6 +188,26 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::vector<engine::PhantomNodeWithDistance>> NearestPhantomNodesInRange(
+        const std::vector<engine::PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::vector<engine::PhantomNodeWithDistance>>(queries.size());
+    }
+
+    std::vector<std::vector<engine::PhantomNodeWithDistance>>
+    NearestPhantomNodes(const std::vector<engine::PhantomNodeQuery> &queries,
+                        const unsigned /*max_results*/) const override
+    {
+        return std::vector<std::vector<engine::PhantomNodeWithDistance>>(queries.size());
+    }
+
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodeWithAlternativeFromBigComponent(
+        const std::vector<engine::PhantomNodeQuery> &queries) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(queries.size());
+    }
+
     unsigned GetCheckSum() const override { return 0; }
 
     NameID GetNameIndexFromEdgeID(const EdgeID /* id */) const override { return 0; }
@@ -3,6 +3,7 @@
 #include "parameters_io.hpp"
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -481,6 +482,48 @@ BOOST_AUTO_TEST_CASE(valid_nearest_urls)
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
 }
 
+BOOST_AUTO_TEST_CASE(invalid_isochrone_urls)
+{
+    BOOST_CHECK_EQUAL(testInvalidOptions<IsochroneParameters>("1,2?contours=a"), 13UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<IsochroneParameters>("1,2?polygons=foo"), 13UL);
+
+    auto result_1 = parseParameters<IsochroneParameters>("1,2");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(!result_1->IsValid());
+
+    auto result_2 = parseParameters<IsochroneParameters>("1,2?contours=300;-60");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(!result_2->IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(valid_isochrone_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}}};
+
+    IsochroneParameters reference_1{};
+    reference_1.coordinates = coords_1;
+    reference_1.contours = {300, 600.5};
+    auto result_1 = parseParameters<IsochroneParameters>("1,2?contours=300;600.5");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    BOOST_CHECK_EQUAL(reference_1.polygons, result_1->polygons);
+    CHECK_EQUAL_RANGE(reference_1.contours, result_1->contours);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_1->coordinates);
+
+    IsochroneParameters reference_2{};
+    reference_2.coordinates = coords_1;
+    reference_2.contours = {900};
+    reference_2.polygons = true;
+    auto result_2 = parseParameters<IsochroneParameters>("1,2?contours=900&polygons=true");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(result_2->IsValid());
+    BOOST_CHECK_EQUAL(reference_2.polygons, result_2->polygons);
+    CHECK_EQUAL_RANGE(reference_2.contours, result_2->contours);
+    CHECK_EQUAL_RANGE(reference_2.bearings, result_2->bearings);
+    CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
+    CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+}
+
 BOOST_AUTO_TEST_CASE(invalid_tile_urls)
 {
     TileParameters reference_1{1, 2, 3};
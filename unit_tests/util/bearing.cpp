@@ -47,4 +47,37 @@ BOOST_AUTO_TEST_CASE(bearing_range_test)
     BOOST_CHECK_EQUAL(true, bearing::CheckInBounds(1, 1, 0));
 }
 
+BOOST_AUTO_TEST_CASE(bucket_mask_test)
+{
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(0), 0x01);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(44), 0x01);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(45), 0x02);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(359), 0x80);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(360), 0x01);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(-1), 0x80);
+
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(45, 10), 0x03);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(100, 10), 0x04);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(0, 10), 0x81);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(355, 10), 0x81);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(0, 180), bearing::ALL_BUCKETS);
+    BOOST_CHECK_EQUAL(bearing::toBucketMask(0, -1), 0);
+
+    // the mask of a window has to contain every bearing in the window
+    for (int B = -360; B < 720; B += 7)
+    {
+        for (int range = 0; range <= 180; range += 3)
+        {
+            const auto mask = bearing::toBucketMask(B, range);
+            for (int A = 0; A < 360; ++A)
+            {
+                if (bearing::CheckInBounds(A, B, range))
+                {
+                    BOOST_CHECK((bearing::toBucketMask(A) & mask) != 0);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
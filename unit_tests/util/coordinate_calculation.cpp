@@ -8,6 +8,8 @@
 #include <osrm/coordinate.hpp>
 
 #include <cmath>
+#include <random>
+#include <vector>
 
 using namespace osrm;
 using namespace osrm::util;
@@ -405,4 +407,39 @@ BOOST_AUTO_TEST_CASE(regression_test_3516)
     BOOST_CHECK_EQUAL(nearest_location, v);
 }
 
+BOOST_AUTO_TEST_CASE(approximate_distance)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> lon_dist(-180000000, 180000000);
+    std::uniform_int_distribution<std::int32_t> lat_dist(-80000000, 80000000);
+    // up to about 100km
+    std::uniform_int_distribution<std::int32_t> step_dist(-600000, 600000);
+
+    std::vector<Coordinate> coordinates;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto lat = lat_dist(generator);
+        coordinates.push_back(Coordinate{FixedLongitude{lon_dist(generator)}, FixedLatitude{lat}});
+        // wraps around the antimeridian for some of the pairs
+        auto lon = static_cast<std::int32_t>(coordinates.back().lon) + step_dist(generator);
+        lon = lon > 180000000 ? lon - 360000000 : (lon < -180000000 ? lon + 360000000 : lon);
+        coordinates.push_back(
+            Coordinate{FixedLongitude{lon}, FixedLatitude{lat + step_dist(generator) / 10}});
+    }
+
+    std::vector<double> lengths(coordinates.size() - 1);
+    coordinate_calculation::approximateSegmentLengths(
+        coordinates.data(), coordinates.size(), lengths.data());
+
+    for (std::size_t index = 1; index < coordinates.size(); index += 2)
+    {
+        const auto &first = coordinates[index - 1];
+        const auto &second = coordinates[index];
+        const auto exact = coordinate_calculation::haversineDistance(first, second);
+        const auto approximate = coordinate_calculation::approximateDistance(first, second);
+        BOOST_CHECK_LE(std::abs(approximate - exact), exact * 1e-4);
+        BOOST_CHECK_CLOSE(lengths[index - 1], approximate, 1e-9);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,3 +1,4 @@
+#include "storage/container.hpp"
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
 #include "util/exception.hpp"
@@ -19,6 +20,7 @@ const static std::string IO_CORRUPT_FINGERPRINT_FILE = "corrupt_fingerprint_file
 const static std::string IO_INCOMPATIBLE_FINGERPRINT_FILE =
     "incompatible_fingerprint_file_test_io.tmp";
 const static std::string IO_TEXT_FILE = "plain_text_file.tmp";
+const static std::string IO_CONTAINER_FILE = "container_test_io.tmp";
 
 BOOST_AUTO_TEST_SUITE(osrm_io)
 
@@ -180,4 +182,91 @@ BOOST_AUTO_TEST_CASE(io_read_lines)
     }
 }
 
+BOOST_AUTO_TEST_CASE(io_container_sections)
+{
+    std::vector<int> ints(53);
+    std::iota(begin(ints), end(ints), 0);
+    std::vector<char> chars = {'a', 'b', 'c'};
+    const std::uint64_t number = 42;
+
+    {
+        osrm::storage::container::FileWriter outfile(IO_CONTAINER_FILE);
+        outfile.WriteFrom("/test/chars", chars);
+        outfile.WriteFrom("/test/ints", ints);
+        outfile.WriteFrom("/test/number", number);
+        outfile.Finish();
+    }
+
+    osrm::storage::container::FileReader infile(IO_CONTAINER_FILE);
+    BOOST_CHECK(infile.HasSection("/test/ints"));
+    BOOST_CHECK(!infile.HasSection("/test/missing"));
+    BOOST_CHECK_EQUAL(infile.GetElementCount("/test/ints"), ints.size());
+    BOOST_CHECK_EQUAL(infile.GetElementCount("/test/chars"), chars.size());
+    BOOST_CHECK_EQUAL(infile.GetOffset("/test/ints") % osrm::storage::container::SECTION_ALIGNMENT,
+                      0);
+
+    // sections can be read in any order
+    std::uint64_t number_out = 0;
+    infile.ReadInto("/test/number", number_out);
+    BOOST_CHECK_EQUAL(number_out, number);
+
+    std::vector<int> ints_out;
+    infile.ReadInto("/test/ints", ints_out);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ints_out.begin(), ints_out.end(), ints.begin(), ints.end());
+
+    std::vector<char> chars_out(chars.size());
+    osrm::util::vector_view<char> chars_view(chars_out.data(), chars_out.size());
+    infile.ReadInto("/test/chars", chars_view);
+    BOOST_CHECK_EQUAL_COLLECTIONS(chars_out.begin(), chars_out.end(), chars.begin(), chars.end());
+
+    std::vector<std::uint64_t> wrong_type;
+    BOOST_CHECK_THROW(infile.ReadInto("/test/ints", wrong_type), osrm::util::exception);
+    BOOST_CHECK_THROW(infile.ReadInto("/test/missing", ints_out), osrm::util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(io_container_checksum)
+{
+    std::vector<int> ints(53);
+    std::iota(begin(ints), end(ints), 0);
+
+    std::uint64_t offset = 0;
+    {
+        osrm::storage::container::FileWriter outfile(IO_CONTAINER_FILE);
+        outfile.WriteFrom("/test/ints", ints);
+        outfile.Finish();
+    }
+    {
+        osrm::storage::container::FileReader infile(IO_CONTAINER_FILE);
+        offset = infile.GetOffset("/test/ints");
+    }
+    {
+        std::fstream f(IO_CONTAINER_FILE);
+        f.seekp(offset, std::ios_base::beg);
+        const int corrupt = -1;
+        f.write(reinterpret_cast<const char *>(&corrupt), sizeof(corrupt));
+    }
+
+    std::vector<int> ints_out;
+    osrm::storage::container::FileReader infile(IO_CONTAINER_FILE);
+    BOOST_CHECK_THROW(infile.ReadInto("/test/ints", ints_out), osrm::util::exception);
+
+    osrm::storage::container::FileReader unchecked_infile(
+        IO_CONTAINER_FILE, osrm::storage::container::FileReader::SkipChecksum);
+    unchecked_infile.ReadInto("/test/ints", ints_out);
+    BOOST_CHECK_EQUAL(ints_out.front(), -1);
+}
+
+BOOST_AUTO_TEST_CASE(io_container_unfinished)
+{
+    std::vector<int> ints(53);
+    {
+        osrm::storage::container::FileWriter outfile(IO_CONTAINER_FILE);
+        outfile.WriteFrom("/test/ints", ints);
+    }
+
+    // the header is only written by Finish
+    BOOST_CHECK_THROW(osrm::storage::container::FileReader{IO_CONTAINER_FILE},
+                      osrm::util::exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
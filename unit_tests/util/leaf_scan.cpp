@@ -0,0 +1,172 @@
+#include "util/leaf_scan.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(leaf_scan_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+struct RandomSegments
+{
+    // counts that are not multiples of the vector width test the scalar tail
+    RandomSegments(const std::uint32_t count, std::mt19937 &generator)
+    {
+        // small extent, so a good share of the segments intersect the rectangles
+        std::uniform_int_distribution<std::int32_t> lon_dist(-1000000, 1000000);
+        std::uniform_int_distribution<std::int32_t> lat_dist(-1000000, 1000000);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            u_lons.push_back(FixedLongitude{lon_dist(generator)});
+            u_lats.push_back(FixedLatitude{lat_dist(generator)});
+            v_lons.push_back(FixedLongitude{lon_dist(generator)});
+            v_lats.push_back(FixedLatitude{lat_dist(generator)});
+        }
+    }
+
+    leaf_scan::SegmentColumns Columns() const
+    {
+        return {u_lons.data(),
+                u_lats.data(),
+                v_lons.data(),
+                v_lats.data(),
+                static_cast<std::uint32_t>(u_lons.size())};
+    }
+
+    RectangleInt2D BoundingBox(const std::uint32_t i) const
+    {
+        return {std::min(u_lons[i], v_lons[i]),
+                std::max(u_lons[i], v_lons[i]),
+                std::min(u_lats[i], v_lats[i]),
+                std::max(u_lats[i], v_lats[i])};
+    }
+
+    std::vector<FixedLongitude> u_lons;
+    std::vector<FixedLatitude> u_lats;
+    std::vector<FixedLongitude> v_lons;
+    std::vector<FixedLatitude> v_lats;
+};
+
+const std::vector<leaf_scan::Implementation> implementations = {
+    leaf_scan::Implementation::Scalar,
+    leaf_scan::Implementation::SSE41,
+    leaf_scan::Implementation::AVX2};
+}
+
+BOOST_AUTO_TEST_CASE(intersecting_matches_rectangle)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> dist(-1200000, 1200000);
+
+    for (const std::uint32_t count : {0u, 1u, 3u, 4u, 7u, 8u, 13u, 64u, 85u})
+    {
+        const RandomSegments segments(count, generator);
+        for (int query = 0; query < 20; ++query)
+        {
+            const auto lon = dist(generator);
+            const auto lat = dist(generator);
+            const RectangleInt2D rectangle{FixedLongitude{lon},
+                                           FixedLongitude{lon + 300000},
+                                           FixedLatitude{lat},
+                                           FixedLatitude{lat + 300000}};
+
+            std::vector<std::uint32_t> expected;
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (segments.BoundingBox(i).Intersects(rectangle))
+                    expected.push_back(i);
+            }
+
+            for (const auto implementation : implementations)
+            {
+                if (!leaf_scan::isSupported(implementation))
+                    continue;
+
+                BOOST_TEST_CONTEXT(leaf_scan::toString(implementation) << " " << count)
+                {
+                    std::vector<std::uint32_t> indices(count);
+                    const auto num_found = leaf_scan::findIntersecting(
+                        implementation, segments.Columns(), rectangle, indices.data());
+                    indices.resize(num_found);
+                    BOOST_CHECK_EQUAL_COLLECTIONS(
+                        indices.begin(), indices.end(), expected.begin(), expected.end());
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lower_bounds_match_rectangle)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<std::int32_t> dist(-180000000, 180000000);
+
+    for (const std::uint32_t count : {0u, 1u, 3u, 4u, 7u, 8u, 13u, 64u, 85u})
+    {
+        const RandomSegments segments(count, generator);
+        for (int query = 0; query < 20; ++query)
+        {
+            // alternate between points far away and points among the segments
+            const auto scale = query % 2 == 0 ? 1 : 200;
+            const Coordinate point{FixedLongitude{dist(generator) / scale},
+                                   FixedLatitude{dist(generator) / scale}};
+
+            std::vector<std::uint64_t> expected;
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                expected.push_back(segments.BoundingBox(i).GetMinSquaredDist(point));
+            }
+
+            for (const auto implementation : implementations)
+            {
+                if (!leaf_scan::isSupported(implementation))
+                    continue;
+
+                BOOST_TEST_CONTEXT(leaf_scan::toString(implementation) << " " << count)
+                {
+                    std::vector<std::uint64_t> bounds(count);
+                    leaf_scan::computeSquaredLowerBounds(
+                        implementation, segments.Columns(), point, bounds.data());
+                    BOOST_CHECK_EQUAL_COLLECTIONS(
+                        bounds.begin(), bounds.end(), expected.begin(), expected.end());
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lower_bounds_below_segment_distance)
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<std::int32_t> dist(-1200000, 1200000);
+    const RandomSegments segments(85, generator);
+
+    for (int query = 0; query < 100; ++query)
+    {
+        const Coordinate point{FixedLongitude{dist(generator)}, FixedLatitude{dist(generator)}};
+
+        std::vector<std::uint64_t> bounds(85);
+        leaf_scan::computeSquaredLowerBounds(segments.Columns(), point, bounds.data());
+
+        for (std::uint32_t i = 0; i < 85; ++i)
+        {
+            const FloatCoordinate u{Coordinate{segments.u_lons[i], segments.u_lats[i]}};
+            const FloatCoordinate v{Coordinate{segments.v_lons[i], segments.v_lats[i]}};
+            FloatCoordinate nearest;
+            std::tie(std::ignore, nearest) =
+                coordinate_calculation::projectPointOnSegment(u, v, FloatCoordinate{point});
+            BOOST_CHECK_LE(bounds[i],
+                           coordinate_calculation::squaredEuclideanDistance(point, nearest));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
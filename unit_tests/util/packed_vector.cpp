@@ -1,6 +1,8 @@
 #include "util/packed_vector.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -31,6 +33,44 @@ BOOST_AUTO_TEST_CASE(insert_and_retrieve_packed_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(insert_and_iterate_segment_weights_test)
+{
+    PackedVector<SegmentWeight, SEGMENT_WEIGHT_BITS> packed_weights;
+    std::vector<SegmentWeight> original_weights;
+
+    const constexpr std::size_t num_test_cases = 399;
+
+    for (std::size_t i = 0; i < num_test_cases; i++)
+    {
+        const SegmentWeight weight = i % 7 == 0 ? INVALID_SEGMENT_WEIGHT : rand() % (1u << 20);
+
+        packed_weights.push_back(weight);
+        original_weights.push_back(weight);
+    }
+
+    using PackedWeights = PackedVector<SegmentWeight, SEGMENT_WEIGHT_BITS>;
+    BOOST_CHECK_EQUAL(packed_weights.size(), num_test_cases);
+    BOOST_CHECK_EQUAL(PackedWeights::elements_to_blocks(num_test_cases), 125);
+    for (std::size_t i = 0; i < num_test_cases; i++)
+    {
+        BOOST_CHECK_EQUAL(original_weights.at(i), packed_weights.at(i));
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(packed_weights.begin(),
+                                  packed_weights.end(),
+                                  original_weights.begin(),
+                                  original_weights.end());
+
+    // ranges over a slice of the packed vector can be reversed like the unpacked ones
+    const auto range = boost::make_iterator_range(packed_weights.cbegin() + 10,
+                                                  packed_weights.cbegin() + 20);
+    const auto reversed = boost::adaptors::reverse(range);
+    std::vector<SegmentWeight> reversed_weights(reversed.begin(), reversed.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(reversed_weights.rbegin(),
+                                  reversed_weights.rend(),
+                                  original_weights.begin() + 10,
+                                  original_weights.begin() + 20);
+}
+
 BOOST_AUTO_TEST_CASE(packed_vector_capacity_test)
 {
     PackedVector<OSMNodeID, 33> packed_vec;
@@ -0,0 +1,131 @@
+#include "util/relax_kernels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(relax_kernels_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::vector<EdgeWeight> makeWeights(std::size_t size, double invalid_ratio)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(0, 1 << 20);
+    std::bernoulli_distribution invalid_distribution(invalid_ratio);
+
+    std::vector<EdgeWeight> weights(size);
+    for (auto &weight : weights)
+    {
+        weight = invalid_distribution(generator) ? INVALID_EDGE_WEIGHT
+                                                 : weight_distribution(generator);
+    }
+    return weights;
+}
+
+void checkKernel(simd::FilterValidWeightsFn kernel)
+{
+    const auto weights = makeWeights(37 * 41, 0.3);
+    const EdgeWeight base = 1000;
+
+    for (const std::size_t stride : {1, 37})
+    {
+        for (const std::size_t count : {0, 1, 3, 4, 7, 8, 9, 16, 31, 37})
+        {
+            std::vector<EdgeWeight> expected_candidates(count), candidates(count);
+            std::vector<std::uint32_t> expected_indices(count), indices(count);
+
+            const auto expected_num_valid =
+                simd::detail::filterValidWeightsScalar(weights.data(),
+                                                       count,
+                                                       stride,
+                                                       base,
+                                                       expected_candidates.data(),
+                                                       expected_indices.data());
+            const auto num_valid =
+                kernel(weights.data(), count, stride, base, candidates.data(), indices.data());
+
+            BOOST_REQUIRE_EQUAL(num_valid, expected_num_valid);
+            expected_candidates.resize(expected_num_valid);
+            candidates.resize(num_valid);
+            expected_indices.resize(expected_num_valid);
+            indices.resize(num_valid);
+            BOOST_CHECK_EQUAL_COLLECTIONS(candidates.begin(),
+                                          candidates.end(),
+                                          expected_candidates.begin(),
+                                          expected_candidates.end());
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                indices.begin(), indices.end(), expected_indices.begin(), expected_indices.end());
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(scalar_filter_test)
+{
+    const std::vector<EdgeWeight> weights = {1, INVALID_EDGE_WEIGHT, 3, INVALID_EDGE_WEIGHT, 5};
+    std::vector<EdgeWeight> candidates(weights.size());
+    std::vector<std::uint32_t> indices(weights.size());
+
+    const auto num_valid = simd::detail::filterValidWeightsScalar(
+        weights.data(), weights.size(), 1, 10, candidates.data(), indices.data());
+    BOOST_CHECK_EQUAL(num_valid, 3);
+    BOOST_CHECK_EQUAL(candidates[0], 11);
+    BOOST_CHECK_EQUAL(candidates[1], 13);
+    BOOST_CHECK_EQUAL(candidates[2], 15);
+    BOOST_CHECK_EQUAL(indices[0], 0);
+    BOOST_CHECK_EQUAL(indices[1], 2);
+    BOOST_CHECK_EQUAL(indices[2], 4);
+
+    // every second element of the column
+    const auto num_valid_column = simd::detail::filterValidWeightsScalar(
+        weights.data(), 3, 2, 10, candidates.data(), indices.data());
+    BOOST_CHECK_EQUAL(num_valid_column, 3);
+    BOOST_CHECK_EQUAL(indices[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(sse2_filter_test)
+{
+    if (auto kernel = simd::detail::getFilterValidWeightsSSE2())
+        checkKernel(kernel);
+}
+
+BOOST_AUTO_TEST_CASE(avx2_filter_test)
+{
+    if (auto kernel = simd::detail::getFilterValidWeightsAVX2())
+        checkKernel(kernel);
+}
+
+BOOST_AUTO_TEST_CASE(dispatched_filter_test) { checkKernel(&simd::filterValidWeights); }
+
+BOOST_AUTO_TEST_CASE(relax_weights_test)
+{
+    const auto weights = makeWeights(300, 0.5);
+
+    std::vector<std::size_t> indices;
+    std::vector<EdgeWeight> candidates;
+    simd::relaxWeights(weights.data(), weights.size(), 1, 7, [&](auto index, auto to_weight) {
+        indices.push_back(index);
+        candidates.push_back(to_weight);
+    });
+
+    std::size_t position = 0;
+    for (std::size_t index = 0; index < weights.size(); ++index)
+    {
+        if (weights[index] == INVALID_EDGE_WEIGHT)
+            continue;
+
+        BOOST_REQUIRE_LT(position, indices.size());
+        BOOST_CHECK_EQUAL(indices[position], index);
+        BOOST_CHECK_EQUAL(candidates[position], weights[index] + 7);
+        ++position;
+    }
+    BOOST_CHECK_EQUAL(position, indices.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#include "util/snapping_grid.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(snapping_grid_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+RectangleInt2D makeRectangle(const std::int32_t min_x,
+                             const std::int32_t max_x,
+                             const std::int32_t min_y,
+                             const std::int32_t max_y)
+{
+    return {
+        FixedLongitude{min_x}, FixedLongitude{max_x}, FixedLatitude{min_y}, FixedLatitude{max_y}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(empty_grid)
+{
+    const SnappingGrid grid({makeRectangle(0, 10, 0, 10)}, 0);
+    BOOST_CHECK(grid.Empty());
+    // the leaf count is kept to match the grid file with the rtree, even if it is disabled
+    BOOST_CHECK_EQUAL(grid.GetNumberOfLeaves(), 1);
+
+    std::vector<std::uint32_t> candidates;
+    BOOST_CHECK_EQUAL(grid.GetCandidateLeaves(Coordinate{FixedLongitude{5}, FixedLatitude{5}},
+                                              candidates),
+                      0);
+    BOOST_CHECK(candidates.empty());
+}
+
+BOOST_AUTO_TEST_CASE(candidates_contain_all_close_leaves)
+{
+    constexpr std::int32_t CELL_SIZE = 1000;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> position_dist(-20000, 20000);
+    std::uniform_int_distribution<std::int32_t> extent_dist(0, 2500);
+
+    // dense enough that every cell of the area is covered
+    std::vector<RectangleInt2D> rectangles;
+    for (int i = 0; i < 4000; ++i)
+    {
+        const auto x = position_dist(generator);
+        const auto y = position_dist(generator);
+        rectangles.push_back(
+            makeRectangle(x, x + extent_dist(generator), y, y + extent_dist(generator)));
+    }
+    const SnappingGrid grid(rectangles, CELL_SIZE);
+    BOOST_CHECK(!grid.Empty());
+    BOOST_CHECK_EQUAL(grid.GetNumberOfLeaves(), rectangles.size());
+
+    std::uniform_int_distribution<std::int32_t> query_dist(-15000, 15000);
+    std::vector<std::uint32_t> candidates;
+    int num_found = 0;
+    for (int query = 0; query < 500; ++query)
+    {
+        const Coordinate point{FixedLongitude{query_dist(generator)},
+                               FixedLatitude{query_dist(generator)}};
+        const auto squared_radius = grid.GetCandidateLeaves(point, candidates);
+        if (squared_radius == 0)
+            continue;
+        ++num_found;
+
+        BOOST_CHECK_GE(squared_radius, static_cast<std::uint64_t>(CELL_SIZE) * CELL_SIZE);
+        BOOST_CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+
+        // every leaf within the radius has to be a candidate
+        for (const auto leaf_id : irange<std::uint32_t>(0, rectangles.size()))
+        {
+            if (rectangles[leaf_id].GetMinSquaredDist(point) < squared_radius)
+            {
+                BOOST_CHECK(
+                    std::binary_search(candidates.begin(), candidates.end(), leaf_id));
+            }
+        }
+    }
+    BOOST_CHECK_GT(num_found, 0);
+}
+
+BOOST_AUTO_TEST_CASE(large_leaves_are_not_indexed)
+{
+    constexpr std::int32_t CELL_SIZE = 1000;
+    std::vector<RectangleInt2D> rectangles;
+    for (std::int32_t x = -10; x < 10; ++x)
+    {
+        for (std::int32_t y = -10; y < 10; ++y)
+        {
+            rectangles.push_back(makeRectangle(x * CELL_SIZE + 1,
+                                               (x + 1) * CELL_SIZE - 1,
+                                               y * CELL_SIZE + 1,
+                                               (y + 1) * CELL_SIZE - 1));
+        }
+    }
+    // covers 20x4 cells, so the cells around it need to use the tree
+    rectangles.push_back(makeRectangle(-10 * CELL_SIZE, 10 * CELL_SIZE - 1, 0, 4 * CELL_SIZE - 1));
+    const SnappingGrid grid(rectangles, CELL_SIZE);
+
+    std::vector<std::uint32_t> candidates;
+    BOOST_CHECK_EQUAL(grid.GetCandidateLeaves(
+                          Coordinate{FixedLongitude{500}, FixedLatitude{2500}}, candidates),
+                      0);
+    BOOST_CHECK_GT(grid.GetCandidateLeaves(
+                       Coordinate{FixedLongitude{500}, FixedLatitude{-5500}}, candidates),
+                   0);
+    BOOST_CHECK_EQUAL(candidates.size(), 9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
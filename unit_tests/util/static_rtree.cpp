@@ -1,10 +1,12 @@
 #include "util/static_rtree.hpp"
 #include "extractor/edge_based_node.hpp"
 #include "engine/geospatial_query.hpp"
+#include "storage/io.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
 #include "util/rectangle.hpp"
+#include "util/snapping_grid.hpp"
 #include "util/typedefs.hpp"
 
 #include "mocks/mock_datafacade.hpp"
@@ -18,6 +20,8 @@
 #include <cstdint>
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <random>
 #include <string>
@@ -25,6 +29,7 @@
 #include <utility>
 #include <vector>
 
+#include <tbb/task_arena.h>
 #include <tbb/task_scheduler_init.h>
 
 // explicit TBB scheduler init to register resources cleanup at exit
@@ -45,6 +50,16 @@ using TestStaticRTree = StaticRTree<TestData,
                                     TEST_BRANCHING_FACTOR,
                                     TEST_LEAF_NODE_SIZE>;
 using MiniStaticRTree = StaticRTree<TestData, osrm::storage::Ownership::Container, 2, 128>;
+using TestCoordinatesStaticRTree = StaticRTree<TestData,
+                                               osrm::storage::Ownership::Container,
+                                               TEST_BRANCHING_FACTOR,
+                                               4 * TEST_LEAF_NODE_SIZE,
+                                               LeafLayout::ObjectsAndCoordinates>;
+using MiniCoordinatesStaticRTree = StaticRTree<TestData,
+                                               osrm::storage::Ownership::Container,
+                                               2,
+                                               128,
+                                               LeafLayout::ObjectsAndCoordinates>;
 using TestDataFacade = MockDataFacade<osrm::engine::routing_algorithms::ch::Algorithm>;
 
 // Choosen by a fair W20 dice roll (this value is completely arbitrary)
@@ -180,6 +195,24 @@ struct GraphFixture
     std::vector<TestData> edges;
 };
 
+// A random polyline of num_coordinates coordinates within [-10, 10] degrees, small enough
+// for a tree with many levels
+GraphFixture make_random_polyline_fixture(std::mt19937 &g, const unsigned num_coordinates)
+{
+    std::uniform_real_distribution<> lat_udist(-10., 10.);
+    std::uniform_real_distribution<> lon_udist(-10., 10.);
+
+    std::vector<std::pair<FloatLongitude, FloatLatitude>> input_coords;
+    std::vector<std::pair<unsigned, unsigned>> input_edges;
+    for (unsigned i = 0; i < num_coordinates; ++i)
+    {
+        input_coords.emplace_back(FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)});
+        if (i > 0)
+            input_edges.emplace_back(i - 1, i);
+    }
+    return GraphFixture(input_coords, input_edges);
+}
+
 typedef RandomGraphFixture<TEST_LEAF_NODE_SIZE * 3, TEST_LEAF_NODE_SIZE / 2>
     TestRandomGraphFixture_LeafHalfFull;
 typedef RandomGraphFixture<TEST_LEAF_NODE_SIZE * 5, TEST_LEAF_NODE_SIZE>
@@ -302,6 +335,124 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(construct_leaf_coordinates_test, TestRandomGraphFixture_MultipleLevels)
+{
+    construction_test<TestCoordinatesStaticRTree>("test_6", this);
+}
+
+// The leaves and levels are built in parallel, the files may not depend on the scheduling
+BOOST_FIXTURE_TEST_CASE(construction_is_deterministic_test, TestRandomGraphFixture_MultipleLevels)
+{
+    const auto read_file = [](const std::string &path) {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream),
+                                 std::istreambuf_iterator<char>());
+    };
+
+    std::string serial_leaves_path;
+    std::string serial_nodes_path;
+    tbb::task_arena(1).execute([&] {
+        build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+            "test_serial", this, serial_leaves_path, serial_nodes_path);
+    });
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_parallel", this, leaves_path, nodes_path);
+
+    // more leaves than are built in one batch
+    const auto leaves = read_file(leaves_path);
+    BOOST_CHECK_GT(leaves.size() / TestStaticRTree::LeafNode::CAPACITY,
+                   TestStaticRTree::LEAF_BATCH_NODES * TEST_BRANCHING_FACTOR);
+
+    const auto serial_leaves = read_file(serial_leaves_path);
+    BOOST_CHECK(leaves == serial_leaves);
+    const auto nodes = read_file(nodes_path);
+    const auto serial_nodes = read_file(serial_nodes_path);
+    BOOST_CHECK(nodes == serial_nodes);
+}
+
+BOOST_FIXTURE_TEST_CASE(leaves_in_memory_test, TestRandomGraphFixture_MultipleLevels)
+{
+    using MemoryStaticRTree = StaticRTree<TestData,
+                                          osrm::storage::Ownership::View,
+                                          TEST_BRANCHING_FACTOR,
+                                          4 * TEST_LEAF_NODE_SIZE,
+                                          LeafLayout::ObjectsAndCoordinates>;
+    using LeafNode = MemoryStaticRTree::LeafNode;
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestCoordinatesStaticRTree>(
+        "test_memory", this, leaves_path, nodes_path);
+    TestCoordinatesStaticRTree mapped_rtree(nodes_path, leaves_path, coords);
+
+    // load the files like osrm-datastore does with --load-rtree-leaves
+    storage::io::FileReader tree_node_file(nodes_path, storage::io::FileReader::VerifyFingerprint);
+    const auto header = MemoryStaticRTree::ReadFileHeader(tree_node_file, nodes_path);
+    std::vector<MemoryStaticRTree::TreeNode> nodes(tree_node_file.ReadElementCount64());
+    tree_node_file.ReadInto(nodes);
+
+    storage::io::FileReader leaf_node_file(leaves_path, storage::io::FileReader::HasNoFingerprint);
+    MemoryStaticRTree::CheckLeafFileSize(header, leaf_node_file.GetSize(), leaves_path);
+    const auto num_leaves = header.number_of_leaves;
+    std::vector<char> memory((num_leaves + 1) * sizeof(LeafNode));
+    const auto address = reinterpret_cast<std::uintptr_t>(memory.data());
+    const auto leaves = reinterpret_cast<LeafNode *>((address + alignof(LeafNode) - 1) &
+                                                     ~(std::uintptr_t{alignof(LeafNode)} - 1));
+    leaf_node_file.ReadInto(leaves, num_leaves);
+
+    vector_view<Coordinate> coords_view(coords.data(), coords.size());
+    MemoryStaticRTree memory_rtree(nodes.data(), nodes.size(), leaves, num_leaves, coords_view);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        const Coordinate q{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+        const auto expected = mapped_rtree.Nearest(q, 5);
+        const auto results = memory_rtree.Nearest(q, 5);
+        BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+        for (const auto j : irange<std::size_t>(0, results.size()))
+        {
+            BOOST_CHECK_EQUAL(results[j].u, expected[j].u);
+            BOOST_CHECK_EQUAL(results[j].v, expected[j].v);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(incompatible_files_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_incompatible", this, leaves_path, nodes_path);
+
+    // leaves of another layout
+    BOOST_CHECK_THROW(TestCoordinatesStaticRTree(nodes_path, leaves_path, coords),
+                      util::exception);
+
+    // leaves of other tree nodes
+    const std::string other_leaves_path = "test_incompatible_other.fileIndex";
+    {
+        storage::io::FileWriter leaf_node_file(other_leaves_path,
+                                               storage::io::FileWriter::HasNoFingerprint);
+        leaf_node_file.WriteOne(TestStaticRTree::LeafNode{});
+    }
+    BOOST_CHECK_THROW(TestStaticRTree(nodes_path, other_leaves_path, coords), util::exception);
+
+    // tree nodes written before the file header was introduced
+    {
+        storage::io::FileWriter tree_node_file(nodes_path,
+                                               storage::io::FileWriter::GenerateFingerprint);
+        tree_node_file.WriteElementCount64(1);
+        tree_node_file.WriteOne(TestStaticRTree::TreeNode{});
+    }
+    BOOST_CHECK_THROW(TestStaticRTree(nodes_path, leaves_path, coords), util::exception);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -440,7 +591,299 @@ BOOST_AUTO_TEST_CASE(bearing_tests)
     }
 }
 
-BOOST_AUTO_TEST_CASE(bbox_search_tests)
+BOOST_AUTO_TEST_CASE(batch_nearest_tests)
+{
+    std::mt19937 g(RANDOM_SEED);
+    auto fixture = make_random_polyline_fixture(g, 300);
+
+    std::uniform_real_distribution<> lat_udist(-10., 10.);
+    std::uniform_real_distribution<> lon_udist(-10., 10.);
+    std::uniform_int_distribution<> bearing_udist(0, 359);
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniStaticRTree>("test_batch", &fixture, leaves_path, nodes_path);
+    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<MiniStaticRTree, TestDataFacade> query(
+        rtree, fixture.coords, mockfacade);
+
+    // large enough to be split over several threads, every fourth query is restricted
+    std::vector<engine::PhantomNodeQuery> queries;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        engine::PhantomNodeQuery batch_query{
+            Coordinate{FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)}}, {}, {}};
+        if (i % 4 == 1)
+            batch_query.max_distance = 100000.;
+        if (i % 4 == 2)
+            batch_query.bearing =
+                engine::Bearing{static_cast<short>(bearing_udist(g)), static_cast<short>(90)};
+        queries.push_back(batch_query);
+    }
+
+    const auto check_equal = [](const engine::PhantomNode &lhs, const engine::PhantomNode &rhs) {
+        BOOST_CHECK_EQUAL(lhs.forward_segment_id.id, rhs.forward_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs.reverse_segment_id.id, rhs.reverse_segment_id.id);
+        BOOST_CHECK_EQUAL(lhs.location, rhs.location);
+    };
+
+    const auto nearest = query.NearestPhantomNodes(queries, 3);
+    const auto pairs = query.NearestPhantomNodeWithAlternativeFromBigComponent(queries);
+    BOOST_REQUIRE_EQUAL(nearest.size(), queries.size());
+    BOOST_REQUIRE_EQUAL(pairs.size(), queries.size());
+
+    for (const auto i : irange<std::size_t>(0, queries.size()))
+    {
+        const auto &input = queries[i].input_coordinate;
+        const auto &bearing = queries[i].bearing;
+        const auto &max_distance = queries[i].max_distance;
+
+        auto single = query.NearestPhantomNodes(input, 3);
+        if (bearing)
+            single = query.NearestPhantomNodes(input, 3, bearing->bearing, bearing->range);
+        else if (max_distance)
+            single = query.NearestPhantomNodes(input, 3, *max_distance);
+        BOOST_REQUIRE_EQUAL(nearest[i].size(), single.size());
+        for (const auto j : irange<std::size_t>(0, single.size()))
+        {
+            check_equal(nearest[i][j].phantom_node, single[j].phantom_node);
+            BOOST_CHECK_EQUAL(nearest[i][j].distance, single[j].distance);
+        }
+
+        auto single_pair = query.NearestPhantomNodeWithAlternativeFromBigComponent(input);
+        if (bearing)
+            single_pair = query.NearestPhantomNodeWithAlternativeFromBigComponent(
+                input, bearing->bearing, bearing->range);
+        else if (max_distance)
+            single_pair =
+                query.NearestPhantomNodeWithAlternativeFromBigComponent(input, *max_distance);
+        check_equal(pairs[i].first, single_pair.first);
+        check_equal(pairs[i].second, single_pair.second);
+    }
+}
+
+template <typename RTreeT> void test_bounded_nearest(const std::string &prefix)
+{
+    using CandidateSegment = typename RTreeT::CandidateSegment;
+
+    std::mt19937 g(RANDOM_SEED);
+    auto fixture = make_random_polyline_fixture(g, 300);
+
+    std::uniform_real_distribution<> lat_udist(-10., 10.);
+    std::uniform_real_distribution<> lon_udist(-10., 10.);
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, RTreeT>(prefix, &fixture, leaves_path, nodes_path);
+    RTreeT rtree(nodes_path, leaves_path, fixture.coords);
+
+    // rejects every third segment and disables the reverse direction of every other one
+    const auto filter = [](const CandidateSegment &segment) {
+        return std::make_pair(segment.data.u % 3 != 0, segment.data.u % 3 == 1);
+    };
+
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        const Coordinate input{FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)}};
+        const auto distance = [&](const TestData &segment) {
+            return coordinate_calculation::perpendicularDistance(
+                fixture.coords[segment.u], fixture.coords[segment.v], input);
+        };
+        for (const std::size_t max_results : {1, 5, 40, 500})
+        {
+            const auto expected = rtree.Nearest(
+                input,
+                filter,
+                [max_results](const std::size_t num_results, const CandidateSegment &) {
+                    return num_results >= max_results;
+                });
+
+            std::vector<TestData> results(max_results);
+            const auto end = rtree.Nearest(input, max_results, filter, results.data());
+            results.resize(end - results.data());
+
+            // adjacent segments can have the same distance, their order is not defined
+            BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+            for (const auto j : irange<std::size_t>(0, results.size()))
+            {
+                BOOST_CHECK_CLOSE(distance(results[j]), distance(expected[j]), 0.0001);
+                if (results[j].u != expected[j].u)
+                    continue;
+                BOOST_CHECK_EQUAL(results[j].forward_segment_id.enabled,
+                                  expected[j].forward_segment_id.enabled);
+                BOOST_CHECK_EQUAL(results[j].reverse_segment_id.enabled,
+                                  expected[j].reverse_segment_id.enabled);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bounded_nearest_tests)
+{
+    test_bounded_nearest<MiniStaticRTree>("test_bounded");
+}
+
+BOOST_AUTO_TEST_CASE(bounded_nearest_leaf_coordinates_tests)
+{
+    test_bounded_nearest<MiniCoordinatesStaticRTree>("test_bounded_coordinates");
+}
+
+template <typename RTreeT> void test_bearing_pruning(const std::string &prefix)
+{
+    using CandidateSegment = typename RTreeT::CandidateSegment;
+
+    std::mt19937 g(RANDOM_SEED);
+    auto fixture = make_random_polyline_fixture(g, 300);
+
+    std::uniform_real_distribution<> lat_udist(-10., 10.);
+    std::uniform_real_distribution<> lon_udist(-10., 10.);
+    std::uniform_int_distribution<> bearing_udist(0, 359);
+    std::uniform_int_distribution<> range_udist(0, 90);
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, RTreeT>(prefix, &fixture, leaves_path, nodes_path);
+    RTreeT rtree(nodes_path, leaves_path, fixture.coords);
+
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<RTreeT, TestDataFacade> query(rtree, fixture.coords, mockfacade);
+
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        const Coordinate input{FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)}};
+        const auto bearing = bearing_udist(g);
+        const auto range = range_udist(g);
+        const auto filter = [&](const CandidateSegment &segment) {
+            const auto forward_bearing = coordinate_calculation::bearing(
+                fixture.coords[segment.data.u], fixture.coords[segment.data.v]);
+            const auto backward_bearing = bearing::reverse(forward_bearing);
+            return std::make_pair(
+                bearing::CheckInBounds(std::round(forward_bearing), bearing, range),
+                bearing::CheckInBounds(std::round(backward_bearing), bearing, range));
+        };
+        const auto distance = [&](const TestData &segment) {
+            return coordinate_calculation::perpendicularDistance(
+                fixture.coords[segment.u], fixture.coords[segment.v], input);
+        };
+
+        for (const std::size_t max_results : {1, 5, 40})
+        {
+            std::vector<TestData> expected;
+            rtree.Nearest(input, max_results, filter, std::back_inserter(expected));
+            std::vector<TestData> results;
+            rtree.Nearest(input,
+                          max_results,
+                          filter,
+                          std::back_inserter(results),
+                          bearing::toBucketMask(bearing, range));
+
+            BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+            for (const auto j : irange<std::size_t>(0, results.size()))
+            {
+                BOOST_CHECK_CLOSE(distance(results[j]), distance(expected[j]), 0.0001);
+            }
+
+            const auto phantoms = query.NearestPhantomNodes(input, max_results, bearing, range);
+            BOOST_CHECK_EQUAL(phantoms.size(), expected.size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bearing_pruning_tests)
+{
+    test_bearing_pruning<MiniStaticRTree>("test_bearing_pruning");
+}
+
+BOOST_AUTO_TEST_CASE(bearing_pruning_leaf_coordinates_tests)
+{
+    test_bearing_pruning<MiniCoordinatesStaticRTree>("test_bearing_pruning_coordinates");
+}
+
+BOOST_AUTO_TEST_CASE(snapping_grid_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_real_distribution<> step_udist(-0.0005, 0.0005);
+    std::uniform_int_distribution<> bearing_udist(0, 359);
+
+    // a random walk with short segments, like the roads of a city
+    std::vector<Coord> input_coords;
+    std::vector<Edge> input_edges;
+    double lon = 0;
+    double lat = 0;
+    for (unsigned i = 0; i < 2000; ++i)
+    {
+        lon += step_udist(g);
+        lat += step_udist(g);
+        input_coords.emplace_back(FloatLongitude{lon}, FloatLatitude{lat});
+        if (i > 0)
+            input_edges.emplace_back(i - 1, i);
+    }
+    GraphFixture fixture(input_coords, input_edges);
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniCoordinatesStaticRTree>(
+        "test_grid", &fixture, leaves_path, nodes_path);
+    MiniCoordinatesStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    const SnappingGrid grid(rtree.GetLeafRectangles(), 2000);
+    BOOST_REQUIRE(!grid.Empty());
+
+    TestDataFacade mockfacade;
+    engine::GeospatialQuery<MiniCoordinatesStaticRTree, TestDataFacade, SnappingGrid> tree_query(
+        rtree, fixture.coords, mockfacade);
+    engine::GeospatialQuery<MiniCoordinatesStaticRTree, TestDataFacade, SnappingGrid> grid_query(
+        rtree, fixture.coords, mockfacade, &grid);
+
+    std::vector<std::uint32_t> leaf_ids;
+    std::size_t num_from_grid = 0;
+    for (unsigned i = 0; i < 500; ++i)
+    {
+        // close to the walk, but not on it
+        const auto &near = input_coords[i * input_coords.size() / 500];
+        const Coordinate input{FloatLongitude{static_cast<double>(near.first) + step_udist(g)},
+                               FloatLatitude{static_cast<double>(near.second) + step_udist(g)}};
+
+        const auto squared_radius =
+            grid.GetCandidateLeaves(Coordinate{web_mercator::fromWGS84(input)}, leaf_ids);
+        std::vector<TestData> results;
+        if (squared_radius > 0 &&
+            rtree.NearestInLeaves(input,
+                                  3,
+                                  [](const MiniCoordinatesStaticRTree::CandidateSegment &) {
+                                      return std::make_pair(true, true);
+                                  },
+                                  leaf_ids.begin(),
+                                  leaf_ids.end(),
+                                  squared_radius,
+                                  std::back_inserter(results)))
+        {
+            ++num_from_grid;
+        }
+
+        const auto bearing = bearing_udist(g);
+        for (const auto use_bearing : {false, true})
+        {
+            const auto expected = use_bearing
+                                      ? tree_query.NearestPhantomNodes(input, 3, bearing, 45)
+                                      : tree_query.NearestPhantomNodes(input, 3);
+            const auto snapped = use_bearing
+                                     ? grid_query.NearestPhantomNodes(input, 3, bearing, 45)
+                                     : grid_query.NearestPhantomNodes(input, 3);
+            BOOST_REQUIRE_EQUAL(snapped.size(), expected.size());
+            for (const auto j : irange<std::size_t>(0, snapped.size()))
+            {
+                BOOST_CHECK_CLOSE(snapped[j].distance, expected[j].distance, 0.0001);
+            }
+        }
+    }
+    BOOST_CHECK_GT(num_from_grid, 0);
+}
+
+template <typename RTreeT> void test_bbox_search(const std::string &prefix)
 {
     using Coord = std::pair<FloatLongitude, FloatLatitude>;
     using Edge = std::pair<unsigned, unsigned>;
@@ -457,11 +900,10 @@ BOOST_AUTO_TEST_CASE(bbox_search_tests)
 
     std::string leaves_path;
     std::string nodes_path;
-    build_rtree<GraphFixture, MiniStaticRTree>("test_bbox", &fixture, leaves_path, nodes_path);
-    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    build_rtree<GraphFixture, RTreeT>(prefix, &fixture, leaves_path, nodes_path);
+    RTreeT rtree(nodes_path, leaves_path, fixture.coords);
     TestDataFacade mockfacade;
-    engine::GeospatialQuery<MiniStaticRTree, TestDataFacade> query(
-        rtree, fixture.coords, mockfacade);
+    engine::GeospatialQuery<RTreeT, TestDataFacade> query(rtree, fixture.coords, mockfacade);
 
     {
         RectangleInt2D bbox = {
@@ -476,6 +918,45 @@ BOOST_AUTO_TEST_CASE(bbox_search_tests)
         auto results = query.Search(bbox);
         BOOST_CHECK_EQUAL(results.size(), 3);
     }
+
+    {
+        // boxes inside the first one can be answered from its result
+        RectangleInt2D bbox = {
+            FloatLongitude{0.0}, FloatLongitude{4.0}, FloatLatitude{0.0}, FloatLatitude{4.0}};
+        const auto candidates = query.Search(bbox);
+        BOOST_CHECK_EQUAL(candidates.size(), 4);
+
+        for (const auto min : {0.2, 0.5, 1.0, 1.5, 2.5})
+        {
+            for (const auto max : {1.0, 1.7, 3.5})
+            {
+                if (min >= max)
+                    continue;
+
+                RectangleInt2D sub_bbox = {FloatLongitude{min},
+                                           FloatLongitude{max},
+                                           FloatLatitude{min},
+                                           FloatLatitude{max}};
+                const auto expected = query.Search(sub_bbox);
+                const auto filtered = query.Search(sub_bbox, candidates);
+                BOOST_CHECK_EQUAL(filtered.size(), expected.size());
+                for (const auto &edge : expected)
+                {
+                    BOOST_CHECK(std::any_of(
+                        filtered.begin(), filtered.end(), [&edge](const TestData &other) {
+                            return edge.u == other.u && edge.v == other.v;
+                        }));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bbox_search_tests) { test_bbox_search<MiniStaticRTree>("test_bbox"); }
+
+BOOST_AUTO_TEST_CASE(bbox_search_leaf_coordinates_tests)
+{
+    test_bbox_search<MiniCoordinatesStaticRTree>("test_bbox_coordinates");
 }
 
 BOOST_AUTO_TEST_SUITE_END()